@@ -1,164 +1,162 @@
-#include "Camera.h"
-Camera::Camera()
-{
-	F = XMVectorSet(0.0f, 0.0f, 1.f, 0.0f);
-	xRot = 0.f;
-	yRot = 0.f;
-}
-void Camera::Update(float deltaTime)
-{
-	XMVECTOR UP = XMVectorSet(0.f, 1.f, 0.f, 0.f);
-	XMVECTOR L = XMQuaternionRotationRollPitchYaw(xRot, yRot, 0.0f);
-	XMVECTOR P = L * F;
-	if (xRot != 0.f && yRot != 0.f)
-	{
-		direction = P;		
-	}
-	else
-	{
-		direction = XMVectorSet(0.f, 0.f, 1.f, 0.f);
-	}
-	
-	UP = XMVector3Cross(XMVector3Cross(F, UP), F);
-	XMMATRIX V = XMMatrixLookToLH(
-		position,     // The position of the "camera"
-		direction,     // Direction the camera is looking
-		UP);     // "Up" direction in 3D space (prevents roll)
-	XMStoreFloat4x4(&view, XMMatrixTranspose(V)); // Transpose for HLSL!
-	F = XMVectorSet(sin(yRot) * cos(xRot), sin(-xRot), cos(xRot) * cos(yRot), 0.f);
-	if (GetAsyncKeyState('W') & 0x8000) 
-	{
-		XMVECTOR Z = XMVectorSet(0.f, 0.f, 1.0f * deltaTime, 0.f);
-		XMFLOAT3 ZDir;
-		XMStoreFloat3(&ZDir, direction);
-		if (ZDir.z == 0.f)
-		{
-			
-			//XMFLOAT3 z = XMFLOAT3(0.f, 0.f, 0.2f);
-			//XMFLOAT3 dir;
-			//XMStoreFloat3(&dir, direction);
-			//dir *= z;
-			position += Z;
-		}
-		else
-		{
-			position += Z * direction;
-		}
-	}
-	if (GetAsyncKeyState('A') & 0x8000)
-	{
-		XMVECTOR X = XMVectorSet(-1.0f * deltaTime, 0.f, 0.f, 0.f);
-		XMFLOAT3 XDir;
-		XMStoreFloat3(&XDir, direction);
-		if (XDir.x == 0.f)
-		{
-
-			//XMFLOAT3 z = XMFLOAT3(0.f, 0.f, 0.2f);
-			//XMFLOAT3 dir;
-			//XMStoreFloat3(&dir, direction);
-			//dir *= z;
-			position += X;
-		}
-		else
-		{
-			position += X * direction;
-		}
-	}
-	if (GetAsyncKeyState('S') & 0x8000)
-	{
-		XMVECTOR Z = XMVectorSet(0.f, 0.f, -1.0f * deltaTime, 0.f);
-		XMFLOAT3 ZDir;
-		XMStoreFloat3(&ZDir, direction);
-		if (ZDir.z == 0.f)
-		{
-
-			//XMFLOAT3 z = XMFLOAT3(0.f, 0.f, 0.2f);
-			//XMFLOAT3 dir;
-			//XMStoreFloat3(&dir, direction);
-			//dir *= z;
-			position += Z;
-		}
-		else
-		{
-			position += Z * direction;
-		}
-	}
-	if (GetAsyncKeyState('D') & 0x8000)
-	{
-		XMVECTOR X = XMVectorSet(1.0f * deltaTime, 0.f, 0.f, 0.f);
-		XMFLOAT3 XDir;
-		XMStoreFloat3(&XDir, direction);
-		if (XDir.x == 0.f)
-		{
-
-			//XMFLOAT3 z = XMFLOAT3(0.f, 0.f, 0.2f);
-			//XMFLOAT3 dir;
-			//XMStoreFloat3(&dir, direction);
-			//dir *= z;
-			position += X;
-		}
-		else
-		{
-			position += X * direction;
-		}
-	}
-	if (GetAsyncKeyState('X') & 0x8000)
-	{
-		XMFLOAT3 pos;
-		XMStoreFloat3(&pos, position);
-		pos.y -= 1.0f * deltaTime;
-		position = XMLoadFloat3(&pos);
-	}
-	if (GetAsyncKeyState(VK_SPACE) & 0x8000)
-	{
-		XMFLOAT3 pos;
-		XMStoreFloat3(&pos, position);
-		pos.y += 1.0f * deltaTime;
-		position = XMLoadFloat3(&pos);
-	}
-}
-XMFLOAT4X4 Camera::GetView()
-{
-	return view;
-}
-
-void Camera::SetView(XMMATRIX v)
-{
-	XMStoreFloat4x4(&view, XMMatrixTranspose(v));
-}
-
-void Camera::RotateCam(int xRotate, int yRotate)
-{
-	xRot += (float)(yRotate) / 25.f;
-	yRot += (float)(xRotate) / 25.f;
-	if (xRot > 30.f)
-	{
-		xRot = 30.f;
-	}
-	else if (xRot < -30.f)
-	{
-		xRot = -30.f;
-	}
-	if (yRot > 30.f)
-	{
-		yRot = 30.f;
-	}
-	else if (yRot < -30.f)
-	{
-		yRot = -30.f;
-	}
-}
-
-void Camera::SetProj(float width, float height)
-{
-	XMMATRIX P = XMMatrixPerspectiveFovLH(
-		0.25f * 3.1415926535f,		// Field of View Angle
-		(float)width / height,		// Aspect ratio
-		0.1f,						// Near clip plane distance
-		100.0f);					// Far clip plane distance
-	XMStoreFloat4x4(&projection, XMMatrixTranspose(P)); // Transpose for HLSL!
-}
-XMFLOAT4X4 Camera::GetProj()
-{
-	return projection;
-}
+#include "Camera.h"
+Camera::Camera()
+{
+	rotation = XMFLOAT4(0.f, 0.f, 0.f, 1.f);
+}
+void Camera::Update(float deltaTime)
+{
+	// The rotation turns the camera's own axes into world ones -
+	// no angles, so no trig
+	XMVECTOR R = XMLoadFloat4(&rotation);
+	direction = XMVector3Rotate(XMVectorSet(0.f, 0.f, 1.f, 0.f), R);
+	up = XMVector3Rotate(XMVectorSet(0.f, 1.f, 0.f, 0.f), R);
+
+	XMMATRIX V = XMMatrixLookToLH(
+		position,     // The position of the "camera"
+		direction,     // Direction the camera is looking
+		up);     // "Up" direction in 3D space
+	XMStoreFloat4x4(&view, XMMatrixTranspose(V)); // Transpose for HLSL!
+	if (GetAsyncKeyState('W') & 0x8000) 
+	{
+		XMVECTOR Z = XMVectorSet(0.f, 0.f, 1.0f * deltaTime, 0.f);
+		XMFLOAT3 ZDir;
+		XMStoreFloat3(&ZDir, direction);
+		if (ZDir.z == 0.f)
+		{
+			
+			//XMFLOAT3 z = XMFLOAT3(0.f, 0.f, 0.2f);
+			//XMFLOAT3 dir;
+			//XMStoreFloat3(&dir, direction);
+			//dir *= z;
+			position += Z;
+		}
+		else
+		{
+			position += Z * direction;
+		}
+	}
+	if (GetAsyncKeyState('A') & 0x8000)
+	{
+		XMVECTOR X = XMVectorSet(-1.0f * deltaTime, 0.f, 0.f, 0.f);
+		XMFLOAT3 XDir;
+		XMStoreFloat3(&XDir, direction);
+		if (XDir.x == 0.f)
+		{
+
+			//XMFLOAT3 z = XMFLOAT3(0.f, 0.f, 0.2f);
+			//XMFLOAT3 dir;
+			//XMStoreFloat3(&dir, direction);
+			//dir *= z;
+			position += X;
+		}
+		else
+		{
+			position += X * direction;
+		}
+	}
+	if (GetAsyncKeyState('S') & 0x8000)
+	{
+		XMVECTOR Z = XMVectorSet(0.f, 0.f, -1.0f * deltaTime, 0.f);
+		XMFLOAT3 ZDir;
+		XMStoreFloat3(&ZDir, direction);
+		if (ZDir.z == 0.f)
+		{
+
+			//XMFLOAT3 z = XMFLOAT3(0.f, 0.f, 0.2f);
+			//XMFLOAT3 dir;
+			//XMStoreFloat3(&dir, direction);
+			//dir *= z;
+			position += Z;
+		}
+		else
+		{
+			position += Z * direction;
+		}
+	}
+	if (GetAsyncKeyState('D') & 0x8000)
+	{
+		XMVECTOR X = XMVectorSet(1.0f * deltaTime, 0.f, 0.f, 0.f);
+		XMFLOAT3 XDir;
+		XMStoreFloat3(&XDir, direction);
+		if (XDir.x == 0.f)
+		{
+
+			//XMFLOAT3 z = XMFLOAT3(0.f, 0.f, 0.2f);
+			//XMFLOAT3 dir;
+			//XMStoreFloat3(&dir, direction);
+			//dir *= z;
+			position += X;
+		}
+		else
+		{
+			position += X * direction;
+		}
+	}
+	if (GetAsyncKeyState('X') & 0x8000)
+	{
+		XMFLOAT3 pos;
+		XMStoreFloat3(&pos, position);
+		pos.y -= 1.0f * deltaTime;
+		position = XMLoadFloat3(&pos);
+	}
+	if (GetAsyncKeyState(VK_SPACE) & 0x8000)
+	{
+		XMFLOAT3 pos;
+		XMStoreFloat3(&pos, position);
+		pos.y += 1.0f * deltaTime;
+		position = XMLoadFloat3(&pos);
+	}
+}
+XMFLOAT4X4 Camera::GetView()
+{
+	return view;
+}
+
+void Camera::SetView(XMMATRIX v)
+{
+	XMStoreFloat4x4(&view, XMMatrixTranspose(v));
+}
+
+// --------------------------------------------------------
+// Turns the camera by a mouse movement: side to side turns it
+// about the world's up axis, up and down about its own right
+// axis, so it never rolls.  Pitch stops short of straight up
+// or down, where the two axes would meet.
+// --------------------------------------------------------
+void Camera::RotateCam(int xRotate, int yRotate)
+{
+	float yaw = (float)(xRotate) / 25.f;
+	float pitch = (float)(yRotate) / 25.f;
+
+	// Current pitch, from how far the view direction points down
+	XMVECTOR R = XMLoadFloat4(&rotation);
+	float down = XMVectorGetY(XMVector3Rotate(XMVectorSet(0.f, 0.f, 1.f, 0.f), R));
+	float currentPitch = asinf(max(-1.f, min(1.f, -down)));
+	float maxPitch = XM_PIDIV2 - 0.01f;
+	pitch = max(-maxPitch - currentPitch, min(maxPitch - currentPitch, pitch));
+
+	// Own axes apply first, world axes last
+	R = XMQuaternionMultiply(XMQuaternionRotationAxis(XMVectorSet(1.f, 0.f, 0.f, 0.f), pitch), R);
+	R = XMQuaternionMultiply(R, XMQuaternionRotationAxis(XMVectorSet(0.f, 1.f, 0.f, 0.f), yaw));
+
+	// Rounding slowly shrinks or grows a product of quaternions -
+	// put it back to unit length once it has drifted
+	float lengthSq = XMVectorGetX(XMQuaternionLengthSq(R));
+	if (fabsf(lengthSq - 1.f) > 2e-5f)
+		R = XMQuaternionNormalize(R);
+	XMStoreFloat4(&rotation, R);
+}
+
+void Camera::SetProj(float width, float height)
+{
+	XMMATRIX P = XMMatrixPerspectiveFovLH(
+		0.25f * 3.1415926535f,		// Field of View Angle
+		(float)width / height,		// Aspect ratio
+		0.1f,						// Near clip plane distance
+		100.0f);					// Far clip plane distance
+	XMStoreFloat4x4(&projection, XMMatrixTranspose(P)); // Transpose for HLSL!
+}
+XMFLOAT4X4 Camera::GetProj()
+{
+	return projection;
+}
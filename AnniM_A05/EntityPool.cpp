@@ -0,0 +1,93 @@
+#include "EntityPool.h"
+#include <new>
+
+EntityPool::EntityPool(TransformSystem* transforms)
+{
+	this->transforms = transforms;
+}
+
+EntityPool::~EntityPool()
+{
+	for (size_t i = 0; i < live.size(); i++)
+		GetSlot(live[i])->~GameEntity();
+
+	for (size_t i = 0; i < slabs.size(); i++)
+		::operator delete(slabs[i]);
+}
+
+EntityHandle EntityPool::Create(Mesh* mesh, Material* mat)
+{
+	unsigned int slot;
+	if (!freeSlots.empty())
+	{
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	else
+	{
+		if (generations.size() >= MaxEntities)
+			return NoEntity;
+
+		// Out of free slots - start a new slab if the last is full
+		slot = (unsigned int)generations.size();
+		if ((slot >> SlabBits) >= slabs.size())
+			slabs.push_back(static_cast<GameEntity*>(::operator new(SlabSize * sizeof(GameEntity))));
+		generations.push_back(1);
+		livePositions.push_back(0);
+	}
+
+	new (GetSlot(slot)) GameEntity(mesh, mat, transforms);
+	livePositions[slot] = (unsigned int)live.size();
+	live.push_back(slot);
+	return ((EntityHandle)generations[slot] << SlotBits) | slot;
+}
+
+bool EntityPool::Destroy(EntityHandle handle)
+{
+	unsigned int slot = handle & SlotMask;
+	if (!IsAlive(slot, handle >> SlotBits))
+		return false;
+
+	GetSlot(slot)->~GameEntity();
+
+	// Fill the gap in the live list with its last slot
+	unsigned int position = livePositions[slot];
+	unsigned int last = live.back();
+	live[position] = last;
+	livePositions[last] = position;
+	live.pop_back();
+
+	// A slot that has used up its generations is never handed out
+	// again - otherwise a handle from long ago would match it
+	generations[slot]++;
+	if (generations[slot] <= MaxGeneration)
+		freeSlots.push_back(slot);
+	return true;
+}
+
+bool EntityPool::IsAlive(unsigned int slot, unsigned int generation)
+{
+	if (slot >= generations.size() || generations[slot] != generation)
+		return false;
+
+	// A free slot already holds its next generation, but that
+	// could match a forged handle - check it's really live
+	unsigned int position = livePositions[slot];
+	return position < live.size() && live[position] == slot;
+}
+
+GameEntity* EntityPool::Get(EntityHandle handle)
+{
+	unsigned int slot = handle & SlotMask;
+	return IsAlive(slot, handle >> SlotBits) ? GetSlot(slot) : 0;
+}
+
+bool EntityPool::IsAlive(EntityHandle handle)
+{
+	return IsAlive(handle & SlotMask, handle >> SlotBits);
+}
+
+size_t EntityPool::GetCount()
+{
+	return live.size();
+}
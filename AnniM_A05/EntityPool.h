@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+#include "GameEntity.h"
+#include "TransformSystem.h"
+
+// --------------------------------------------------------
+// Refers to an entity in an EntityPool: the low 20 bits are
+// its slot, the high 12 the slot's generation when it was
+// created.  Destroying an entity moves its slot on to the next
+// generation, so old handles to it stop working instead of
+// finding whatever lives there next.
+// --------------------------------------------------------
+typedef unsigned int EntityHandle;
+
+// Never a live entity (generations start at 1)
+const EntityHandle NoEntity = 0;
+
+// --------------------------------------------------------
+// Every entity in the game, stored in fixed size slabs
+//
+// Entities are built in place in slabs of EntityPool::SlabSize,
+// which are never moved or freed while the pool lives - a
+// GameEntity* stays good until its entity is destroyed.  Freed
+// slots are reused before a new slab is made, so spawning and
+// despawning at a steady rate doesn't allocate at all once the
+// pool (and the TransformSystem) have grown to fit.
+//
+// Create() and Destroy() are O(1).  Live entities are also kept
+// in a packed list of slots (destroying swaps the last one into
+// the gap), which ForEach() walks without visiting dead slots.
+// --------------------------------------------------------
+class EntityPool
+{
+	static const unsigned int SlotBits = 20;
+	static const unsigned int SlotMask = (1u << SlotBits) - 1;
+	static const unsigned int MaxGeneration = (1u << (32 - SlotBits)) - 1;
+	static const unsigned int SlabBits = 10;
+
+	TransformSystem* transforms;
+	std::vector<GameEntity*> slabs;
+	std::vector<unsigned short> generations;	// Per slot - the current one if alive, the next one if free
+	std::vector<unsigned int> livePositions;	// Per slot - where it is in live
+	std::vector<unsigned int> live;				// Slots of live entities, packed
+	std::vector<unsigned int> freeSlots;
+
+	GameEntity* GetSlot(unsigned int slot);
+	bool IsAlive(unsigned int slot, unsigned int generation);
+public:
+	static const unsigned int SlabSize = 1u << SlabBits;
+	static const unsigned int MaxEntities = 1u << SlotBits;
+
+	EntityPool(TransformSystem* transforms);
+	~EntityPool();	// Destroys any entities still alive
+
+	// NoEntity once MaxEntities are alive
+	EntityHandle Create(Mesh* mesh, Material* mat);
+
+	// False (and nothing happens) if the handle is stale
+	bool Destroy(EntityHandle handle);
+
+	// 0 if the handle is stale
+	GameEntity* Get(EntityHandle handle);
+	bool IsAlive(EntityHandle handle);
+
+	size_t GetCount();
+
+	// Calls job(handle, entity) for every live entity - the job
+	// may not create or destroy entities
+	template<typename Job>
+	void ForEach(Job job)
+	{
+		for (size_t i = 0; i < live.size(); i++)
+		{
+			unsigned int slot = live[i];
+			job(((EntityHandle)generations[slot] << SlotBits) | slot, *GetSlot(slot));
+		}
+	}
+};
+
+inline GameEntity* EntityPool::GetSlot(unsigned int slot)
+{
+	return &slabs[slot >> SlabBits][slot & (SlabSize - 1)];
+}
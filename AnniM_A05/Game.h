@@ -1,71 +1,101 @@
-#pragma once
-
-#include "DXCore.h"
-#include "SimpleShader.h"
-#include <DirectXMath.h>
-#include "Mesh.h"
-#include "GameEntity.h"
-#include "Camera.h"
-#include "Material.h"
-#include "Light.h"
-
-class Game 
-	: public DXCore
-{
-
-public:
-	Game(HINSTANCE hInstance);
-	~Game();
-	DirectionalLight light;
-	// Overridden setup and game loop methods, which
-	// will be called automatically
-	void Init();
-	void OnResize();
-	void Update(float deltaTime, float totalTime);
-	void Draw(float deltaTime, float totalTime);
-
-	// Overridden mouse input helper methods
-	void OnMouseDown (WPARAM buttonState, int x, int y);
-	void OnMouseUp	 (WPARAM buttonState, int x, int y);
-	void OnMouseMove (WPARAM buttonState, int x, int y);
-	void OnMouseWheel(float wheelDelta,   int x, int y);
-private:
-
-	// Initialization helper methods - feel free to customize, combine, etc.
-	void LoadShaders(); 
-	void CreateMatrices();
-	void CreateBasicGeometry();
-
-	// Buffers to hold actual geometry data
-	ID3D11Buffer* vBuff;
-	ID3D11Buffer* vBuff2;
-	ID3D11Buffer* vBuff3;
-
-	// Wrappers for DirectX shaders to provide simplified functionality
-	SimpleVertexShader* vertexShader;
-	SimplePixelShader* pixelShader;
-
-	// The matrices to go from model space to screen space
-	DirectX::XMFLOAT4X4 worldMatrix;
-	DirectX::XMFLOAT4X4 viewMatrix;
-	DirectX::XMFLOAT4X4 projectionMatrix;
-
-	// Keeps track of the old mouse position.  Useful for 
-	// determining how far the mouse moved in a single frame.
-	POINT prevMousePos;
-	Mesh* coneMesh;
-	Mesh* firstMesh;
-
-	Mesh* secondMesh;
-	Mesh* thirdMesh;
-	GameEntity* entity;
-	GameEntity* entity2;
-	GameEntity* entity3;
-	GameEntity* entity4;
-	GameEntity* entity5;
-
-	Camera* cam;
-	Material* material;
-
-};
-
+#pragma once
+
+#include "DXCore.h"
+#include "SimpleShader.h"
+#include <DirectXMath.h>
+#include "Mesh.h"
+#include "GeometryPool.h"
+#include "StreamingMesh.h"
+#include "GameEntity.h"
+#include "EntityPool.h"
+#include "TransformSystem.h"
+#include "Camera.h"
+#include "Material.h"
+#include "Light.h"
+
+class Game 
+	: public DXCore
+{
+
+public:
+	Game(HINSTANCE hInstance);
+	~Game();
+	DirectionalLight light;
+	// Overridden setup and game loop methods, which
+	// will be called automatically
+	void Init();
+	void OnResize();
+	void Update(float deltaTime, float totalTime);
+	void Draw(float deltaTime, float totalTime);
+
+	// Overridden mouse input helper methods
+	void OnMouseDown (WPARAM buttonState, int x, int y);
+	void OnMouseUp	 (WPARAM buttonState, int x, int y);
+	void OnMouseMove (WPARAM buttonState, int x, int y);
+	void OnMouseWheel(float wheelDelta,   int x, int y);
+private:
+
+	// Initialization helper methods - feel free to customize, combine, etc.
+	void LoadShaders(); 
+	void CreateMatrices();
+	void CreateBasicGeometry();
+	void SetSubmeshMaterial(Mesh* mesh, const ObjSubmesh& submesh);
+	void BindMeshBuffers(Mesh* mesh);
+	void DrawEntity(GameEntity* entity);
+	void DrawStreamingMesh();
+
+	// Buffers to hold actual geometry data
+	ID3D11Buffer* vBuff;
+	ID3D11Buffer* vBuff2;
+	ID3D11Buffer* vBuff3;
+
+	// Wrappers for DirectX shaders to provide simplified functionality
+	SimpleVertexShader* vertexShader;
+	SimplePixelShader* pixelShader;
+
+	// Input layouts for meshes using VertexFormat::Compact and
+	// VertexFormat::Tangent (the vertex shader's own layout
+	// handles VertexFormat::Full)
+	ID3D11InputLayout* compactInputLayout;
+	ID3D11InputLayout* tangentInputLayout;
+
+	// What's bound to the input assembler right now, so meshes
+	// sharing buffers (pooled ones) don't bind them again
+	ID3D11Buffer* boundVertexBuffer;
+	ID3D11Buffer* boundIndexBuffer;
+	DXGI_FORMAT boundIndexFormat;
+	UINT boundStride;
+
+	// The matrices to go from model space to screen space
+	DirectX::XMFLOAT4X4 worldMatrix;
+	DirectX::XMFLOAT4X4 viewMatrix;
+	DirectX::XMFLOAT4X4 projectionMatrix;
+
+	// Keeps track of the old mouse position.  Useful for 
+	// determining how far the mouse moved in a single frame.
+	POINT prevMousePos;
+
+	// Shared buffers that compact meshes move into once loaded
+	GeometryPool* geometryPool;
+
+	// A model too big to load at once - only the chunks near
+	// the camera are resident
+	StreamingMesh* streamingMesh;
+	Mesh* coneMesh;
+	Mesh* firstMesh;
+
+	Mesh* secondMesh;
+	Mesh* thirdMesh;
+
+	// Every entity's position, rotation, scale and world matrix
+	TransformSystem* transforms;
+
+	// Every entity, and the cone among them
+	EntityPool* entities;
+	EntityHandle coneEntity;
+
+	Camera* cam;
+	Material* material;
+
+};
+
@@ -1,87 +1,142 @@
-#include "GameEntity.h"
-GameEntity::GameEntity(Mesh* mesh, Material* mat)
-{
-	gameMesh = mesh;
-	material = mat;
-	worldTemp = XMMatrixIdentity();
-	XMStoreFloat4x4(&world, XMMatrixTranspose(worldTemp));
-	scale = XMFLOAT3(1.f, 1.f, 1.f);
-	pos = XMFLOAT3(0.f, 0.f, 0.f);
-	rot = XMFLOAT3(0.f, 0.f, 0.f);
-}
-GameEntity::~GameEntity()
-{
-	
-}
-
-XMFLOAT4X4 GameEntity::GetWorld()
-{
-	return world;
-}
-
-XMFLOAT3 GameEntity::GetPos()
-{
-	return pos;
-}
-
-XMFLOAT3 GameEntity::GetRot()
-{
-	return rot;
-}
-
-XMFLOAT3 GameEntity::GetScale()
-{
-	return scale;
-}
-
-void GameEntity::SetPos(XMFLOAT3 newPos)
-{
-	pos = newPos;
-	XMMATRIX newMat = XMMatrixIdentity() * XMMatrixTranslation(newPos.x, newPos.y, newPos.z);
-	SetWorld(newMat);
-}
-
-void GameEntity::SetRot(XMFLOAT3 newRot)
-{
-	rot = newRot;
-	XMMATRIX newMat = XMMatrixIdentity() * XMMatrixRotationRollPitchYaw(newRot.x, newRot.y, newRot.z);
-	SetWorld(newMat);
-}
-
-void GameEntity::SetScale(XMFLOAT3 newScale)
-{
-	scale = newScale;
-	XMMATRIX newMat = XMMatrixIdentity() * XMMatrixScaling(newScale.x, newScale.y, newScale.z);
-	SetWorld(newMat);
-}
-
-void GameEntity::SetWorld(XMMATRIX newWorld)
-{
-	XMStoreFloat4x4(&world, XMMatrixTranspose(newWorld));
-}
-
-void GameEntity::Move(XMFLOAT3 move)
-{
-	SetPos(XMFLOAT3(pos.x + move.x, pos.y + move.y, pos.z + move.z));
-}
-
-void GameEntity::Rotate(XMFLOAT3 rotate)
-{
-	SetRot(XMFLOAT3(rot.x + rotate.x, rot.y + rotate.y, rot.z + rotate.z));
-}
-
-void GameEntity::Scale(XMFLOAT3 scaled)
-{
-	SetScale(XMFLOAT3(scale.x + scaled.x, scale.y + scaled.y, scale.z + scaled.z));
-}
-
-void GameEntity::PrepareMaterial(XMFLOAT4X4 view, XMFLOAT4X4 proj)
-{
-	material->GetVShader()->SetMatrix4x4("world", this->GetWorld());
-	material->GetVShader()->SetMatrix4x4("view", view);
-	material->GetVShader()->SetMatrix4x4("projection", proj);
-
-	material->GetVShader()->CopyAllBufferData();
-	material->GetVShader()->SetShader();
-	material->GetPShader()->SetShader();
-}
+#include "GameEntity.h"
+GameEntity::GameEntity(Mesh* mesh, Material* mat, TransformSystem* transforms)
+{
+	gameMesh = mesh;
+	material = mat;
+	this->transforms = transforms;
+	transform = transforms->Create();
+}
+GameEntity::~GameEntity()
+{
+	transforms->Destroy(transform);
+}
+
+TransformHandle GameEntity::GetTransform()
+{
+	return transform;
+}
+
+const XMFLOAT4X4& GameEntity::GetWorld()
+{
+	return transforms->GetWorld(transform);
+}
+
+XMFLOAT3 GameEntity::GetPos()
+{
+	return transforms->GetPosition(transform);
+}
+
+// --------------------------------------------------------
+// Back to the angles XMMatrixRotationRollPitchYaw takes, from
+// the rotation's matrix - its third row is (cos p sin y,
+// -sin p, cos p cos y), and its middle column is
+// cos p (sin r, cos r)
+// --------------------------------------------------------
+XMFLOAT3 GameEntity::GetRot()
+{
+	XMFLOAT4 rotation = transforms->GetRotation(transform);
+	XMFLOAT4X4 r;
+	XMStoreFloat4x4(&r, XMMatrixRotationQuaternion(XMLoadFloat4(&rotation)));
+
+	XMFLOAT3 rot;
+	float cosPitch = sqrtf(r._12 * r._12 + r._22 * r._22);
+	rot.x = atan2f(-r._32, cosPitch);
+	if (cosPitch > 1e-6f)
+	{
+		rot.y = atan2f(r._31, r._33);
+		rot.z = atan2f(r._12, r._22);
+	}
+	else
+	{
+		// Looking straight up or down: yaw and roll turn about the
+		// same axis, so it's all put into yaw
+		rot.y = atan2f(-r._13, r._11);
+		rot.z = 0.0f;
+	}
+	return rot;
+}
+
+XMFLOAT3 GameEntity::GetScale()
+{
+	return transforms->GetScale(transform);
+}
+
+void GameEntity::SetPos(XMFLOAT3 newPos)
+{
+	transforms->SetPosition(transform, newPos);
+}
+
+void GameEntity::SetRot(XMFLOAT3 newRot)
+{
+	XMFLOAT4 rotation;
+	XMStoreFloat4(&rotation, XMQuaternionRotationRollPitchYaw(newRot.x, newRot.y, newRot.z));
+	transforms->SetRotation(transform, rotation);
+}
+
+void GameEntity::SetScale(XMFLOAT3 newScale)
+{
+	transforms->SetScale(transform, newScale);
+}
+
+// --------------------------------------------------------
+// Takes position, rotation and scale from a whole matrix (any
+// shear it has is lost)
+// --------------------------------------------------------
+void GameEntity::SetWorld(XMMATRIX newWorld)
+{
+	XMVECTOR newScale, newRotation, newPos;
+	if (!XMMatrixDecompose(&newScale, &newRotation, &newPos, newWorld))
+		newRotation = XMQuaternionIdentity();
+
+	XMFLOAT3 scale, pos;
+	XMFLOAT4 rotation;
+	XMStoreFloat3(&scale, newScale);
+	XMStoreFloat4(&rotation, newRotation);
+	XMStoreFloat3(&pos, newPos);
+	transforms->SetScale(transform, scale);
+	transforms->SetRotation(transform, rotation);
+	transforms->SetPosition(transform, pos);
+}
+
+bool GameEntity::SetParent(GameEntity* parent)
+{
+	return transforms->SetParent(transform, parent ? parent->transform : NoTransform);
+}
+
+void GameEntity::Move(XMFLOAT3 move)
+{
+	XMFLOAT3 pos = GetPos();
+	SetPos(XMFLOAT3(pos.x + move.x, pos.y + move.y, pos.z + move.z));
+}
+
+void GameEntity::Rotate(XMFLOAT3 rotate)
+{
+	XMFLOAT4 rotation;
+	XMStoreFloat4(&rotation, XMQuaternionRotationRollPitchYaw(rotate.x, rotate.y, rotate.z));
+	transforms->Rotate(transform, rotation);
+}
+
+void GameEntity::Rotate(XMFLOAT4 rotation)
+{
+	transforms->Rotate(transform, rotation);
+}
+
+void GameEntity::Scale(XMFLOAT3 scaled)
+{
+	XMFLOAT3 scale = GetScale();
+	SetScale(XMFLOAT3(scale.x + scaled.x, scale.y + scaled.y, scale.z + scaled.z));
+}
+
+void GameEntity::PrepareMaterial(XMFLOAT4X4 view, XMFLOAT4X4 proj)
+{
+	material->GetVShader()->SetMatrix4x4("world", this->GetWorld());
+	material->GetVShader()->SetMatrix4x4("view", view);
+	material->GetVShader()->SetMatrix4x4("projection", proj);
+	material->GetVShader()->SetFloat3("positionScale", gameMesh->GetPositionScale());
+	material->GetVShader()->SetFloat3("positionOffset", gameMesh->GetPositionOffset());
+	material->GetVShader()->SetInt("octahedralNormals", gameMesh->GetVertexFormat() == VertexFormat::Compact);
+
+	material->GetVShader()->CopyAllBufferData();
+	material->GetVShader()->SetShader();
+	material->GetPShader()->SetShader();
+}
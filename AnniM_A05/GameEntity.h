@@ -1,35 +1,53 @@
-#pragma once
-#include <d3d11.h>
-#include <DirectXMath.h>
-#include "Vertex.h"
-#include "Mesh.h"
-#include "DXCore.h"
-#include "Material.h"
-using namespace DirectX;
-class GameEntity
-{	
-public:
-	XMMATRIX worldTemp;
-	XMFLOAT3 pos;
-	XMFLOAT3 scale;
-	XMFLOAT3 rot;
-	XMFLOAT4X4 world;
-	Mesh* gameMesh;
-	Material* material;
-	GameEntity(Mesh* mesh, Material* mat);
-	~GameEntity();
-	XMFLOAT4X4 GetWorld();
-	XMFLOAT3 GetRot();
-	XMFLOAT3 GetPos();
-	XMFLOAT3 GetScale();
-	void SetRot(XMFLOAT3);
-	void SetPos(XMFLOAT3);
-	void SetScale(XMFLOAT3);
-	void SetWorld(XMMATRIX);
-	void Move(XMFLOAT3);
-	void Rotate(XMFLOAT3);
-	void Scale(XMFLOAT3);
-	void PrepareMaterial(XMFLOAT4X4, XMFLOAT4X4);
-};
-
-
+#pragma once
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include "Vertex.h"
+#include "Mesh.h"
+#include "DXCore.h"
+#include "Material.h"
+#include "TransformSystem.h"
+using namespace DirectX;
+
+// --------------------------------------------------------
+// Something drawn in the world
+//
+// The entity's position, rotation and scale live in a
+// TransformSystem (the entity just holds its handle there), so
+// changing them only marks the world matrix dirty - it's
+// rebuilt (scale, then rotation, then translation) in the
+// system's next batch, or when it's asked for.  Rotations are
+// stored as quaternions, but given as pitch, yaw and roll in
+// radians.  Rotate() turns the entity further about its
+// parent's axes by quaternion multiplication - something
+// spinning every frame can build its turn once as a quaternion
+// and pass that instead, with no trig per frame.
+//
+// An entity attached to a parent moves with it: its position,
+// rotation and scale are then relative to the parent.
+// --------------------------------------------------------
+class GameEntity
+{
+	TransformSystem* transforms;
+	TransformHandle transform;
+public:
+	Mesh* gameMesh;
+	Material* material;
+	GameEntity(Mesh* mesh, Material* mat, TransformSystem* transforms);
+	~GameEntity();
+	TransformHandle GetTransform();
+	const XMFLOAT4X4& GetWorld();
+	XMFLOAT3 GetRot();
+	XMFLOAT3 GetPos();
+	XMFLOAT3 GetScale();
+	void SetRot(XMFLOAT3);
+	void SetPos(XMFLOAT3);
+	void SetScale(XMFLOAT3);
+	void SetWorld(XMMATRIX);
+	bool SetParent(GameEntity* parent);	// 0 detaches - fails if it would make a loop
+	void Move(XMFLOAT3);
+	void Rotate(XMFLOAT3);
+	void Rotate(XMFLOAT4);		// A unit quaternion
+	void Scale(XMFLOAT3);
+	void PrepareMaterial(XMFLOAT4X4, XMFLOAT4X4);
+};
+
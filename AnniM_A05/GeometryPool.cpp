@@ -0,0 +1,185 @@
+#include "GeometryPool.h"
+
+GeometryPool::GeometryPool(ID3D11Device* device, ID3D11DeviceContext* context, VertexFormat format, unsigned int vertexCapacity, unsigned int indexCapacity)
+	: vertexRanges(vertexCapacity), indexRanges(indexCapacity)
+{
+	this->device = device;
+	this->context = context;
+	this->format = format;
+	vertexStride = GetVertexSize(format);
+	vertexBuffer = 0;
+	indexBuffer = 0;
+	CreatePoolBuffers(&vertexBuffer, &indexBuffer);
+}
+
+GeometryPool::~GeometryPool()
+{
+	if (vertexBuffer) { vertexBuffer->Release(); }
+	if (indexBuffer) { indexBuffer->Release(); }
+}
+
+// --------------------------------------------------------
+// Creates a (default usage, so copies can write to it) pair
+// of buffers at the pool's full capacity
+// --------------------------------------------------------
+bool GeometryPool::CreatePoolBuffers(ID3D11Buffer** vertices, ID3D11Buffer** indices)
+{
+	D3D11_BUFFER_DESC vbd;
+	vbd.Usage = D3D11_USAGE_DEFAULT;
+	vbd.ByteWidth = vertexStride * vertexRanges.GetCapacity();
+	vbd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	vbd.CPUAccessFlags = 0;
+	vbd.MiscFlags = 0;
+	vbd.StructureByteStride = 0;
+	if (FAILED(device->CreateBuffer(&vbd, 0, vertices)))
+		return false;
+
+	D3D11_BUFFER_DESC ibd;
+	ibd.Usage = D3D11_USAGE_DEFAULT;
+	ibd.ByteWidth = sizeof(unsigned short) * indexRanges.GetCapacity();
+	ibd.BindFlags = D3D11_BIND_INDEX_BUFFER;
+	ibd.CPUAccessFlags = 0;
+	ibd.MiscFlags = 0;
+	ibd.StructureByteStride = 0;
+	if (FAILED(device->CreateBuffer(&ibd, 0, indices)))
+	{
+		(*vertices)->Release();
+		*vertices = 0;
+		return false;
+	}
+
+	return true;
+}
+
+bool GeometryPool::Add(Mesh* mesh)
+{
+	if (!vertexBuffer || !indexBuffer ||
+		!mesh->IsReady() || mesh->pool ||
+		mesh->vertexFormat != format ||
+		mesh->indexFormat != DXGI_FORMAT_R16_UINT)
+		return false;
+
+	// Make room, defragmenting first if there's enough space but
+	// not in one piece
+	unsigned int vertexOffset = vertexRanges.Allocate(mesh->numVertices);
+	unsigned int indexOffset = indexRanges.Allocate(mesh->totalIndices);
+	if (vertexOffset == RangeAllocator::InvalidOffset || indexOffset == RangeAllocator::InvalidOffset)
+	{
+		if (vertexOffset != RangeAllocator::InvalidOffset) vertexRanges.Free(vertexOffset);
+		if (indexOffset != RangeAllocator::InvalidOffset) indexRanges.Free(indexOffset);
+		if (vertexRanges.GetFreeSize() < mesh->numVertices ||
+			indexRanges.GetFreeSize() < mesh->totalIndices ||
+			!Defragment())
+			return false;
+
+		vertexOffset = vertexRanges.Allocate(mesh->numVertices);
+		indexOffset = indexRanges.Allocate(mesh->totalIndices);
+	}
+
+	// Copy on the GPU - the mesh's own buffers are immutable,
+	// but can still be copied from
+	D3D11_BOX vertexBox = { 0, 0, 0, mesh->numVertices * vertexStride, 1, 1 };
+	context->CopySubresourceRegion(vertexBuffer, 0, vertexOffset * vertexStride, 0, 0, mesh->vBuffer, 0, &vertexBox);
+	D3D11_BOX indexBox = { 0, 0, 0, mesh->totalIndices * (UINT)sizeof(unsigned short), 1, 1 };
+	context->CopySubresourceRegion(indexBuffer, 0, indexOffset * (UINT)sizeof(unsigned short), 0, 0, mesh->iBuffer, 0, &indexBox);
+
+	mesh->vBuffer->Release();
+	mesh->iBuffer->Release();
+	mesh->vBuffer = 0;
+	mesh->iBuffer = 0;
+	mesh->pool = this;
+	mesh->baseVertex = vertexOffset;
+	mesh->startIndex = indexOffset;
+
+	meshes[vertexOffset] = mesh;
+	return true;
+}
+
+void GeometryPool::Remove(Mesh* mesh)
+{
+	if (mesh->pool != this)
+		return;
+
+	vertexRanges.Free(mesh->baseVertex);
+	indexRanges.Free(mesh->startIndex);
+	meshes.erase(mesh->baseVertex);
+	mesh->pool = 0;
+	mesh->baseVertex = 0;
+	mesh->startIndex = 0;
+}
+
+// --------------------------------------------------------
+// Packs the meshes together by copying them into a new pair of
+// buffers (a copy within one buffer mustn't overlap itself)
+// - Needs twice the memory while it runs
+// --------------------------------------------------------
+bool GeometryPool::Defragment()
+{
+	ID3D11Buffer* newVertices = 0;
+	ID3D11Buffer* newIndices = 0;
+	if (!CreatePoolBuffers(&newVertices, &newIndices))
+		return false;
+
+	std::vector<RangeAllocator::Move> vertexMoves = vertexRanges.Defragment();
+	std::vector<RangeAllocator::Move> indexMoves = indexRanges.Defragment();
+	std::map<unsigned int, unsigned int> newVertexOffsets;
+	std::map<unsigned int, unsigned int> newIndexOffsets;
+	for (size_t i = 0; i < vertexMoves.size(); i++)
+		newVertexOffsets[vertexMoves[i].from] = vertexMoves[i].to;
+	for (size_t i = 0; i < indexMoves.size(); i++)
+		newIndexOffsets[indexMoves[i].from] = indexMoves[i].to;
+
+	std::map<unsigned int, Mesh*> moved;
+	for (auto it = meshes.begin(); it != meshes.end(); ++it)
+	{
+		Mesh* mesh = it->second;
+		unsigned int vertexOffset = newVertexOffsets.count(mesh->baseVertex) ? newVertexOffsets[mesh->baseVertex] : mesh->baseVertex;
+		unsigned int indexOffset = newIndexOffsets.count(mesh->startIndex) ? newIndexOffsets[mesh->startIndex] : mesh->startIndex;
+
+		D3D11_BOX vertexBox = { mesh->baseVertex * vertexStride, 0, 0, (mesh->baseVertex + mesh->numVertices) * vertexStride, 1, 1 };
+		context->CopySubresourceRegion(newVertices, 0, vertexOffset * vertexStride, 0, 0, vertexBuffer, 0, &vertexBox);
+		D3D11_BOX indexBox = { mesh->startIndex * (UINT)sizeof(unsigned short), 0, 0, (mesh->startIndex + mesh->totalIndices) * (UINT)sizeof(unsigned short), 1, 1 };
+		context->CopySubresourceRegion(newIndices, 0, indexOffset * (UINT)sizeof(unsigned short), 0, 0, indexBuffer, 0, &indexBox);
+
+		mesh->baseVertex = vertexOffset;
+		mesh->startIndex = indexOffset;
+		moved[vertexOffset] = mesh;
+	}
+
+	vertexBuffer->Release();
+	indexBuffer->Release();
+	vertexBuffer = newVertices;
+	indexBuffer = newIndices;
+	meshes.swap(moved);
+	return true;
+}
+
+ID3D11Buffer* GeometryPool::GetVertexBuffer()
+{
+	return vertexBuffer;
+}
+
+ID3D11Buffer* GeometryPool::GetIndexBuffer()
+{
+	return indexBuffer;
+}
+
+UINT GeometryPool::GetVertexStride()
+{
+	return vertexStride;
+}
+
+unsigned int GeometryPool::GetMeshCount()
+{
+	return (unsigned int)meshes.size();
+}
+
+unsigned int GeometryPool::GetFreeVertices()
+{
+	return vertexRanges.GetFreeSize();
+}
+
+unsigned int GeometryPool::GetFreeIndices()
+{
+	return indexRanges.GetFreeSize();
+}
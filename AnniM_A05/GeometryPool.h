@@ -0,0 +1,62 @@
+#pragma once
+
+#include <d3d11.h>
+#include <map>
+#include "Mesh.h"
+#include "RangeAllocator.h"
+
+// --------------------------------------------------------
+// A shared vertex and index buffer for many meshes
+//
+// Meshes of one vertex format (with 16-bit indices) are moved
+// into a pair of big buffers, each getting a range of both.
+// Drawing them back to back then needs no IASetVertexBuffers /
+// IASetIndexBuffer in between - just a different StartIndex
+// and BaseVertex in DrawIndexed.
+//
+// Ranges come from RangeAllocator.  When free space is too
+// fragmented for a new mesh, the pool is defragmented on the
+// GPU (CopySubresourceRegion into fresh buffers).
+//
+// Uses the immediate context, so main thread only.  Delete the
+// pool after the meshes in it.
+// --------------------------------------------------------
+class GeometryPool
+{
+	ID3D11Device* device;
+	ID3D11DeviceContext* context;
+	VertexFormat format;
+	UINT vertexStride;
+	ID3D11Buffer* vertexBuffer;
+	ID3D11Buffer* indexBuffer;
+	RangeAllocator vertexRanges;
+	RangeAllocator indexRanges;
+	std::map<unsigned int, Mesh*> meshes;	// By first vertex
+
+	bool CreatePoolBuffers(ID3D11Buffer** vertices, ID3D11Buffer** indices);
+public:
+	// vertexCapacity / indexCapacity - in vertices and indices
+	GeometryPool(ID3D11Device* device, ID3D11DeviceContext* context, VertexFormat format, unsigned int vertexCapacity, unsigned int indexCapacity);
+	~GeometryPool();
+
+	// Moves a Ready mesh's geometry into the pool, releasing its
+	// own buffers.  Fails (and leaves the mesh alone) if its
+	// format doesn't match, it uses 32-bit indices or it doesn't fit.
+	bool Add(Mesh* mesh);
+
+	// Called by the mesh when it's deleted
+	void Remove(Mesh* mesh);
+
+	// Packs every mesh to the start of the buffers
+	bool Defragment();
+
+	ID3D11Buffer* GetVertexBuffer();
+	ID3D11Buffer* GetIndexBuffer();
+	UINT GetVertexStride();
+	unsigned int GetMeshCount();
+	unsigned int GetFreeVertices();
+	unsigned int GetFreeIndices();
+
+	GeometryPool(const GeometryPool&) = delete;
+	GeometryPool& operator=(const GeometryPool&) = delete;
+};
@@ -1,9 +1,9 @@
-#include <d3d11.h>
-#include <DirectXMath.h>
-
-struct DirectionalLight
-{
-	DirectX::XMFLOAT4 AmbientColor;
-	DirectX::XMFLOAT4 DiffuseColor;
-	DirectX::XMFLOAT3 Direction;
+#include <d3d11.h>
+#include <DirectXMath.h>
+
+struct DirectionalLight
+{
+	DirectX::XMFLOAT4 AmbientColor;
+	DirectX::XMFLOAT4 DiffuseColor;
+	DirectX::XMFLOAT3 Direction;
 };
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const char* file)
+{
+	data = 0;
+	size = 0;
+
+#ifdef _WIN32
+	fileHandle = INVALID_HANDLE_VALUE;
+	mappingHandle = 0;
+
+	HANDLE handle = CreateFileA(file, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0);
+	if (handle == INVALID_HANDLE_VALUE)
+		return;
+	fileHandle = handle;
+
+	// Empty files can't be mapped, so they're left open with no data
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(handle, &fileSize) || fileSize.QuadPart == 0)
+		return;
+
+	HANDLE mapping = CreateFileMappingA(handle, 0, PAGE_READONLY, 0, 0, 0);
+	if (!mapping)
+		return;
+	mappingHandle = mapping;
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!view)
+		return;
+
+	data = (const char*)view;
+	size = (size_t)fileSize.QuadPart;
+#else
+	fileDescriptor = open(file, O_RDONLY);
+	if (fileDescriptor < 0)
+		return;
+
+	struct stat info;
+	if (fstat(fileDescriptor, &info) != 0 || info.st_size == 0)
+		return;
+
+	void* view = mmap(0, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	if (view == MAP_FAILED)
+		return;
+
+	// We read front to back, so let the OS read ahead aggressively
+	madvise(view, (size_t)info.st_size, MADV_SEQUENTIAL);
+
+	data = (const char*)view;
+	size = (size_t)info.st_size;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+	if (data) { UnmapViewOfFile(data); }
+	if (mappingHandle) { CloseHandle((HANDLE)mappingHandle); }
+	if (fileHandle != INVALID_HANDLE_VALUE) { CloseHandle((HANDLE)fileHandle); }
+#else
+	if (data) { munmap((void*)data, size); }
+	if (fileDescriptor >= 0) { close(fileDescriptor); }
+#endif
+}
+
+// --------------------------------------------------------
+// True if the file was found (even if it's empty)
+// --------------------------------------------------------
+bool MappedFile::IsOpen()
+{
+#ifdef _WIN32
+	return fileHandle != INVALID_HANDLE_VALUE;
+#else
+	return fileDescriptor >= 0;
+#endif
+}
+
+const char* MappedFile::GetData()
+{
+	return data;
+}
+
+size_t MappedFile::GetSize()
+{
+	return size;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+
+// --------------------------------------------------------
+// A read-only, memory-mapped view of an entire file
+//
+// Lets the loaders scan a file in place instead of copying
+// it line by line through a stream.  Works on Windows and
+// on POSIX systems (so the loaders can be run headlessly).
+// --------------------------------------------------------
+class MappedFile
+{
+	const char* data;
+	size_t size;
+#ifdef _WIN32
+	void* fileHandle;
+	void* mappingHandle;
+#else
+	int fileDescriptor;
+#endif
+public:
+	MappedFile(const char* file);
+	~MappedFile();
+	bool IsOpen();
+	const char* GetData();
+	size_t GetSize();
+
+	// Not copyable - the mapping is owned by exactly one object
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+};
@@ -1,15 +1,15 @@
-#include "Material.h"
-Material::Material(SimpleVertexShader* vShade, SimplePixelShader* pShade)
-{
-	vertexShader = vShade;
-	pixelShader = pShade;
-}
-SimplePixelShader* Material::GetPShader()
-{
-	return pixelShader;
-}
-
-SimpleVertexShader* Material::GetVShader()
-{
-	return vertexShader;
+#include "Material.h"
+Material::Material(SimpleVertexShader* vShade, SimplePixelShader* pShade)
+{
+	vertexShader = vShade;
+	pixelShader = pShade;
+}
+SimplePixelShader* Material::GetPShader()
+{
+	return pixelShader;
+}
+
+SimpleVertexShader* Material::GetVShader()
+{
+	return vertexShader;
 }
\ No newline at end of file
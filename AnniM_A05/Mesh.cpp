@@ -1,252 +1,530 @@
-#include "Mesh.h"
-Mesh::Mesh(Vertex* vertices, int numVertices, unsigned int* indices, int numIndex, ID3D11Device* device)
-{
-	iBuffer = 0;
-	vBuffer = 0;
-	D3D11_BUFFER_DESC vbd;
-	vbd.Usage = D3D11_USAGE_IMMUTABLE;
-	vbd.ByteWidth = sizeof(Vertex) * numVertices;       // 3 = number of vertices in the buffer
-	vbd.BindFlags = D3D11_BIND_VERTEX_BUFFER; // Tells DirectX this is a vertex buffer
-	vbd.CPUAccessFlags = 0;
-	vbd.MiscFlags = 0;
-	vbd.StructureByteStride = 0;
-
-	D3D11_SUBRESOURCE_DATA initialVertexData;
-	initialVertexData.pSysMem = vertices;
-
-	device->CreateBuffer(&vbd, &initialVertexData, &vBuffer);
-
-	D3D11_BUFFER_DESC ibd;
-	ibd.Usage = D3D11_USAGE_IMMUTABLE;
-	ibd.ByteWidth = sizeof(int) * numIndex;         // 3 = number of indices in the buffer
-	ibd.BindFlags = D3D11_BIND_INDEX_BUFFER; // Tells DirectX this is an index buffer
-	ibd.CPUAccessFlags = 0;
-	ibd.MiscFlags = 0;
-	ibd.StructureByteStride = 0;
-
-	D3D11_SUBRESOURCE_DATA initialIndexData;
-	initialIndexData.pSysMem = indices;
-
-	device->CreateBuffer(&ibd, &initialIndexData, &iBuffer);
-	numIndices = numIndex;
-}
-
-Mesh::Mesh(const char* file, ID3D11Device* device)
-{
-	// File input object
-	std::ifstream obj(file);
-
-	// Check for successful open
-	if (!obj.is_open())
-		return;
-
-	// Variables used while reading the file
-	std::vector<DirectX::XMFLOAT3> positions;     // Positions from the file
-	std::vector<DirectX::XMFLOAT3> normals;       // Normals from the file
-	std::vector<DirectX::XMFLOAT2> uvs;           // UVs from the file
-	std::vector<Vertex> verts;           // Verts we're assembling
-	std::vector<UINT> indices;           // Indices of these verts
-	unsigned int vertCounter = 0;        // Count of vertices/indices
-	char chars[100];                     // String for line reading
-
-	// Still have data left?
-	while (obj.good())
-	{
-		// Get the line (100 characters should be more than enough)
-		obj.getline(chars, 100);
-
-		// Check the type of line
-		if (chars[0] == 'v' && chars[1] == 'n')
-		{
-			// Read the 3 numbers directly into an XMFLOAT3
-			DirectX::XMFLOAT3 norm;
-			sscanf_s(
-				chars,
-				"vn %f %f %f",
-				&norm.x, &norm.y, &norm.z);
-
-			// Add to the list of normals
-			normals.push_back(norm);
-		}
-		else if (chars[0] == 'v' && chars[1] == 't')
-		{
-			// Read the 2 numbers directly into an XMFLOAT2
-			DirectX::XMFLOAT2 uv;
-			sscanf_s(
-				chars,
-				"vt %f %f",
-				&uv.x, &uv.y);
-
-			// Add to the list of uv's
-			uvs.push_back(uv);
-		}
-		else if (chars[0] == 'v')
-		{
-			// Read the 3 numbers directly into an XMFLOAT3
-			DirectX::XMFLOAT3 pos;
-			sscanf_s(
-				chars,
-				"v %f %f %f",
-				&pos.x, &pos.y, &pos.z);
-
-			// Add to the positions
-			positions.push_back(pos);
-		}
-		else if (chars[0] == 'f')
-		{
-			// Read the face indices into an array
-			unsigned int i[12];
-			int facesRead = sscanf_s(
-				chars,
-				"f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d",
-				&i[0], &i[1], &i[2],
-				&i[3], &i[4], &i[5],
-				&i[6], &i[7], &i[8],
-				&i[9], &i[10], &i[11]);
-
-			// - Create the verts by looking up
-			//    corresponding data from vectors
-			// - OBJ File indices are 1-based, so
-			//    they need to be adusted
-			Vertex v1;
-			v1.Position = positions[i[0] - 1];
-			v1.UV = uvs[i[1] - 1];
-			v1.Normal = normals[i[2] - 1];
-
-			Vertex v2;
-			v2.Position = positions[i[3] - 1];
-			v2.UV = uvs[i[4] - 1];
-			v2.Normal = normals[i[5] - 1];
-
-			Vertex v3;
-			v3.Position = positions[i[6] - 1];
-			v3.UV = uvs[i[7] - 1];
-			v3.Normal = normals[i[8] - 1];
-
-			// The model is most likely in a right-handed space,
-			// especially if it came from Maya.  We want to convert
-			// to a left-handed space for DirectX.  This means we 
-			// need to:
-			//  - Invert the Z position
-			//  - Invert the normal's Z
-			//  - Flip the winding order
-			// We also need to flip the UV coordinate since DirectX
-			// defines (0,0) as the top left of the texture, and many
-			// 3D modeling packages use the bottom left as (0,0)
-
-			// Flip the UV's since they're probably "upside down"
-			v1.UV.y = 1.0f - v1.UV.y;
-			v2.UV.y = 1.0f - v2.UV.y;
-			v3.UV.y = 1.0f - v3.UV.y;
-
-			// Flip Z (LH vs. RH)
-			v1.Position.z *= -1.0f;
-			v2.Position.z *= -1.0f;
-			v3.Position.z *= -1.0f;
-
-			// Flip normal Z
-			v1.Normal.z *= -1.0f;
-			v2.Normal.z *= -1.0f;
-			v3.Normal.z *= -1.0f;
-
-			// Add the verts to the vector (flipping the winding order)
-			verts.push_back(v1);
-			verts.push_back(v3);
-			verts.push_back(v2);
-
-			// Add three more indices
-			indices.push_back(vertCounter); vertCounter += 1;
-			indices.push_back(vertCounter); vertCounter += 1;
-			indices.push_back(vertCounter); vertCounter += 1;
-
-			// Was there a 4th face?
-			if (facesRead == 12)
-			{
-				// Make the last vertex
-				Vertex v4;
-				v4.Position = positions[i[9] - 1];
-				v4.UV = uvs[i[10] - 1];
-				v4.Normal = normals[i[11] - 1];
-
-				// Flip the UV, Z pos and normal
-				v4.UV.y = 1.0f - v4.UV.y;
-				v4.Position.z *= -1.0f;
-				v4.Normal.z *= -1.0f;
-
-				// Add a whole triangle (flipping the winding order)
-				verts.push_back(v1);
-				verts.push_back(v4);
-				verts.push_back(v3);
-
-				// Add three more indices
-				indices.push_back(vertCounter); vertCounter += 1;
-				indices.push_back(vertCounter); vertCounter += 1;
-				indices.push_back(vertCounter); vertCounter += 1;
-			}
-		}
-	}
-
-	// Close the file and create the actual buffers
-	obj.close();
-
-	iBuffer = 0;
-	vBuffer = 0;
-	D3D11_BUFFER_DESC vbd;
-	vbd.Usage = D3D11_USAGE_IMMUTABLE;
-	vbd.ByteWidth = sizeof(Vertex) * vertCounter;       // 3 = number of vertices in the buffer
-	vbd.BindFlags = D3D11_BIND_VERTEX_BUFFER; // Tells DirectX this is a vertex buffer
-	vbd.CPUAccessFlags = 0;
-	vbd.MiscFlags = 0;
-	vbd.StructureByteStride = 0;
-
-	D3D11_SUBRESOURCE_DATA initialVertexData;
-	initialVertexData.pSysMem = &verts[0];
-
-	device->CreateBuffer(&vbd, &initialVertexData, &vBuffer);
-
-	D3D11_BUFFER_DESC ibd;
-	ibd.Usage = D3D11_USAGE_IMMUTABLE;
-	ibd.ByteWidth = sizeof(int) * vertCounter;         // 3 = number of indices in the buffer
-	ibd.BindFlags = D3D11_BIND_INDEX_BUFFER; // Tells DirectX this is an index buffer
-	ibd.CPUAccessFlags = 0;
-	ibd.MiscFlags = 0;
-	ibd.StructureByteStride = 0;
-
-	D3D11_SUBRESOURCE_DATA initialIndexData;
-	initialIndexData.pSysMem = &indices[0];
-
-	device->CreateBuffer(&ibd, &initialIndexData, &iBuffer);
-	numIndices = vertCounter;
-
-	// - At this point, "verts" is a vector of Vertex structs, and can be used
-	//    directly to create a vertex buffer:  &verts[0] is the address of the first vert
-	//
-	// - The vector "indices" is similar. It's a vector of unsigned ints and
-	//    can be used directly for the index buffer: &indices[0] is the address of the first int
-	//
-	// - "vertCounter" is BOTH the number of vertices and the number of indices
-	// - Yes, the indices are a bit redundant here (one per vertex).  Could you skip using
-	//    an index buffer in this case?  Sure!  Though, if your mesh class assumes you have
-	//    one, you'll need to write some extra code to handle cases when you don't.
-}
-
-Mesh::~Mesh()
-{
-	if (iBuffer) { iBuffer->Release(); };
-	
-}
-
-ID3D11Buffer* Mesh::GetVertexBuffer()
-{
-	return vBuffer;
-}
-
-ID3D11Buffer* Mesh::GetIndexBuffer()
-{
-	return iBuffer;
-}
-
-int Mesh::GetIndexCount()
-{
-	return numIndices;
-}
+#include "Mesh.h"
+#include "ObjParser.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "VertexCompression.h"
+#include "GeometryPool.h"
+#include "TangentGenerator.h"
+#include <cstdio>
+
+Mesh::Mesh(Vertex* vertices, int numVertices, unsigned int* indices, int numIndex, ID3D11Device* device, VertexFormat format, bool optimize)
+{
+	Initialize(format);
+	if (!optimize)
+	{
+		state = CreateBuffers(vertices, numVertices, indices, numIndex, device) ? MeshState::Ready : MeshState::Failed;
+		return;
+	}
+
+	// Generated geometry is one submesh, and gets the same passes
+	// as a parsed file
+	ObjMeshData data;
+	data.vertices.assign(vertices, vertices + numVertices);
+	data.indices.assign(indices, indices + numIndex);
+	ObjSubmesh whole = { 0, (unsigned int)numIndex, 0 };
+	data.submeshes.push_back(whole);
+	Optimize(data);
+	state = CreateBuffers(&data.vertices[0], (int)data.vertices.size(), &data.indices[0], (int)data.indices.size(), device) ? MeshState::Ready : MeshState::Failed;
+}
+
+Mesh::Mesh(const char* file, ID3D11Device* device, VertexFormat format, unsigned int threadCount)
+{
+	Initialize(format);
+	LoadObj(file, device, threadCount);
+}
+
+Mesh::Mesh(VertexFormat format)
+{
+	Initialize(format);
+}
+
+void Mesh::Initialize(VertexFormat format)
+{
+	state = MeshState::Loading;
+	iBuffer = 0;
+	vBuffer = 0;
+	numIndices = 0;
+	vertexFormat = format;
+	indexFormat = DXGI_FORMAT_R32_UINT;
+	vertexStride = sizeof(Vertex);
+	residentBytes = 0;
+	numVertices = 0;
+	totalIndices = 0;
+	pool = 0;
+	baseVertex = 0;
+	startIndex = 0;
+	positionScale = XMFLOAT3(1, 1, 1);
+	positionOffset = XMFLOAT3(0, 0, 0);
+	submeshCount = 0;
+}
+
+// --------------------------------------------------------
+// Loads an OBJ file (or its cache) and creates the buffers,
+// then marks the mesh Ready (or Failed)
+// - Safe to call from a worker thread: D3D11 devices are
+//    free-threaded, and nothing here touches the context
+// --------------------------------------------------------
+bool Mesh::LoadObj(const char* file, ID3D11Device* device, unsigned int threadCount)
+{
+	// Warm start: a valid binary cache is uploaded straight from
+	// the mapped file, without parsing anything
+	{
+		MeshCacheView cache;
+		if (cache.Open(file))
+		{
+			lods.assign(cache.GetLods(), cache.GetLods() + cache.GetHeader()->lodCount);
+			meshlets.assign(cache.GetMeshlets(), cache.GetMeshlets() + cache.GetHeader()->meshletCount);
+			submeshCount = cache.GetHeader()->submeshCount;
+			submeshes.assign(cache.GetSubmeshes(), cache.GetSubmeshes() + cache.GetHeader()->lodCount * submeshCount);
+			materials.assign(cache.GetMaterials(), cache.GetMaterials() + cache.GetHeader()->materialCount);
+			bool created = CreateBuffers(
+				cache.GetVertices(),
+				(int)cache.GetHeader()->vertexCount,
+				cache.GetIndices(),
+				(int)cache.GetHeader()->indexCount,
+				device,
+				threadCount);
+			state = created ? MeshState::Ready : MeshState::Failed;
+			return created;
+		}
+	}
+
+	// Parse the file into welded, left-handed vertices and indices
+	// - See ObjParser for the details (this part needs no device)
+	// - Timings are only gathered for the debug console
+	ObjMeshData data;
+#if defined(DEBUG) || defined(_DEBUG)
+	ObjParseStats stats;
+	ObjParseStats* parseStats = &stats;
+#else
+	ObjParseStats* parseStats = 0;
+#endif
+	if (!ParseObjFile(file, data, threadCount, parseStats))
+	{
+		state = MeshState::Failed;
+		return false;
+	}
+
+#if defined(DEBUG) || defined(_DEBUG)
+	printf("Parsed %s: %.2f MB in %.2f ms on %u thread(s) - %.1f MB/s\n",
+		file,
+		stats.bytes / (1024.0 * 1024.0),
+		stats.seconds * 1000.0,
+		stats.threads,
+		stats.megabytesPerSecond);
+#endif
+	Optimize(data);
+
+	// Save the results so the next run can skip parsing and optimizing
+	WriteMeshCache(file, data, lods, meshlets, submeshes);
+
+	bool created = CreateBuffers(&data.vertices[0], (int)data.vertices.size(), &data.indices[0], (int)data.indices.size(), device, threadCount);
+	state = created ? MeshState::Ready : MeshState::Failed;
+	return created;
+}
+
+// --------------------------------------------------------
+// The passes every mesh goes through between its vertices and
+// indices and its buffers (parsed files and generated shapes)
+// - Fills in the LODs, meshlets, submeshes and materials, and
+//    rewrites data in the order they need
+// --------------------------------------------------------
+void Mesh::Optimize(ObjMeshData& data)
+{
+#if defined(DEBUG) || defined(_DEBUG)
+	VertexCacheStats before = AnalyzeVertexCache(&data.indices[0], data.indices.size(), data.vertices.size());
+#endif
+
+	// Reorder the triangles for the GPU's post-transform cache,
+	// then lay the vertices out in the order they're used
+	// - Every submesh (material) is a range of its own, which
+	//    everything below keeps intact
+	// - LOD 0 is then split into meshlets (which keeps most of
+	//    that order) for cluster culling
+	// - The simplified LODs are appended to the same indices and
+	//    optimized on their own; the vertex order follows LOD 0
+	submeshCount = (UINT)data.submeshes.size();
+	std::vector<unsigned int> submeshIndexCounts(submeshCount);
+	meshlets.clear();
+	for (UINT s = 0; s < submeshCount; s++)
+	{
+		const ObjSubmesh& submesh = data.submeshes[s];
+		submeshIndexCounts[s] = submesh.indexCount;
+		OptimizeVertexCache(&data.indices[submesh.startIndex], submesh.indexCount, data.vertices.size());
+
+		std::vector<Meshlet> submeshMeshlets = BuildMeshlets(&data.vertices[0], data.vertices.size(), &data.indices[submesh.startIndex], submesh.indexCount);
+		for (size_t m = 0; m < submeshMeshlets.size(); m++)
+		{
+			submeshMeshlets[m].startIndex += submesh.startIndex;
+			meshlets.push_back(submeshMeshlets[m]);
+		}
+	}
+
+	std::vector<unsigned int> levelIndexCounts;
+	lods = BuildLodChain(&data.vertices[0], data.vertices.size(), data.indices, submeshIndexCounts, levelIndexCounts);
+	submeshes.clear();
+	for (size_t i = 0; i < lods.size(); i++)
+	{
+		unsigned int start = lods[i].startIndex;
+		for (UINT s = 0; s < submeshCount; s++)
+		{
+			ObjSubmesh submesh = { start, levelIndexCounts[i * submeshCount + s], data.submeshes[s].material };
+			if (i > 0 && submesh.indexCount > 0)
+				OptimizeVertexCache(&data.indices[start], submesh.indexCount, data.vertices.size());
+			submeshes.push_back(submesh);
+			start += submesh.indexCount;
+		}
+	}
+	materials = data.materials;
+	data.vertices.resize(OptimizeVertexFetch(&data.vertices[0], data.vertices.size(), sizeof(Vertex), &data.indices[0], data.indices.size()));
+
+#if defined(DEBUG) || defined(_DEBUG)
+	VertexCacheStats after = AnalyzeVertexCache(&data.indices[0], lods[0].indexCount, data.vertices.size());
+	printf("  Vertex cache: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n", before.acmr, after.acmr, before.atvr, after.atvr);
+	for (size_t i = 0; i < lods.size(); i++)
+		printf("  LOD %u: %u triangles, error %g\n", (unsigned int)i, lods[i].indexCount / 3, lods[i].error);
+	printf("  %u meshlets, %u submeshes\n", (unsigned int)meshlets.size(), submeshCount);
+#endif
+}
+
+// --------------------------------------------------------
+// Creates the (immutable) vertex and index buffers
+// - Returns false if either couldn't be created
+// --------------------------------------------------------
+bool Mesh::CreateBuffers(const Vertex* vertices, int numVertices, const unsigned int* indices, int numIndex, ID3D11Device* device, unsigned int threadCount)
+{
+	// Full vertices are uploaded as-is, and need no unpacking
+	const void* vertexData = vertices;
+	vertexStride = sizeof(Vertex);
+	positionScale = XMFLOAT3(1, 1, 1);
+	positionOffset = XMFLOAT3(0, 0, 0);
+
+	// Compact vertices store positions relative to the bounds,
+	// so the shader gets the bounds back as a scale and offset
+	std::vector<CompactVertex> compact;
+	if (vertexFormat == VertexFormat::Compact)
+	{
+		XMFLOAT3 boundsMin, boundsMax;
+		ComputeBounds(vertices, numVertices, boundsMin, boundsMax);
+
+		compact.resize(numVertices);
+		CompressVertices(vertices, numVertices, boundsMin, boundsMax, &compact[0]);
+
+		vertexData = &compact[0];
+		vertexStride = sizeof(CompactVertex);
+		positionScale = XMFLOAT3(boundsMax.x - boundsMin.x, boundsMax.y - boundsMin.y, boundsMax.z - boundsMin.z);
+		positionOffset = boundsMin;
+	}
+
+	// Tangent frames come from LOD 0 only - the simplified levels
+	// reuse the same vertices and would just count twice.  Seams
+	// between mirrored UVs split vertices, so the uploaded vertices
+	// and indices are the generator's rewritten copies
+	std::vector<TangentVertex> withTangents;
+	std::vector<Vertex> splitVertices;
+	std::vector<unsigned int> splitIndices;
+	if (vertexFormat == VertexFormat::Tangent)
+	{
+		splitVertices.assign(vertices, vertices + numVertices);
+		splitIndices.assign(indices, indices + numIndex);
+		std::vector<XMFLOAT4> tangents;
+		size_t tangentIndices = lods.empty() ? (size_t)numIndex : lods[0].indexCount;
+		GenerateTangents(splitVertices, splitIndices, tangentIndices, tangents, threadCount);
+
+		vertices = &splitVertices[0];
+		numVertices = (int)splitVertices.size();
+		indices = &splitIndices[0];
+
+		withTangents.resize(numVertices);
+		for (int i = 0; i < numVertices; i++)
+		{
+			withTangents[i].Position = vertices[i].Position;
+			withTangents[i].Normal = vertices[i].Normal;
+			withTangents[i].UV = vertices[i].UV;
+			withTangents[i].Tangent = tangents[i];
+		}
+
+		vertexData = &withTangents[0];
+		vertexStride = sizeof(TangentVertex);
+	}
+
+	D3D11_BUFFER_DESC vbd;
+	vbd.Usage = D3D11_USAGE_IMMUTABLE;
+	vbd.ByteWidth = vertexStride * numVertices;       // number of vertices in the buffer
+	vbd.BindFlags = D3D11_BIND_VERTEX_BUFFER; // Tells DirectX this is a vertex buffer
+	vbd.CPUAccessFlags = 0;
+	vbd.MiscFlags = 0;
+	vbd.StructureByteStride = 0;
+
+	D3D11_SUBRESOURCE_DATA initialVertexData;
+	initialVertexData.pSysMem = vertexData;
+
+	if (FAILED(device->CreateBuffer(&vbd, &initialVertexData, &vBuffer)))
+		return false;
+
+	// Use 16-bit indices whenever every vertex is reachable with
+	// one - that's half the index memory and bandwidth
+	const void* indexData = indices;
+	UINT indexSize = sizeof(unsigned int);
+	indexFormat = DXGI_FORMAT_R32_UINT;
+
+	std::vector<unsigned short> shortIndices;
+	if (numVertices <= 65536)
+	{
+		shortIndices.assign(indices, indices + numIndex);
+		indexData = &shortIndices[0];
+		indexSize = sizeof(unsigned short);
+		indexFormat = DXGI_FORMAT_R16_UINT;
+	}
+
+	D3D11_BUFFER_DESC ibd;
+	ibd.Usage = D3D11_USAGE_IMMUTABLE;
+	ibd.ByteWidth = indexSize * numIndex;         // number of indices in the buffer
+	ibd.BindFlags = D3D11_BIND_INDEX_BUFFER; // Tells DirectX this is an index buffer
+	ibd.CPUAccessFlags = 0;
+	ibd.MiscFlags = 0;
+	ibd.StructureByteStride = 0;
+
+	D3D11_SUBRESOURCE_DATA initialIndexData;
+	initialIndexData.pSysMem = indexData;
+
+	if (FAILED(device->CreateBuffer(&ibd, &initialIndexData, &iBuffer)))
+		return false;
+	residentBytes = vbd.ByteWidth + ibd.ByteWidth;
+	this->numVertices = numVertices;
+	totalIndices = numIndex;
+
+	// Meshes without a LOD chain just have the one level, and
+	// meshes without materials are one plain white submesh
+	if (lods.empty())
+	{
+		MeshLod full = { 0, (unsigned int)numIndex, 0.0f };
+		lods.push_back(full);
+	}
+	if (materials.empty())
+	{
+		ObjMaterial material;
+		InitObjMaterial(material, "");
+		materials.push_back(material);
+	}
+	if (submeshes.empty())
+	{
+		submeshCount = 1;
+		for (size_t i = 0; i < lods.size(); i++)
+		{
+			ObjSubmesh whole = { lods[i].startIndex, lods[i].indexCount, 0 };
+			submeshes.push_back(whole);
+		}
+	}
+	numIndices = (int)lods[0].indexCount;
+	return true;
+}
+
+Mesh::~Mesh()
+{
+	if (pool) { pool->Remove(this); }
+	if (vBuffer) { vBuffer->Release(); }
+	if (iBuffer) { iBuffer->Release(); }
+}
+
+MeshState Mesh::GetState()
+{
+	return state;
+}
+
+// --------------------------------------------------------
+// True once the buffers exist and everything else about the
+// mesh can be used (from any thread)
+// --------------------------------------------------------
+bool Mesh::IsReady()
+{
+	return state == MeshState::Ready;
+}
+
+// --------------------------------------------------------
+// The buffers to draw from - the pool's, for pooled meshes
+// --------------------------------------------------------
+ID3D11Buffer* Mesh::GetVertexBuffer()
+{
+	return pool ? pool->GetVertexBuffer() : vBuffer;
+}
+
+ID3D11Buffer* Mesh::GetIndexBuffer()
+{
+	return pool ? pool->GetIndexBuffer() : iBuffer;
+}
+
+// --------------------------------------------------------
+// Where the mesh starts in its buffers - add these to the
+// StartIndexLocation / BaseVertexLocation of every draw
+// --------------------------------------------------------
+UINT Mesh::GetBaseVertex()
+{
+	return baseVertex;
+}
+
+UINT Mesh::GetStartIndex()
+{
+	return startIndex;
+}
+
+bool Mesh::IsPooled()
+{
+	return pool != 0;
+}
+
+int Mesh::GetIndexCount()
+{
+	return numIndices;
+}
+
+// --------------------------------------------------------
+// Format to pass to IASetIndexBuffer along with GetIndexBuffer()
+// --------------------------------------------------------
+DXGI_FORMAT Mesh::GetIndexFormat()
+{
+	return indexFormat;
+}
+
+VertexFormat Mesh::GetVertexFormat()
+{
+	return vertexFormat;
+}
+
+UINT Mesh::GetVertexStride()
+{
+	return vertexStride;
+}
+
+// --------------------------------------------------------
+// GPU memory used by the vertex and index buffers
+// --------------------------------------------------------
+UINT Mesh::GetResidentBytes()
+{
+	return residentBytes;
+}
+
+XMFLOAT3 Mesh::GetPositionScale()
+{
+	return positionScale;
+}
+
+XMFLOAT3 Mesh::GetPositionOffset()
+{
+	return positionOffset;
+}
+
+int Mesh::GetLodCount()
+{
+	return (int)lods.size();
+}
+
+// --------------------------------------------------------
+// Gets a level of detail - draw it with
+// DrawIndexed(lod.indexCount, lod.startIndex, 0)
+// --------------------------------------------------------
+const MeshLod& Mesh::GetLod(int level)
+{
+	return lods[level];
+}
+
+// --------------------------------------------------------
+// Picks the coarsest LOD whose error is still invisible
+// - distance is from the camera, in the mesh's own units
+// - errorPerUnitDistance is how big an error may be at a
+//    distance of 1 (e.g. the size of one pixel there)
+// --------------------------------------------------------
+int Mesh::SelectLod(float distance, float errorPerUnitDistance)
+{
+	float allowed = distance * errorPerUnitDistance;
+	int level = 0;
+	while (level + 1 < (int)lods.size() && lods[level + 1].error <= allowed)
+		level++;
+	return level;
+}
+
+int Mesh::GetMeshletCount()
+{
+	return (int)meshlets.size();
+}
+
+// --------------------------------------------------------
+// Gets a meshlet - a range of LOD 0 with culling bounds in
+// the mesh's own space
+// --------------------------------------------------------
+const Meshlet& Mesh::GetMeshlet(int index)
+{
+	return meshlets[index];
+}
+
+// --------------------------------------------------------
+// Submeshes are the parts of a LOD with different materials,
+// back to back in the index buffer (and in the same order at
+// every LOD) - draw each with
+// DrawIndexed(submesh.indexCount, submesh.startIndex, 0)
+// --------------------------------------------------------
+int Mesh::GetSubmeshCount()
+{
+	return (int)submeshCount;
+}
+
+const ObjSubmesh& Mesh::GetSubmesh(int index, int level)
+{
+	return submeshes[level * submeshCount + index];
+}
+
+int Mesh::GetMaterialCount()
+{
+	return (int)materials.size();
+}
+
+// --------------------------------------------------------
+// Gets a material - submesh.material indexes these
+// --------------------------------------------------------
+const ObjMaterial& Mesh::GetMaterial(int index)
+{
+	return materials[index];
+}
+
+// --------------------------------------------------------
+// Creates an input layout for the given vertex format that
+// matches VertexShader.hlsl (which takes any of them)
+// - Compact vertices are unpacked by the input assembler
+//    (unorm16 / snorm16 / half float -> float), then by the
+//    shader (bounds and octahedral normals)
+// - Tangent vertices add a TANGENT, which shaders that don't
+//    read it just ignore
+// --------------------------------------------------------
+HRESULT Mesh::CreateInputLayout(VertexFormat format, const void* shaderBytecode, size_t bytecodeLength, ID3D11Device* device, ID3D11InputLayout** inputLayout)
+{
+	if (format == VertexFormat::Compact)
+	{
+		D3D11_INPUT_ELEMENT_DESC compactDesc[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, 8, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		};
+		return device->CreateInputLayout(compactDesc, 3, shaderBytecode, bytecodeLength, inputLayout);
+	}
+
+	if (format == VertexFormat::Tangent)
+	{
+		D3D11_INPUT_ELEMENT_DESC tangentDesc[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "TANGENT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 32, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		};
+		return device->CreateInputLayout(tangentDesc, 4, shaderBytecode, bytecodeLength, inputLayout);
+	}
+
+	D3D11_INPUT_ELEMENT_DESC fullDesc[] =
+	{
+		{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+	};
+	return device->CreateInputLayout(fullDesc, 3, shaderBytecode, bytecodeLength, inputLayout);
+}
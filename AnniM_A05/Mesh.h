@@ -1,23 +1,90 @@
-#pragma once
-
-#include <d3d11.h>
-#include <DirectXMath.h>
-#include "Vertex.h"
-#include <iostream>
-#include <fstream>
-#include <vector>
-
-class Mesh
-{
-	ID3D11Buffer* vBuffer;
-	ID3D11Buffer* iBuffer;
-	int numIndices;
-public:
-	Mesh(Vertex* vertices, int numVertices, unsigned int* indices, int numIndex, ID3D11Device* device);
-	Mesh(const char*, ID3D11Device* device);
-	~Mesh();
-	ID3D11Buffer* GetVertexBuffer();
-	ID3D11Buffer* GetIndexBuffer();
-	int GetIndexCount();
-};
-
+#pragma once
+
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include "Vertex.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
+#include "ObjParser.h"
+#include <vector>
+#include <atomic>
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// Meshes handed out by MeshLoader start out Loading, and must
+// not be drawn until they're Ready
+// --------------------------------------------------------
+enum class MeshState { Loading, Ready, Failed };
+
+class GeometryPool;
+
+class Mesh
+{
+	friend class MeshLoader;
+	friend class GeometryPool;
+
+	std::atomic<MeshState> state;
+	ID3D11Buffer* vBuffer;
+	ID3D11Buffer* iBuffer;
+	int numIndices;
+	DXGI_FORMAT indexFormat;	// R16_UINT when the mesh is small enough, else R32_UINT
+	VertexFormat vertexFormat;
+	UINT vertexStride;
+	UINT residentBytes;			// Size of both buffers together
+	UINT numVertices;
+	UINT totalIndices;			// Indices of every LOD
+	GeometryPool* pool;			// Set when the geometry lives in a pool,
+	UINT baseVertex;			// at these offsets (0 otherwise)
+	UINT startIndex;
+	XMFLOAT3 positionScale;		// How the shader unpacks compact positions
+	XMFLOAT3 positionOffset;
+	std::vector<MeshLod> lods;	// Index ranges, from full detail to coarsest
+	std::vector<Meshlet> meshlets;	// Clusters covering LOD 0 (optimized meshes only)
+	std::vector<ObjSubmesh> submeshes;	// submeshCount ranges for each LOD
+	std::vector<ObjMaterial> materials;
+	UINT submeshCount;
+	void Initialize(VertexFormat format);
+	bool LoadObj(const char* file, ID3D11Device* device, unsigned int threadCount);
+	void Optimize(ObjMeshData& data);
+	bool CreateBuffers(const Vertex* vertices, int numVertices, const unsigned int* indices, int numIndex, ID3D11Device* device, unsigned int threadCount = 0);
+
+	// An empty mesh, filled in later by LoadObj (see MeshLoader)
+	Mesh(VertexFormat format);
+public:
+	// format - layout uploaded to the GPU (Compact is half the size,
+	//    Tangent adds tangent frames for normal mapping)
+	// threadCount - threads used to parse the file and generate
+	//    tangents (0 = one per hardware thread)
+	// optimize - false for geometry that was optimized already
+	//    (it then gets no LODs or meshlets either)
+	Mesh(Vertex* vertices, int numVertices, unsigned int* indices, int numIndex, ID3D11Device* device, VertexFormat format = VertexFormat::Full, bool optimize = true);
+	Mesh(const char*, ID3D11Device* device, VertexFormat format = VertexFormat::Full, unsigned int threadCount = 0);
+	~Mesh();
+	MeshState GetState();
+	bool IsReady();
+	ID3D11Buffer* GetVertexBuffer();
+	ID3D11Buffer* GetIndexBuffer();
+	int GetIndexCount();
+	DXGI_FORMAT GetIndexFormat();
+	VertexFormat GetVertexFormat();
+	UINT GetVertexStride();
+	UINT GetResidentBytes();
+	UINT GetBaseVertex();
+	UINT GetStartIndex();
+	bool IsPooled();
+	XMFLOAT3 GetPositionScale();
+	XMFLOAT3 GetPositionOffset();
+	int GetLodCount();
+	const MeshLod& GetLod(int level);
+	int SelectLod(float distance, float errorPerUnitDistance);
+	int GetMeshletCount();
+	const Meshlet& GetMeshlet(int index);
+	int GetSubmeshCount();
+	const ObjSubmesh& GetSubmesh(int index, int level = 0);
+	int GetMaterialCount();
+	const ObjMaterial& GetMaterial(int index);
+
+	static HRESULT CreateInputLayout(VertexFormat format, const void* shaderBytecode, size_t bytecodeLength, ID3D11Device* device, ID3D11InputLayout** inputLayout);
+};
+
@@ -0,0 +1,400 @@
+#include "MeshCache.h"
+#include "VertexCompression.h"
+#include "MeshCodec.h"
+#include <cstdio>
+#include <cstring>
+#include <atomic>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+static const char MeshCacheMagic[4] = { 'M', 'S', 'H', 'C' };
+
+bool GetSourceInfo(const char* file, uint64_t& size, int64_t& modifiedTime)
+{
+#ifdef _WIN32
+	struct _stat64 info;
+	if (_stat64(file, &info) != 0)
+		return false;
+#else
+	struct stat info;
+	if (stat(file, &info) != 0)
+		return false;
+#endif
+	size = (uint64_t)info.st_size;
+	modifiedTime = (int64_t)info.st_mtime;
+	return true;
+}
+
+// --------------------------------------------------------
+// 64-bit FNV-1a style hash, 8 bytes at a time
+// - Not cryptographic, just good at noticing edited files
+// --------------------------------------------------------
+uint64_t HashBytes(const void* data, size_t size)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	uint64_t hash = 14695981039346656037ull;
+	const uint64_t prime = 1099511628211ull;
+
+	size_t i = 0;
+	for (; i + 8 <= size; i += 8)
+	{
+		uint64_t word;
+		memcpy(&word, bytes + i, 8);
+		hash = (hash ^ word) * prime;
+		hash ^= hash >> 29;
+	}
+	for (; i < size; i++)
+		hash = (hash ^ bytes[i]) * prime;
+
+	return hash ^ size;
+}
+
+// --------------------------------------------------------
+// Combined hash of the contents of the material libraries
+// - Missing libraries count too, so one showing up later
+//    makes the cache stale
+// --------------------------------------------------------
+static uint64_t HashMaterialLibraries(const char* sourceFile, const std::vector<std::string>& libraries)
+{
+	uint64_t hash = 0;
+	for (size_t i = 0; i < libraries.size(); i++)
+	{
+		MappedFile library(GetObjRelativePath(sourceFile, libraries[i]).c_str());
+		uint64_t libraryHash = library.GetData() ? HashBytes(library.GetData(), library.GetSize()) : 0;
+		hash = (hash ^ libraryHash) * 1099511628211ull + i;
+	}
+	return hash;
+}
+
+std::string GetMeshCachePath(const char* sourceFile)
+{
+	return std::string(sourceFile) + ".meshcache";
+}
+
+MeshCacheView::MeshCacheView()
+{
+	file = 0;
+	header = 0;
+	Close();
+}
+
+MeshCacheView::~MeshCacheView()
+{
+	delete file;
+}
+
+void MeshCacheView::Close()
+{
+	delete file;
+	file = 0;
+	header = 0;
+	vertices = 0;
+	indices = 0;
+	lods = 0;
+	meshlets = 0;
+	submeshes = 0;
+	materials = 0;
+	decodedVertices.clear();
+	decodedIndices.clear();
+}
+
+bool MeshCacheView::Open(const char* sourceFile)
+{
+	Close();
+
+	uint64_t sourceSize;
+	int64_t sourceTime;
+	if (!GetSourceInfo(sourceFile, sourceSize, sourceTime))
+		return false;
+
+	MappedFile* cache = new MappedFile(GetMeshCachePath(sourceFile).c_str());
+	if (!cache->GetData() || cache->GetSize() < sizeof(MeshCacheHeader))
+	{
+		delete cache;
+		return false;
+	}
+
+	// Is this a cache we know how to read, with the data it claims to have?
+	const MeshCacheHeader* h = (const MeshCacheHeader*)cache->GetData();
+	bool compressed = (h->flags & MeshCacheCompressed) != 0;
+
+	// One submesh per LOD per material range - in 64 bits, so a
+	// damaged header can't wrap it round to something small
+	uint64_t submeshEntries = (uint64_t)h->lodCount * h->submeshCount;
+	bool valid =
+		memcmp(h->magic, MeshCacheMagic, sizeof(MeshCacheMagic)) == 0 &&
+		h->version == MeshCacheVersion &&
+		h->vertexStride == sizeof(Vertex) &&
+		h->indexStride == sizeof(unsigned int) &&
+		h->vertexCount > 0 &&
+		h->indexCount > 0 &&
+		h->lodCount > 0 &&
+		h->submeshCount > 0 &&
+		h->vertexBytes % 4 == 0 &&
+		h->indexBytes % 4 == 0 &&
+		submeshEntries <= cache->GetSize() &&
+		(compressed || (
+			h->vertexBytes == (uint64_t)h->vertexCount * sizeof(Vertex) &&
+			h->indexBytes == (uint64_t)h->indexCount * sizeof(unsigned int))) &&
+		cache->GetSize() == sizeof(MeshCacheHeader) +
+			(uint64_t)h->vertexBytes +
+			(uint64_t)h->indexBytes +
+			(uint64_t)h->lodCount * sizeof(MeshLod) +
+			(uint64_t)h->meshletCount * sizeof(Meshlet) +
+			submeshEntries * sizeof(ObjSubmesh) +
+			(uint64_t)h->materialCount * sizeof(ObjMaterial) +
+			h->materialLibraryBytes;
+
+	// Every LOD, meshlet and submesh has to be a whole number of
+	// triangles inside the indices (with a material that exists)
+	const unsigned char* vertexData = (const unsigned char*)(h + 1);
+	const unsigned char* indexData = vertexData + h->vertexBytes;
+	const MeshLod* lodTable = (const MeshLod*)(indexData + h->indexBytes);
+	const Meshlet* meshletTable = (const Meshlet*)(lodTable + h->lodCount);
+	const ObjSubmesh* submeshTable = (const ObjSubmesh*)(meshletTable + h->meshletCount);
+	const ObjMaterial* materialTable = (const ObjMaterial*)(submeshTable + submeshEntries);
+	const char* libraries = (const char*)(materialTable + h->materialCount);
+	if (valid)
+	{
+		for (uint32_t i = 0; i < h->lodCount && valid; i++)
+		{
+			valid = lodTable[i].indexCount % 3 == 0 &&
+				lodTable[i].startIndex <= h->indexCount &&
+				lodTable[i].indexCount <= h->indexCount - lodTable[i].startIndex;
+		}
+
+		for (uint32_t i = 0; i < h->meshletCount && valid; i++)
+		{
+			valid = meshletTable[i].indexCount % 3 == 0 &&
+				meshletTable[i].startIndex <= h->indexCount &&
+				meshletTable[i].indexCount <= h->indexCount - meshletTable[i].startIndex;
+		}
+
+		for (uint64_t i = 0; i < submeshEntries && valid; i++)
+		{
+			valid = submeshTable[i].indexCount % 3 == 0 &&
+				submeshTable[i].startIndex <= h->indexCount &&
+				submeshTable[i].indexCount <= h->indexCount - submeshTable[i].startIndex &&
+				submeshTable[i].material < h->materialCount;
+		}
+
+		// The library names have to end with a terminator
+		valid = valid && (h->materialLibraryBytes == 0 || libraries[h->materialLibraryBytes - 1] == 0);
+	}
+
+	// Is it still up to date?
+	// - A timestamp match is trusted (the fast, common case)
+	// - A timestamp change alone (a fresh checkout, for instance)
+	//    falls back to comparing the contents
+	if (valid)
+		valid = h->sourceSize == sourceSize;
+	if (valid && h->sourceModifiedTime != sourceTime)
+	{
+		MappedFile source(sourceFile);
+		valid = source.GetData() && HashBytes(source.GetData(), source.GetSize()) == h->sourceHash;
+	}
+
+	// The material libraries are small, so they're always hashed
+	if (valid)
+	{
+		std::vector<std::string> names;
+		for (const char* name = libraries; name < libraries + h->materialLibraryBytes; name += strlen(name) + 1)
+			names.push_back(name);
+		valid = HashMaterialLibraries(sourceFile, names) == h->materialHash;
+	}
+
+	// Only a cache that's going to be used is worth decoding
+	const Vertex* vertexArray = (const Vertex*)vertexData;
+	const unsigned int* indexArray = (const unsigned int*)indexData;
+	if (valid && compressed)
+	{
+		decodedVertices.resize(h->vertexCount);
+		decodedIndices.resize(h->indexCount);
+		valid =
+			DecodeMeshStream(&decodedVertices[0], h->vertexCount, sizeof(Vertex), vertexData, h->vertexBytes) &&
+			DecodeIndexStream(&decodedIndices[0], h->indexCount, indexData, h->indexBytes);
+		vertexArray = &decodedVertices[0];
+		indexArray = &decodedIndices[0];
+	}
+
+	// A damaged cache mustn't index past the vertices, decoded or not
+	for (uint32_t i = 0; i < h->indexCount && valid; i++)
+		valid = indexArray[i] < h->vertexCount;
+
+	if (!valid)
+	{
+		delete cache;
+		Close();
+		return false;
+	}
+
+	file = cache;
+	header = h;
+	vertices = vertexArray;
+	indices = indexArray;
+	lods = lodTable;
+	meshlets = meshletTable;
+	submeshes = submeshTable;
+	materials = materialTable;
+	return true;
+}
+
+const MeshCacheHeader* MeshCacheView::GetHeader()
+{
+	return header;
+}
+
+const Vertex* MeshCacheView::GetVertices()
+{
+	return vertices;
+}
+
+const unsigned int* MeshCacheView::GetIndices()
+{
+	return indices;
+}
+
+const MeshLod* MeshCacheView::GetLods()
+{
+	return lods;
+}
+
+const Meshlet* MeshCacheView::GetMeshlets()
+{
+	return meshlets;
+}
+
+const ObjSubmesh* MeshCacheView::GetSubmeshes()
+{
+	return submeshes;
+}
+
+const ObjMaterial* MeshCacheView::GetMaterials()
+{
+	return materials;
+}
+
+// --------------------------------------------------------
+// Pads encoded data to a multiple of 4 bytes
+// --------------------------------------------------------
+static void PadToFour(std::vector<unsigned char>& data)
+{
+	while (data.size() % 4 != 0)
+		data.push_back(0);
+}
+
+bool WriteMeshCache(
+	const char* sourceFile,
+	const ObjMeshData& mesh,
+	const std::vector<MeshLod>& lods,
+	const std::vector<Meshlet>& meshlets,
+	const std::vector<ObjSubmesh>& submeshes,
+	bool compress)
+{
+	if (mesh.vertices.empty() || mesh.indices.empty() || lods.empty() || mesh.submeshes.empty() ||
+		submeshes.size() != lods.size() * mesh.submeshes.size())
+		return false;
+
+	// Library names, back to back with their terminators
+	std::string libraries;
+	for (size_t i = 0; i < mesh.materialLibraries.size(); i++)
+		libraries.append(mesh.materialLibraries[i].c_str(), mesh.materialLibraries[i].size() + 1);
+
+	MeshCacheHeader header = {};
+	memcpy(header.magic, MeshCacheMagic, sizeof(MeshCacheMagic));
+	header.version = MeshCacheVersion;
+	header.vertexStride = sizeof(Vertex);
+	header.indexStride = sizeof(unsigned int);
+	header.vertexCount = (uint32_t)mesh.vertices.size();
+	header.indexCount = (uint32_t)mesh.indices.size();
+	header.lodCount = (uint32_t)lods.size();
+	header.meshletCount = (uint32_t)meshlets.size();
+	header.submeshCount = (uint32_t)mesh.submeshes.size();
+	header.materialCount = (uint32_t)mesh.materials.size();
+	header.materialLibraryBytes = (uint32_t)libraries.size();
+	header.materialHash = HashMaterialLibraries(sourceFile, mesh.materialLibraries);
+
+	// The vertex and index data, either raw or encoded
+	std::vector<unsigned char> encodedVertices, encodedIndices;
+	const void* vertexData = &mesh.vertices[0];
+	const void* indexData = &mesh.indices[0];
+	header.vertexBytes = (uint32_t)(mesh.vertices.size() * sizeof(Vertex));
+	header.indexBytes = (uint32_t)(mesh.indices.size() * sizeof(unsigned int));
+	if (compress)
+	{
+		EncodeMeshStream(&mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex), encodedVertices);
+		EncodeIndexStream(&mesh.indices[0], mesh.indices.size(), encodedIndices);
+		PadToFour(encodedVertices);
+		PadToFour(encodedIndices);
+
+		header.flags = MeshCacheCompressed;
+		vertexData = &encodedVertices[0];
+		indexData = &encodedIndices[0];
+		header.vertexBytes = (uint32_t)encodedVertices.size();
+		header.indexBytes = (uint32_t)encodedIndices.size();
+	}
+
+	// Identify the exact source this was built from
+	{
+		MappedFile source(sourceFile);
+		if (!source.GetData())
+			return false;
+		header.sourceHash = HashBytes(source.GetData(), source.GetSize());
+	}
+	if (!GetSourceInfo(sourceFile, header.sourceSize, header.sourceModifiedTime))
+		return false;
+
+	// Bounds of the (already left-handed) vertices
+	ComputeBounds(&mesh.vertices[0], mesh.vertices.size(), header.boundsMin, header.boundsMax);
+
+	// Write to a temporary file first and then swap it in, so
+	// another process never maps a half-written cache
+	// - The counter keeps loader threads in the same process
+	//    from sharing a temporary file
+	static std::atomic<unsigned int> tempCounter(0);
+	std::string path = GetMeshCachePath(sourceFile);
+	char suffix[48];
+	snprintf(suffix, sizeof(suffix), ".%d.%u.tmp", (int)getpid(), tempCounter++);
+	std::string tempPath = path + suffix;
+
+	FILE* out = 0;
+#ifdef _WIN32
+	if (fopen_s(&out, tempPath.c_str(), "wb") != 0)
+		out = 0;
+#else
+	out = fopen(tempPath.c_str(), "wb");
+#endif
+	if (!out)
+		return false;
+
+	bool written =
+		fwrite(&header, sizeof(header), 1, out) == 1 &&
+		fwrite(vertexData, 1, header.vertexBytes, out) == header.vertexBytes &&
+		fwrite(indexData, 1, header.indexBytes, out) == header.indexBytes &&
+		fwrite(&lods[0], sizeof(MeshLod), lods.size(), out) == lods.size() &&
+		(meshlets.empty() || fwrite(&meshlets[0], sizeof(Meshlet), meshlets.size(), out) == meshlets.size()) &&
+		fwrite(&submeshes[0], sizeof(ObjSubmesh), submeshes.size(), out) == submeshes.size() &&
+		(mesh.materials.empty() || fwrite(&mesh.materials[0], sizeof(ObjMaterial), mesh.materials.size(), out) == mesh.materials.size()) &&
+		(libraries.empty() || fwrite(libraries.data(), 1, libraries.size(), out) == libraries.size());
+	written = fclose(out) == 0 && written;
+
+#ifdef _WIN32
+	if (written)
+		written = MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	if (written)
+		written = rename(tempPath.c_str(), path.c_str()) == 0;
+#endif
+
+	if (!written)
+		remove(tempPath.c_str());
+	return written;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <string>
+#include "Vertex.h"
+#include "MappedFile.h"
+#include "ObjParser.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
+
+// --------------------------------------------------------
+// Binary mesh cache
+//
+// After an OBJ file is parsed, its welded vertices and indices
+// are written next to it (as "<file>.meshcache") exactly as
+// they'll be uploaded.  Later loads just map that file and hand
+// the pointers to CreateBuffer.
+//
+// Compressed caches (MeshCacheCompressed) store the vertices
+// and indices with MeshCodec instead, which takes much less
+// disk space and decodes faster than the raw bytes can be read
+// from disk; they're decoded once, when the cache is opened.
+//
+// Layout: MeshCacheHeader, then vertexCount Vertex structs,
+// then indexCount 32-bit indices (every LOD) - or vertexBytes
+// and indexBytes of encoded data when compressed - then lodCount
+// MeshLod ranges into those indices, then meshletCount Meshlets
+// covering LOD 0, then submeshCount ObjSubmesh ranges for each
+// LOD, then materialCount ObjMaterials, then the names of the
+// material libraries (materialLibraryBytes, each one null
+// terminated).  The libraries are hashed too, so editing just
+// the .mtl file also makes the cache stale.
+// --------------------------------------------------------
+struct MeshCacheHeader
+{
+	char magic[4];					// "MSHC"
+	uint32_t version;				// MeshCacheVersion when written
+	uint32_t vertexStride;			// sizeof(Vertex) when written
+	uint32_t indexStride;			// sizeof(unsigned int) when written
+	uint64_t sourceSize;			// Size of the OBJ file in bytes
+	int64_t sourceModifiedTime;		// Last write time of the OBJ file
+	uint64_t sourceHash;			// Hash of the OBJ file's contents
+	uint32_t vertexCount;
+	uint32_t indexCount;			// Indices of all LODs together
+	uint32_t lodCount;
+	uint32_t meshletCount;
+	uint32_t submeshCount;			// Per LOD
+	uint32_t materialCount;
+	uint32_t materialLibraryBytes;
+	uint32_t flags;					// MeshCacheCompressed, or 0
+	uint32_t vertexBytes;			// Size of the vertex data in the file
+	uint32_t indexBytes;			// Size of the index data in the file
+	uint64_t materialHash;			// Hash of the material libraries' contents
+	DirectX::XMFLOAT3 boundsMin;	// Axis-aligned bounds of the vertices
+	DirectX::XMFLOAT3 boundsMax;
+};
+
+// Bump this whenever the layout above (or the parser's output) changes
+static const uint32_t MeshCacheVersion = 7;
+
+// Vertices and indices are encoded with MeshCodec (each padded
+// to a multiple of 4 bytes, so everything after stays aligned)
+static const uint32_t MeshCacheCompressed = 1;
+
+// --------------------------------------------------------
+// A validated, memory-mapped cache file
+// - Open() fails (and the caller should parse the OBJ) if the
+//    cache is missing, from another version, or stale.  A cache
+//    is stale if the source's size changed, or its timestamp
+//    changed AND its contents hash differently.
+// - Everything is read straight from the mapped file, except
+//    the vertices and indices of compressed caches
+// --------------------------------------------------------
+class MeshCacheView
+{
+	MappedFile* file;
+	const MeshCacheHeader* header;
+	const Vertex* vertices;
+	const unsigned int* indices;
+	const MeshLod* lods;
+	const Meshlet* meshlets;
+	const ObjSubmesh* submeshes;
+	const ObjMaterial* materials;
+	std::vector<Vertex> decodedVertices;		// Only used when compressed
+	std::vector<unsigned int> decodedIndices;
+	void Close();
+public:
+	MeshCacheView();
+	~MeshCacheView();
+	bool Open(const char* sourceFile);
+	const MeshCacheHeader* GetHeader();
+	const Vertex* GetVertices();
+	const unsigned int* GetIndices();
+	const MeshLod* GetLods();
+	const Meshlet* GetMeshlets();
+	const ObjSubmesh* GetSubmeshes();
+	const ObjMaterial* GetMaterials();
+
+	MeshCacheView(const MeshCacheView&) = delete;
+	MeshCacheView& operator=(const MeshCacheView&) = delete;
+};
+
+// --------------------------------------------------------
+// Writes the cache for the given source file
+// - Returns false (and leaves no partial file) on failure,
+//    e.g. when the source lives in a read-only folder
+// - Safe to call from several threads at once
+// - "submeshes" has mesh.submeshes.size() ranges for each LOD
+// - "compress" writes a compressed cache (see above)
+// --------------------------------------------------------
+bool WriteMeshCache(
+	const char* sourceFile,
+	const ObjMeshData& mesh,
+	const std::vector<MeshLod>& lods,
+	const std::vector<Meshlet>& meshlets,
+	const std::vector<ObjSubmesh>& submeshes,
+	bool compress = true);
+
+// Path of the cache file used for the given source file
+std::string GetMeshCachePath(const char* sourceFile);
+
+// Hash used to detect content changes in source files
+uint64_t HashBytes(const void* data, size_t size);
+
+// Size and last write time of a file (false if it's missing)
+bool GetSourceInfo(const char* file, uint64_t& size, int64_t& modifiedTime);
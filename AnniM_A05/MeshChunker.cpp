@@ -0,0 +1,565 @@
+#include "MeshChunker.h"
+#include "MeshCache.h"
+#include "MeshCodec.h"
+#include "MeshOptimizer.h"
+#include "MappedFile.h"
+#include "ObjParser.h"
+#include "VertexCompression.h"
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+using namespace DirectX;
+
+static const char MeshChunkMagic[4] = { 'M', 'C', 'H', 'K' };
+
+// Cells in the sorting grid, at most (each holds a block in memory)
+static const uint64_t MaxGridCells = 4096;
+
+// Triangles a cell collects before writing them out as a block
+static const size_t BlockTriangles = 512;
+
+static FILE* OpenFile(const char* path, const char* mode)
+{
+	FILE* file = 0;
+#ifdef _WIN32
+	if (fopen_s(&file, path, mode) != 0)
+		file = 0;
+#else
+	file = fopen(path, mode);
+#endif
+	return file;
+}
+
+// 64-bit seek from the start of the file
+static bool SeekFile(FILE* file, uint64_t offset)
+{
+#ifdef _WIN32
+	return _fseeki64(file, (long long)offset, SEEK_SET) == 0;
+#else
+	return fseeko(file, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+static bool ReplaceFile(const std::string& from, const std::string& to)
+{
+#ifdef _WIN32
+	return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	return rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+// --------------------------------------------------------
+// The temporary files of one build - whatever's left open or
+// on disk is cleaned up when this goes out of scope
+// --------------------------------------------------------
+struct ChunkBuildFiles
+{
+	std::string positionsPath;
+	std::string uvsPath;
+	std::string normalsPath;
+	std::string bucketsPath;
+	std::string outputPath;
+	FILE* positions;
+	FILE* uvs;
+	FILE* normals;
+	FILE* buckets;
+	FILE* output;
+
+	ChunkBuildFiles(const std::string& base)
+	{
+		positionsPath = base + ".positions.tmp";
+		uvsPath = base + ".uvs.tmp";
+		normalsPath = base + ".normals.tmp";
+		bucketsPath = base + ".buckets.tmp";
+		outputPath = base + ".tmp";
+		positions = uvs = normals = buckets = output = 0;
+	}
+
+	~ChunkBuildFiles()
+	{
+		FILE* files[] = { positions, uvs, normals, buckets, output };
+		for (FILE* file : files)
+			if (file) fclose(file);
+
+		const std::string* paths[] = { &positionsPath, &uvsPath, &normalsPath, &bucketsPath, &outputPath };
+		for (const std::string* path : paths)
+			remove(path->c_str());
+	}
+};
+
+// --------------------------------------------------------
+// A temporary attribute file, mapped back in (empty when the
+// file had none of that attribute)
+// --------------------------------------------------------
+template<typename T>
+struct MappedArray
+{
+	MappedFile* file;
+	const T* data;
+	uint64_t count;
+
+	MappedArray(const std::string& path, uint64_t count) : file(0), data(0), count(count)
+	{
+		if (count == 0)
+			return;
+		file = new MappedFile(path.c_str());
+		if (file->GetData() && file->GetSize() >= count * sizeof(T))
+			data = (const T*)file->GetData();
+	}
+
+	~MappedArray() { delete file; }
+
+	bool IsValid() { return count == 0 || data != 0; }
+};
+
+// --------------------------------------------------------
+// A grid cell's triangles: full blocks already written to the
+// bucket file, plus the block still being filled
+// --------------------------------------------------------
+struct ChunkCell
+{
+	std::vector<uint64_t> blocks;		// Offsets into the bucket file
+	std::vector<ObjVertexKey> pending;
+	uint64_t triangles;
+};
+
+// Chunks a cell becomes - ones well over the target are cut up
+static uint64_t GetCellChunkCount(uint64_t triangles, unsigned int trianglesPerChunk)
+{
+	if (triangles <= 2ull * trianglesPerChunk)
+		return triangles ? 1 : 0;
+	return (triangles + trianglesPerChunk - 1) / trianglesPerChunk;
+}
+
+static XMFLOAT3 TriangleCenter(const XMFLOAT3* positions, const ObjVertexKey* corners)
+{
+	const XMFLOAT3& a = positions[corners[0].position - 1];
+	const XMFLOAT3& b = positions[corners[1].position - 1];
+	const XMFLOAT3& c = positions[corners[2].position - 1];
+	return XMFLOAT3((a.x + b.x + c.x) / 3.0f, (a.y + b.y + c.y) / 3.0f, (a.z + b.z + c.z) / 3.0f);
+}
+
+// --------------------------------------------------------
+// Gives the attribute indices used by "corners" their own
+// compact numbering, gathering the attributes they point at
+// - Index 0 (no attribute) stays 0
+// --------------------------------------------------------
+template<typename T>
+static void GatherAttribute(
+	std::vector<ObjVertexKey>& corners, unsigned int ObjVertexKey::* member,
+	const T* source, std::vector<T>& local)
+{
+	std::unordered_map<unsigned int, unsigned int> remap;
+	remap.reserve(corners.size());
+	for (size_t k = 0; k < corners.size(); k++)
+	{
+		unsigned int& index = corners[k].*member;
+		if (index == 0)
+			continue;
+
+		std::unordered_map<unsigned int, unsigned int>::iterator found = remap.find(index);
+		if (found == remap.end())
+		{
+			local.push_back(source[index - 1]);
+			found = remap.insert(std::make_pair(index, (unsigned int)local.size())).first;
+		}
+		index = found->second;
+	}
+}
+
+// --------------------------------------------------------
+// Turns one chunk's corners into an optimized mesh and writes
+// it at the next page boundary of the output file
+// --------------------------------------------------------
+static bool WriteChunk(
+	std::vector<ObjVertexKey>& corners,
+	const MappedArray<XMFLOAT3>& positions,
+	const MappedArray<XMFLOAT2>& uvs,
+	const MappedArray<XMFLOAT3>& normals,
+	FILE* output, uint64_t& fileOffset, MeshChunk& chunk)
+{
+	std::vector<XMFLOAT3> localPositions, localNormals;
+	std::vector<XMFLOAT2> localUvs;
+	GatherAttribute(corners, &ObjVertexKey::position, positions.data, localPositions);
+	GatherAttribute(corners, &ObjVertexKey::uv, uvs.data, localUvs);
+	GatherAttribute(corners, &ObjVertexKey::normal, normals.data, localNormals);
+
+	ObjMeshData mesh;
+	BuildObjVertices(localPositions, localUvs, localNormals, corners, mesh);
+
+	OptimizeVertexCache(&mesh.indices[0], mesh.indices.size(), mesh.vertices.size());
+	mesh.vertices.resize(OptimizeVertexFetch(&mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex), &mesh.indices[0], mesh.indices.size()));
+
+	std::vector<unsigned char> encodedVertices, encodedIndices;
+	EncodeMeshStream(&mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex), encodedVertices);
+	EncodeIndexStream(&mesh.indices[0], mesh.indices.size(), encodedIndices);
+
+	ComputeBounds(&mesh.vertices[0], mesh.vertices.size(), chunk.boundsMin, chunk.boundsMax);
+	chunk.vertexCount = (uint32_t)mesh.vertices.size();
+	chunk.indexCount = (uint32_t)mesh.indices.size();
+	chunk.vertexBytes = (uint32_t)encodedVertices.size();
+	chunk.indexBytes = (uint32_t)encodedIndices.size();
+
+	// Pad up to the next page
+	static const char zeros[MeshChunkPageSize] = {};
+	size_t padding = (size_t)((MeshChunkPageSize - fileOffset % MeshChunkPageSize) % MeshChunkPageSize);
+	if (padding && fwrite(zeros, 1, padding, output) != padding)
+		return false;
+	chunk.offset = fileOffset + padding;
+
+	if (fwrite(&encodedVertices[0], 1, encodedVertices.size(), output) != encodedVertices.size() ||
+		fwrite(&encodedIndices[0], 1, encodedIndices.size(), output) != encodedIndices.size())
+		return false;
+	fileOffset = chunk.offset + chunk.vertexBytes + chunk.indexBytes;
+	return true;
+}
+
+bool BuildMeshChunks(const char* sourceFile, unsigned int trianglesPerChunk)
+{
+	if (trianglesPerChunk < 256)
+		trianglesPerChunk = 256;
+
+	MappedFile obj(sourceFile);
+	if (!obj.GetData())
+		return false;
+
+	MeshChunkHeader header = {};
+	memcpy(header.magic, MeshChunkMagic, sizeof(MeshChunkMagic));
+	header.version = MeshChunkVersion;
+	header.pageSize = MeshChunkPageSize;
+	if (!GetSourceInfo(sourceFile, header.sourceSize, header.sourceModifiedTime))
+		return false;
+
+	// The counter keeps builds in the same process apart
+	static std::atomic<unsigned int> tempCounter(0);
+	std::string path = GetMeshChunkPath(sourceFile);
+	char suffix[48];
+	snprintf(suffix, sizeof(suffix), ".%d.%u", (int)getpid(), tempCounter++);
+	ChunkBuildFiles files(path + suffix);
+
+	// Pass 1: copy the attributes out to their own files
+	uint64_t positionCount = 0, uvCount = 0, normalCount = 0;
+	XMFLOAT3 rawMin(FLT_MAX, FLT_MAX, FLT_MAX);
+	XMFLOAT3 rawMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	{
+		files.positions = OpenFile(files.positionsPath.c_str(), "wb");
+		files.uvs = OpenFile(files.uvsPath.c_str(), "wb");
+		files.normals = OpenFile(files.normalsPath.c_str(), "wb");
+		if (!files.positions || !files.uvs || !files.normals)
+			return false;
+
+		ObjStreamReader reader(obj.GetData(), obj.GetSize());
+		float values[3];
+		std::vector<ObjVertexKey> triangles;
+		bool written = true;
+		for (ObjRecord record; (record = reader.Next(values, triangles)) != ObjRecord::End;)
+		{
+			if (record == ObjRecord::Position)
+			{
+				written &= fwrite(values, sizeof(float), 3, files.positions) == 3;
+				rawMin = XMFLOAT3(fminf(rawMin.x, values[0]), fminf(rawMin.y, values[1]), fminf(rawMin.z, values[2]));
+				rawMax = XMFLOAT3(fmaxf(rawMax.x, values[0]), fmaxf(rawMax.y, values[1]), fmaxf(rawMax.z, values[2]));
+				positionCount++;
+			}
+			else if (record == ObjRecord::Uv)
+			{
+				written &= fwrite(values, sizeof(float), 2, files.uvs) == 2;
+				uvCount++;
+			}
+			else if (record == ObjRecord::Normal)
+			{
+				written &= fwrite(values, sizeof(float), 3, files.normals) == 3;
+				normalCount++;
+			}
+		}
+
+		FILE** attributeFiles[] = { &files.positions, &files.uvs, &files.normals };
+		for (FILE** file : attributeFiles)
+		{
+			written = fclose(*file) == 0 && written;
+			*file = 0;
+		}
+		if (!written || positionCount == 0)
+			return false;
+	}
+
+	MappedArray<XMFLOAT3> positions(files.positionsPath, positionCount);
+	MappedArray<XMFLOAT2> uvs(files.uvsPath, uvCount);
+	MappedArray<XMFLOAT3> normals(files.normalsPath, normalCount);
+	if (!positions.IsValid() || !uvs.IsValid() || !normals.IsValid())
+		return false;
+
+	// Pass 2: sort the triangles into grid cells, which are
+	// roughly cubes (flat models get a flat grid)
+	std::vector<ChunkCell> cells;
+	uint64_t gridSize[3];
+	float cellSize;
+	{
+		files.buckets = OpenFile(files.bucketsPath.c_str(), "w+b");
+		if (!files.buckets)
+			return false;
+
+		// Count the valid triangles first (cheap next to the rest)
+		// to pick a grid with about one cell per chunk
+		uint64_t triangleCount = 0;
+		ObjStreamReader counter(obj.GetData(), obj.GetSize());
+		float values[3];
+		std::vector<ObjVertexKey> triangles;
+		for (ObjRecord record; (record = counter.Next(values, triangles)) != ObjRecord::End;)
+			if (record == ObjRecord::Face)
+				triangleCount += triangles.size() / 3;
+
+		uint64_t targetCells = (triangleCount + trianglesPerChunk - 1) / trianglesPerChunk;
+		targetCells = std::max<uint64_t>(1, std::min(targetCells, MaxGridCells));
+
+		float extent[3] = { rawMax.x - rawMin.x, rawMax.y - rawMin.y, rawMax.z - rawMin.z };
+		cellSize = std::max(extent[0], std::max(extent[1], extent[2]));
+		if (cellSize <= 0)
+			cellSize = 1;
+		for (;;)
+		{
+			uint64_t cellCount = 1;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				gridSize[axis] = std::max<uint64_t>(1, (uint64_t)ceilf(extent[axis] / cellSize));
+				cellCount *= gridSize[axis];
+			}
+			if (cellCount >= targetCells)
+				break;
+			cellSize *= 0.9f;
+		}
+		cells.resize(gridSize[0] * gridSize[1] * gridSize[2]);
+
+		ObjStreamReader reader(obj.GetData(), obj.GetSize());
+		uint64_t bucketOffset = 0;
+		bool written = true;
+		for (ObjRecord record; (record = reader.Next(values, triangles)) != ObjRecord::End;)
+		{
+			if (record != ObjRecord::Face)
+				continue;
+
+			for (size_t t = 0; t + 2 < triangles.size(); t += 3)
+			{
+				// Same rules as ParseObj: positions are required, UVs
+				// and normals are optional
+				bool valid = true;
+				for (int k = 0; k < 3; k++)
+				{
+					const ObjVertexKey& key = triangles[t + k];
+					valid = valid &&
+						key.position != 0 && key.position <= positionCount &&
+						key.uv <= uvCount && key.normal <= normalCount;
+				}
+				if (!valid)
+					continue;
+
+				XMFLOAT3 center = TriangleCenter(positions.data, &triangles[t]);
+				float point[3] = { center.x - rawMin.x, center.y - rawMin.y, center.z - rawMin.z };
+				uint64_t cellIndex = 0;
+				for (int axis = 2; axis >= 0; axis--)
+				{
+					uint64_t coordinate = (uint64_t)std::max(0.0f, point[axis] / cellSize);
+					cellIndex = cellIndex * gridSize[axis] + std::min(coordinate, gridSize[axis] - 1);
+				}
+
+				ChunkCell& cell = cells[cellIndex];
+				cell.pending.insert(cell.pending.end(), &triangles[t], &triangles[t] + 3);
+				cell.triangles++;
+				if (cell.pending.size() == BlockTriangles * 3)
+				{
+					cell.blocks.push_back(bucketOffset);
+					written &= fwrite(&cell.pending[0], sizeof(ObjVertexKey), cell.pending.size(), files.buckets) == cell.pending.size();
+					bucketOffset += cell.pending.size() * sizeof(ObjVertexKey);
+					cell.pending.clear();
+				}
+			}
+		}
+		if (!written || fflush(files.buckets) != 0)
+			return false;
+	}
+
+	// The chunk table's size is known now, so the data can start
+	// right after it
+	std::vector<MeshChunk> chunks;
+	{
+		uint64_t chunkCount = 0;
+		for (size_t i = 0; i < cells.size(); i++)
+			chunkCount += GetCellChunkCount(cells[i].triangles, trianglesPerChunk);
+		if (chunkCount == 0)
+			return false;
+		chunks.resize((size_t)chunkCount);
+	}
+
+	files.output = OpenFile(files.outputPath.c_str(), "wb");
+	if (!files.output)
+		return false;
+
+	uint64_t fileOffset = sizeof(MeshChunkHeader) + chunks.size() * sizeof(MeshChunk);
+	std::vector<char> placeholder((size_t)fileOffset, 0);
+	if (fwrite(&placeholder[0], 1, placeholder.size(), files.output) != placeholder.size())
+		return false;
+
+	// Pass 3: one cell at a time, into one or more chunks
+	size_t nextChunk = 0;
+	std::vector<ObjVertexKey> corners, piece;
+	for (size_t i = 0; i < cells.size(); i++)
+	{
+		ChunkCell& cell = cells[i];
+		if (cell.triangles == 0)
+			continue;
+
+		corners.resize((size_t)cell.triangles * 3);
+		size_t filled = 0;
+		for (size_t b = 0; b < cell.blocks.size(); b++)
+		{
+			if (!SeekFile(files.buckets, cell.blocks[b]) ||
+				fread(&corners[filled], sizeof(ObjVertexKey), BlockTriangles * 3, files.buckets) != BlockTriangles * 3)
+				return false;
+			filled += BlockTriangles * 3;
+		}
+		std::copy(cell.pending.begin(), cell.pending.end(), corners.begin() + filled);
+		std::vector<ObjVertexKey>().swap(cell.pending);
+
+		// Too many for one chunk: cut into slabs along the axis the
+		// triangle centres spread the furthest on
+		uint64_t pieces = GetCellChunkCount(cell.triangles, trianglesPerChunk);
+		size_t triangleCount = (size_t)cell.triangles;
+		std::vector<unsigned int> order(triangleCount);
+		for (size_t t = 0; t < triangleCount; t++)
+			order[t] = (unsigned int)t;
+		if (pieces > 1)
+		{
+			std::vector<XMFLOAT3> centers(triangleCount);
+			XMFLOAT3 lo(FLT_MAX, FLT_MAX, FLT_MAX), hi(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+			for (size_t t = 0; t < triangleCount; t++)
+			{
+				XMFLOAT3 c = TriangleCenter(positions.data, &corners[t * 3]);
+				centers[t] = c;
+				lo = XMFLOAT3(fminf(lo.x, c.x), fminf(lo.y, c.y), fminf(lo.z, c.z));
+				hi = XMFLOAT3(fmaxf(hi.x, c.x), fmaxf(hi.y, c.y), fmaxf(hi.z, c.z));
+			}
+
+			float spread[3] = { hi.x - lo.x, hi.y - lo.y, hi.z - lo.z };
+			int axis = spread[1] > spread[0] ? 1 : 0;
+			if (spread[2] > spread[axis]) axis = 2;
+			std::stable_sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b)
+			{
+				return (&centers[a].x)[axis] < (&centers[b].x)[axis];
+			});
+		}
+
+		for (uint64_t p = 0; p < pieces; p++)
+		{
+			size_t first = (size_t)(triangleCount * p / pieces);
+			size_t last = (size_t)(triangleCount * (p + 1) / pieces);
+			piece.clear();
+			for (size_t t = first; t < last; t++)
+				piece.insert(piece.end(), &corners[order[t] * 3], &corners[order[t] * 3] + 3);
+
+			if (!WriteChunk(piece, positions, uvs, normals, files.output, fileOffset, chunks[nextChunk++]))
+				return false;
+		}
+	}
+
+	// Now the header and table can be filled in
+	header.chunkCount = (uint32_t)chunks.size();
+	header.boundsMin = XMFLOAT3(FLT_MAX, FLT_MAX, FLT_MAX);
+	header.boundsMax = XMFLOAT3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	for (size_t c = 0; c < chunks.size(); c++)
+	{
+		header.triangleCount += chunks[c].indexCount / 3;
+		const XMFLOAT3& lo = chunks[c].boundsMin;
+		const XMFLOAT3& hi = chunks[c].boundsMax;
+		header.boundsMin = XMFLOAT3(fminf(header.boundsMin.x, lo.x), fminf(header.boundsMin.y, lo.y), fminf(header.boundsMin.z, lo.z));
+		header.boundsMax = XMFLOAT3(fmaxf(header.boundsMax.x, hi.x), fmaxf(header.boundsMax.y, hi.y), fmaxf(header.boundsMax.z, hi.z));
+	}
+
+	bool written =
+		SeekFile(files.output, 0) &&
+		fwrite(&header, sizeof(header), 1, files.output) == 1 &&
+		fwrite(&chunks[0], sizeof(MeshChunk), chunks.size(), files.output) == chunks.size();
+	written = fclose(files.output) == 0 && written;
+	files.output = 0;
+
+	return written && ReplaceFile(files.outputPath, path);
+}
+
+bool ReadMeshChunkTable(const char* sourceFile, MeshChunkHeader& header, std::vector<MeshChunk>& chunks)
+{
+	uint64_t sourceSize, chunkFileSize;
+	int64_t sourceTime, chunkFileTime;
+	std::string path = GetMeshChunkPath(sourceFile);
+	if (!GetSourceInfo(sourceFile, sourceSize, sourceTime) ||
+		!GetSourceInfo(path.c_str(), chunkFileSize, chunkFileTime))
+		return false;
+
+	FILE* file = OpenFile(path.c_str(), "rb");
+	if (!file)
+		return false;
+
+	bool valid =
+		fread(&header, sizeof(header), 1, file) == 1 &&
+		memcmp(header.magic, MeshChunkMagic, sizeof(MeshChunkMagic)) == 0 &&
+		header.version == MeshChunkVersion &&
+		header.pageSize == MeshChunkPageSize &&
+		header.sourceSize == sourceSize &&
+		header.sourceModifiedTime == sourceTime &&
+		header.chunkCount > 0 &&
+		sizeof(header) + (uint64_t)header.chunkCount * sizeof(MeshChunk) <= chunkFileSize;
+	if (valid)
+	{
+		chunks.resize(header.chunkCount);
+		valid = fread(&chunks[0], sizeof(MeshChunk), chunks.size(), file) == chunks.size();
+	}
+	fclose(file);
+
+	// Every chunk's data has to be inside the file
+	for (size_t c = 0; valid && c < chunks.size(); c++)
+		valid = chunks[c].offset + chunks[c].vertexBytes + chunks[c].indexBytes <= chunkFileSize;
+	return valid;
+}
+
+FILE* OpenMeshChunkFile(const char* sourceFile)
+{
+	return OpenFile(GetMeshChunkPath(sourceFile).c_str(), "rb");
+}
+
+bool ReadMeshChunk(FILE* chunkFile, const MeshChunk& chunk, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+{
+	std::vector<unsigned char> data((size_t)chunk.vertexBytes + chunk.indexBytes);
+	if (data.empty() || chunk.vertexCount == 0 || chunk.indexCount == 0 ||
+		!SeekFile(chunkFile, chunk.offset) ||
+		fread(&data[0], 1, data.size(), chunkFile) != data.size())
+		return false;
+
+	vertices.resize(chunk.vertexCount);
+	indices.resize(chunk.indexCount);
+	if (!DecodeMeshStream(&vertices[0], vertices.size(), sizeof(Vertex), &data[0], chunk.vertexBytes) ||
+		!DecodeIndexStream(&indices[0], indices.size(), &data[chunk.vertexBytes], chunk.indexBytes))
+		return false;
+
+	// A damaged file mustn't index past the vertices
+	for (size_t i = 0; i < indices.size(); i++)
+		if (indices[i] >= chunk.vertexCount)
+			return false;
+	return true;
+}
+
+std::string GetMeshChunkPath(const char* sourceFile)
+{
+	return std::string(sourceFile) + ".meshchunks";
+}
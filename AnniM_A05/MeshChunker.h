@@ -0,0 +1,95 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Vertex.h"
+
+// --------------------------------------------------------
+// Out-of-core import for models too big to load at once
+//
+// BuildMeshChunks() splits an OBJ file into spatial chunks of
+// roughly trianglesPerChunk triangles each, without ever holding
+// the whole model in memory:
+//  1. Stream the file once, writing its positions, UVs and
+//     normals to temporary files (memory-mapped afterwards, so
+//     the OS pages them in and out as needed)
+//  2. Stream the faces again, sorting each triangle into a grid
+//     cell by its centre - cells collect their triangles in
+//     small blocks in one temporary file
+//  3. One cell at a time, weld and optimize its triangles (cells
+//     that came out too big are cut into slabs) and append them
+//     to the chunk file
+// Memory use depends on the grid and chunk sizes, not the model.
+// (A single cell holding far more than its share is read back
+// whole, though.)
+//
+// Each chunk is an independent little mesh: its own welded
+// vertices (Vertex, left-handed like ParseObj's) and indices.
+// Normals the file leaves out are generated per chunk, so they
+// can show a faint seam along chunk borders.  Materials are
+// ignored - every chunk is drawn with one.
+//
+// Layout of the chunk file ("<file>.meshchunks"): a
+// MeshChunkHeader, chunkCount MeshChunks, then each chunk's
+// vertices and indices (encoded with MeshCodec) starting on a
+// MeshChunkPageSize boundary, so a chunk is read with one
+// aligned read.
+// --------------------------------------------------------
+struct MeshChunkHeader
+{
+	char magic[4];					// "MCHK"
+	uint32_t version;				// MeshChunkVersion when written
+	uint32_t pageSize;				// MeshChunkPageSize when written
+	uint32_t chunkCount;
+	uint64_t sourceSize;			// Size of the OBJ file in bytes
+	int64_t sourceModifiedTime;		// Last write time of the OBJ file
+	uint64_t triangleCount;			// All chunks together
+	DirectX::XMFLOAT3 boundsMin;	// Axis-aligned bounds of every chunk
+	DirectX::XMFLOAT3 boundsMax;
+};
+
+struct MeshChunk
+{
+	DirectX::XMFLOAT3 boundsMin;	// Bounds of the chunk's vertices
+	DirectX::XMFLOAT3 boundsMax;
+	uint32_t vertexCount;
+	uint32_t indexCount;
+	uint64_t offset;				// Where the data starts (a whole number of pages)
+	uint32_t vertexBytes;			// Encoded vertices, then
+	uint32_t indexBytes;			// encoded indices
+};
+
+// Bump this whenever the layout above changes
+static const uint32_t MeshChunkVersion = 1;
+static const uint32_t MeshChunkPageSize = 4096;
+
+// --------------------------------------------------------
+// Builds the chunk file for the given OBJ file
+// - Returns false (leaving no partial file) on failure
+// - Temporary files go next to the chunk file, and take about
+//    as much disk space as the model's attributes plus 36
+//    bytes per triangle
+// --------------------------------------------------------
+bool BuildMeshChunks(const char* sourceFile, unsigned int trianglesPerChunk = 65536);
+
+// --------------------------------------------------------
+// Reads and validates a chunk file's header and chunk table
+// - Fails if the file is missing, from another version, or
+//    older than the OBJ file (its size or timestamp changed)
+// --------------------------------------------------------
+bool ReadMeshChunkTable(const char* sourceFile, MeshChunkHeader& header, std::vector<MeshChunk>& chunks);
+
+// --------------------------------------------------------
+// Opens the chunk file for ReadMeshChunk() (close it with
+// fclose) - each thread reading chunks needs its own
+// --------------------------------------------------------
+FILE* OpenMeshChunkFile(const char* sourceFile);
+
+// Reads and decodes one chunk from an open chunk file
+bool ReadMeshChunk(FILE* chunkFile, const MeshChunk& chunk, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+// Path of the chunk file used for the given source file
+std::string GetMeshChunkPath(const char* sourceFile);
@@ -0,0 +1,397 @@
+#include "MeshCodec.h"
+#include <cstring>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define MESH_CODEC_SSE2
+#include <emmintrin.h>
+#endif
+
+// --------------------------------------------------------
+// Elements per block, and the bits per value of each mode
+// (payload bytes are BlockSize * bits / 8)
+// --------------------------------------------------------
+static const size_t BlockSize = 16;
+static const size_t MaxStride = 256;
+static const unsigned int ModeBits[4] = { 0, 2, 4, 8 };
+
+static inline unsigned char ZigZag(unsigned char delta)
+{
+	return (unsigned char)((delta << 1) ^ (unsigned char)((signed char)delta >> 7));
+}
+
+static inline unsigned char UnZigZag(unsigned char value)
+{
+	return (unsigned char)((value >> 1) ^ (unsigned char)(0 - (value & 1)));
+}
+
+// --------------------------------------------------------
+// Packs 16 values that all fit in "bits" bits
+// - 2 bits: value i goes in byte i % 4, at bit 2 * (i / 4)
+// - 4 bits: value i goes in byte i % 8, at bit 4 * (i / 8)
+// - Laid out this way, the decoder can unpack them with a
+//    few whole-register shifts instead of per-value ones
+// --------------------------------------------------------
+static void PackPlane(const unsigned char* values, unsigned int bits, std::vector<unsigned char>& out)
+{
+	if (bits == 0)
+		return;
+
+	if (bits == 8)
+	{
+		out.insert(out.end(), values, values + BlockSize);
+		return;
+	}
+
+	size_t groups = BlockSize * bits / 8;
+	unsigned char packed[8] = {};
+	for (size_t i = 0; i < BlockSize; i++)
+		packed[i % groups] |= (unsigned char)(values[i] << (bits * (i / groups)));
+	out.insert(out.end(), packed, packed + groups);
+}
+
+void EncodeMeshStream(const void* elements, size_t count, size_t stride, std::vector<unsigned char>& out)
+{
+	const unsigned char* bytes = (const unsigned char*)elements;
+	size_t headerBytes = (stride + 3) / 4;
+
+	unsigned char previous[MaxStride] = {};
+	unsigned char values[BlockSize];
+	for (size_t base = 0; base < count; base += BlockSize)
+	{
+		// The last block is padded with copies of its last element,
+		// which cost nothing (their deltas are all zero)
+		size_t blockCount = count - base < BlockSize ? count - base : BlockSize;
+
+		size_t headerStart = out.size();
+		out.resize(out.size() + headerBytes, 0);
+		for (size_t k = 0; k < stride; k++)
+		{
+			unsigned char largest = 0;
+			unsigned char last = previous[k];
+			for (size_t i = 0; i < BlockSize; i++)
+			{
+				unsigned char current = bytes[(base + (i < blockCount ? i : blockCount - 1)) * stride + k];
+				values[i] = ZigZag((unsigned char)(current - last));
+				largest |= values[i];
+				last = current;
+			}
+			previous[k] = last;
+
+			unsigned int mode = largest == 0 ? 0 : (largest < 4 ? 1 : (largest < 16 ? 2 : 3));
+			out[headerStart + k / 4] |= (unsigned char)(mode << (2 * (k % 4)));
+			PackPlane(values, ModeBits[mode], out);
+		}
+	}
+}
+
+// --------------------------------------------------------
+// Decodes one plane of 16 values, one at a time
+// - Returns the payload bytes used
+// --------------------------------------------------------
+static size_t DecodePlaneScalar(const unsigned char* payload, unsigned int mode, unsigned char& previous, unsigned char* plane)
+{
+	unsigned int bits = ModeBits[mode];
+	size_t groups = BlockSize * bits / 8;
+	for (size_t i = 0; i < BlockSize; i++)
+	{
+		unsigned char value = 0;
+		if (bits == 8)
+			value = payload[i];
+		else if (bits > 0)
+			value = (unsigned char)((payload[i % groups] >> (bits * (i / groups))) & ((1 << bits) - 1));
+
+		previous = (unsigned char)(previous + UnZigZag(value));
+		plane[i] = previous;
+	}
+	return groups;
+}
+
+// --------------------------------------------------------
+// Decodes the whole stream a plane and an element at a time
+// - The stride has already been checked
+// --------------------------------------------------------
+static bool DecodeMeshStreamScalar(unsigned char* bytes, size_t count, size_t stride, const unsigned char* data, size_t size)
+{
+	const unsigned char* end = data + size;
+	size_t headerBytes = (stride + 3) / 4;
+	unsigned char previous[MaxStride] = {};
+	unsigned char planes[MaxStride][BlockSize];
+
+	for (size_t base = 0; base < count; base += BlockSize)
+	{
+		size_t blockCount = count - base < BlockSize ? count - base : BlockSize;
+		if ((size_t)(end - data) < headerBytes)
+			return false;
+		const unsigned char* header = data;
+		data += headerBytes;
+
+		for (size_t k = 0; k < stride; k++)
+		{
+			unsigned int mode = (header[k / 4] >> (2 * (k % 4))) & 3;
+			size_t payloadBytes = BlockSize * ModeBits[mode] / 8;
+			if ((size_t)(end - data) < payloadBytes)
+				return false;
+			DecodePlaneScalar(data, mode, previous[k], planes[k]);
+			data += payloadBytes;
+		}
+
+		unsigned char* block = bytes + base * stride;
+		for (size_t k = 0; k < stride; k++)
+		{
+			for (size_t i = 0; i < blockCount; i++)
+				block[i * stride + k] = planes[k][i];
+		}
+	}
+
+	return true;
+}
+
+#ifdef MESH_CODEC_SSE2
+// --------------------------------------------------------
+// Decodes one plane of 16 values at once
+// - "previous" holds the last decoded value in all 16 bytes
+// --------------------------------------------------------
+static inline __m128i DecodePlaneSSE2(const unsigned char* payload, unsigned int mode, __m128i& previous)
+{
+	__m128i values;
+	switch (mode)
+	{
+	case 0:
+		return previous;
+
+	case 1:
+	{
+		int packed;
+		memcpy(&packed, payload, 4);
+		__m128i a = _mm_cvtsi32_si128(packed);
+		__m128i low = _mm_unpacklo_epi32(a, _mm_srli_epi32(a, 2));
+		__m128i high = _mm_unpacklo_epi32(_mm_srli_epi32(a, 4), _mm_srli_epi32(a, 6));
+		values = _mm_and_si128(_mm_unpacklo_epi64(low, high), _mm_set1_epi8(0x03));
+		break;
+	}
+
+	case 2:
+	{
+		__m128i a = _mm_loadl_epi64((const __m128i*)payload);
+		values = _mm_and_si128(_mm_unpacklo_epi64(a, _mm_srli_epi16(a, 4)), _mm_set1_epi8(0x0F));
+		break;
+	}
+
+	default:
+		values = _mm_loadu_si128((const __m128i*)payload);
+		break;
+	}
+
+	// Undo the zigzag: (v >> 1) ^ -(v & 1), a byte at a time
+	__m128i half = _mm_and_si128(_mm_srli_epi16(values, 1), _mm_set1_epi8(0x7F));
+	__m128i sign = _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(values, _mm_set1_epi8(1)));
+	__m128i deltas = _mm_xor_si128(half, sign);
+
+	// Prefix sum across the 16 lanes, then add the running value
+	deltas = _mm_add_epi8(deltas, _mm_slli_si128(deltas, 1));
+	deltas = _mm_add_epi8(deltas, _mm_slli_si128(deltas, 2));
+	deltas = _mm_add_epi8(deltas, _mm_slli_si128(deltas, 4));
+	deltas = _mm_add_epi8(deltas, _mm_slli_si128(deltas, 8));
+	__m128i result = _mm_add_epi8(deltas, previous);
+
+	// Broadcast lane 15 for the next block
+	__m128i last = _mm_unpackhi_epi8(result, result);
+	last = _mm_shufflehi_epi16(last, 0xFF);
+	previous = _mm_shuffle_epi32(last, 0xFF);
+	return result;
+}
+
+// --------------------------------------------------------
+// Interleaves four planes into 4-byte groups - quads[q] holds
+// elements 4q to 4q + 3
+// --------------------------------------------------------
+static inline void TransposePlanes4(const __m128i* planes, __m128i quads[4])
+{
+	__m128i t0 = _mm_unpacklo_epi8(planes[0], planes[1]);
+	__m128i t1 = _mm_unpackhi_epi8(planes[0], planes[1]);
+	__m128i t2 = _mm_unpacklo_epi8(planes[2], planes[3]);
+	__m128i t3 = _mm_unpackhi_epi8(planes[2], planes[3]);
+	quads[0] = _mm_unpacklo_epi16(t0, t2);
+	quads[1] = _mm_unpackhi_epi16(t0, t2);
+	quads[2] = _mm_unpacklo_epi16(t1, t3);
+	quads[3] = _mm_unpackhi_epi16(t1, t3);
+}
+
+// --------------------------------------------------------
+// Decodes the whole stream a plane at a time, then transposes
+// the planes back into elements with shuffles
+// - Gives exactly the same bytes as DecodeMeshStreamScalar
+// --------------------------------------------------------
+static bool DecodeMeshStreamSSE2(unsigned char* bytes, size_t count, size_t stride, const unsigned char* data, size_t size)
+{
+	const unsigned char* end = data + size;
+	size_t headerBytes = (stride + 3) / 4;
+
+	__m128i previous[MaxStride];
+	for (size_t k = 0; k < stride; k++)
+		previous[k] = _mm_setzero_si128();
+	__m128i planes[MaxStride];
+
+	for (size_t base = 0; base < count; base += BlockSize)
+	{
+		size_t blockCount = count - base < BlockSize ? count - base : BlockSize;
+		if ((size_t)(end - data) < headerBytes)
+			return false;
+		const unsigned char* header = data;
+		data += headerBytes;
+
+		// Decode every plane of the block...
+		for (size_t k = 0; k < stride; k++)
+		{
+			unsigned int mode = (header[k / 4] >> (2 * (k % 4))) & 3;
+			size_t payloadBytes = BlockSize * ModeBits[mode] / 8;
+			if ((size_t)(end - data) < payloadBytes)
+				return false;
+			planes[k] = DecodePlaneSSE2(data, mode, previous[k]);
+			data += payloadBytes;
+		}
+
+		// ...then turn the planes back into elements
+		unsigned char* block = bytes + base * stride;
+		size_t k = 0;
+		if (blockCount == BlockSize)
+		{
+			// Sixteen planes at a time make a full 16x16 transpose,
+			// so each element's 16 bytes are stored at once
+			for (; k + 16 <= stride; k += 16)
+			{
+				__m128i quads[4][4];
+				for (size_t g = 0; g < 4; g++)
+					TransposePlanes4(&planes[k + g * 4], quads[g]);
+
+				for (size_t q = 0; q < 4; q++)
+				{
+					__m128i t0 = _mm_unpacklo_epi32(quads[0][q], quads[1][q]);
+					__m128i t1 = _mm_unpackhi_epi32(quads[0][q], quads[1][q]);
+					__m128i t2 = _mm_unpacklo_epi32(quads[2][q], quads[3][q]);
+					__m128i t3 = _mm_unpackhi_epi32(quads[2][q], quads[3][q]);
+					_mm_storeu_si128((__m128i*)(block + (q * 4 + 0) * stride + k), _mm_unpacklo_epi64(t0, t2));
+					_mm_storeu_si128((__m128i*)(block + (q * 4 + 1) * stride + k), _mm_unpackhi_epi64(t0, t2));
+					_mm_storeu_si128((__m128i*)(block + (q * 4 + 2) * stride + k), _mm_unpacklo_epi64(t1, t3));
+					_mm_storeu_si128((__m128i*)(block + (q * 4 + 3) * stride + k), _mm_unpackhi_epi64(t1, t3));
+				}
+			}
+
+			// Then four (4 bytes per element)...
+			for (; k + 4 <= stride; k += 4)
+			{
+				__m128i quads[4];
+				TransposePlanes4(&planes[k], quads);
+				for (size_t q = 0; q < 4; q++)
+				{
+					__m128i quad = quads[q];
+					for (size_t j = 0; j < 4; j++)
+					{
+						int value = _mm_cvtsi128_si32(quad);
+						memcpy(block + (q * 4 + j) * stride + k, &value, 4);
+						quad = _mm_srli_si128(quad, 4);
+					}
+				}
+			}
+
+			// ...then two (16-bit indices, for one)
+			for (; k + 2 <= stride; k += 2)
+			{
+				__m128i pairs[2] =
+				{
+					_mm_unpacklo_epi8(planes[k], planes[k + 1]),
+					_mm_unpackhi_epi8(planes[k], planes[k + 1]),
+				};
+				for (size_t p = 0; p < 2; p++)
+				{
+					unsigned short values[8];
+					_mm_storeu_si128((__m128i*)values, pairs[p]);
+					for (size_t j = 0; j < 8; j++)
+						memcpy(block + (p * 8 + j) * stride + k, &values[j], 2);
+				}
+			}
+		}
+		unsigned char stored[BlockSize];
+		for (; k < stride; k++)
+		{
+			_mm_storeu_si128((__m128i*)stored, planes[k]);
+			for (size_t i = 0; i < blockCount; i++)
+				block[i * stride + k] = stored[i];
+		}
+	}
+
+	return true;
+}
+#endif
+
+// Whether DecodeMeshStream may use the SSE2 decoder
+#ifdef MESH_CODEC_SSE2
+static bool simdEnabled = true;
+#else
+static bool simdEnabled = false;
+#endif
+
+bool DecodeMeshStream(void* destination, size_t count, size_t stride, const unsigned char* data, size_t size)
+{
+	if (stride == 0 || stride > MaxStride)
+		return false;
+
+#ifdef MESH_CODEC_SSE2
+	if (simdEnabled)
+		return DecodeMeshStreamSSE2((unsigned char*)destination, count, stride, data, size);
+#endif
+	return DecodeMeshStreamScalar((unsigned char*)destination, count, stride, data, size);
+}
+
+void SetMeshCodecSimdEnabled(bool enabled)
+{
+#ifdef MESH_CODEC_SSE2
+	simdEnabled = enabled;
+#else
+	simdEnabled = false;
+#endif
+}
+
+bool IsMeshCodecSimdEnabled()
+{
+	return simdEnabled;
+}
+
+void EncodeIndexStream(const unsigned int* indices, size_t count, std::vector<unsigned char>& out)
+{
+	unsigned int largest = 0;
+	for (size_t i = 0; i < count; i++)
+		largest = indices[i] > largest ? indices[i] : largest;
+
+	if (largest <= 0xFFFF)
+	{
+		std::vector<unsigned short> shortIndices(indices, indices + count);
+		out.push_back(2);
+		EncodeMeshStream(shortIndices.empty() ? 0 : &shortIndices[0], count, 2, out);
+	}
+	else
+	{
+		out.push_back(4);
+		EncodeMeshStream(indices, count, 4, out);
+	}
+}
+
+bool DecodeIndexStream(unsigned int* destination, size_t count, const unsigned char* data, size_t size)
+{
+	if (size < 1)
+		return false;
+
+	if (data[0] == 4)
+		return DecodeMeshStream(destination, count, 4, data + 1, size - 1);
+	if (data[0] != 2)
+		return false;
+
+	// Decode into the back half of the destination, then widen
+	// front to back (each index lands at or past where it came from)
+	unsigned short* shortIndices = (unsigned short*)(destination + count) - count;
+	if (!DecodeMeshStream(shortIndices, count, 2, data + 1, size - 1))
+		return false;
+	for (size_t i = 0; i < count; i++)
+		destination[i] = shortIndices[i];
+	return true;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+// --------------------------------------------------------
+// Lossless compression for vertex and index buffers
+//
+// Elements (vertices, or single indices) are handled in blocks
+// of 16.  Within a block, each byte of the element is its own
+// "plane": the byte's change from the element before it, zigzag
+// encoded so small changes either way are small numbers, then
+// packed into 0, 2, 4 or 8 bits per value (whichever is the
+// smallest that fits all 16).
+//
+// Neighbouring vertices after OptimizeVertexFetch (and indices
+// after OptimizeVertexCache) tend to be alike, so most planes
+// end up in 0 to 4 bits.  Quantized data (like CompactVertex)
+// compresses far better than raw floats.
+//
+// Decoding is branch-light and uses SSE2 where it's available
+// (every x64 CPU), with a plain C++ fallback elsewhere - both
+// give exactly the same bytes.
+// --------------------------------------------------------
+
+// --------------------------------------------------------
+// Encodes "count" elements of "stride" bytes each (stride can
+// be anything up to 256) and appends the result to "out"
+// --------------------------------------------------------
+void EncodeMeshStream(const void* elements, size_t count, size_t stride, std::vector<unsigned char>& out);
+
+// --------------------------------------------------------
+// Decodes a stream written by EncodeMeshStream with the same
+// count and stride into "destination" (count * stride bytes)
+// - Returns false if the data is too short or malformed
+// --------------------------------------------------------
+bool DecodeMeshStream(void* destination, size_t count, size_t stride, const unsigned char* data, size_t size);
+
+// --------------------------------------------------------
+// Turns the SSE2 decoder off or back on (for checking the
+// plain C++ one against it) - it's never used where SSE2
+// isn't compiled in.  Set it before any decoding starts.
+// --------------------------------------------------------
+void SetMeshCodecSimdEnabled(bool enabled);
+bool IsMeshCodecSimdEnabled();
+
+// --------------------------------------------------------
+// Index buffers are encoded as 16-bit elements when every
+// index fits (half the planes to store), 32-bit otherwise
+// - The first byte of the encoding records which
+// --------------------------------------------------------
+void EncodeIndexStream(const unsigned int* indices, size_t count, std::vector<unsigned char>& out);
+bool DecodeIndexStream(unsigned int* destination, size_t count, const unsigned char* data, size_t size);
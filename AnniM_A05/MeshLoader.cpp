@@ -0,0 +1,109 @@
+#include "MeshLoader.h"
+#include "Parallel.h"
+#include <algorithm>
+
+MeshLoader::MeshLoader(ID3D11Device* device, unsigned int workerCount)
+{
+	this->device = device;
+	stopping = false;
+
+	if (workerCount == 0)
+	{
+		workerCount = ResolveThreadCount(0);
+		workerCount = workerCount > 1 ? workerCount - 1 : 1;
+	}
+
+	workers.reserve(workerCount);
+	for (unsigned int i = 0; i < workerCount; i++)
+		workers.emplace_back(&MeshLoader::WorkerLoop, this);
+}
+
+// --------------------------------------------------------
+// Finishes the meshes being loaded right now, and marks the
+// ones still waiting in the queue as Failed
+// --------------------------------------------------------
+MeshLoader::~MeshLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+		for (size_t i = 0; i < jobs.size(); i++)
+			jobs[i].mesh->state = MeshState::Failed;
+		jobs.clear();
+	}
+	jobAdded.notify_all();
+
+	for (size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
+}
+
+Mesh* MeshLoader::Load(const char* file, VertexFormat format)
+{
+	Job job;
+	job.mesh = new Mesh(format);
+	job.file = file;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		jobs.push_back(job);
+	}
+	jobAdded.notify_one();
+
+	return job.mesh;
+}
+
+void MeshLoader::WaitForAll()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	jobFinished.wait(lock, [this] { return jobs.empty() && loading.empty(); });
+}
+
+void MeshLoader::Cancel(Mesh* mesh)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	for (size_t i = 0; i < jobs.size(); i++)
+	{
+		if (jobs[i].mesh == mesh)
+		{
+			mesh->state = MeshState::Failed;
+			jobs.erase(jobs.begin() + i);
+			return;
+		}
+	}
+
+	jobFinished.wait(lock, [this, mesh] { return std::find(loading.begin(), loading.end(), mesh) == loading.end(); });
+}
+
+unsigned int MeshLoader::GetPendingCount()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return (unsigned int)(jobs.size() + loading.size());
+}
+
+void MeshLoader::WorkerLoop()
+{
+	for (;;)
+	{
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			jobAdded.wait(lock, [this] { return stopping || !jobs.empty(); });
+			if (stopping)
+				return;
+
+			job = jobs.front();
+			jobs.pop_front();
+			loading.push_back(job.mesh);
+		}
+
+		// Meshes already load in parallel with each other, so each
+		// one is parsed on a single thread
+		job.mesh->LoadObj(job.file.c_str(), device, 1);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			loading.erase(std::find(loading.begin(), loading.end(), job.mesh));
+		}
+		jobFinished.notify_all();
+	}
+}
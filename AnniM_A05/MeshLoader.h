@@ -0,0 +1,62 @@
+#pragma once
+
+#include <d3d11.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Mesh.h"
+
+// --------------------------------------------------------
+// Loads OBJ meshes on a pool of background threads
+//
+// Load() returns a Mesh right away, in the Loading state.  A
+// worker then parses the file (or maps its cache) and creates
+// the buffers - D3D11 devices are free-threaded, so that needs
+// nothing from the main thread - and finally marks it Ready
+// (or Failed).  Skip any mesh that isn't IsReady() when drawing.
+//
+// The caller owns the returned meshes, but must delete the
+// loader first so no worker is still filling one in.
+// --------------------------------------------------------
+class MeshLoader
+{
+	struct Job
+	{
+		Mesh* mesh;
+		std::string file;
+	};
+
+	ID3D11Device* device;
+	std::vector<std::thread> workers;
+	std::deque<Job> jobs;
+	std::vector<Mesh*> loading;		// Meshes workers are loading right now
+	std::mutex mutex;
+	std::condition_variable jobAdded;
+	std::condition_variable jobFinished;
+	bool stopping;
+
+	void WorkerLoop();
+public:
+	// workerCount - 0 leaves one hardware thread for the main thread
+	MeshLoader(ID3D11Device* device, unsigned int workerCount = 0);
+	~MeshLoader();
+
+	Mesh* Load(const char* file, VertexFormat format = VertexFormat::Full);
+
+	// Blocks until every queued mesh has finished loading
+	void WaitForAll();
+
+	// Stops loading one mesh, so it can be deleted: a mesh still
+	// queued is taken out and marked Failed, and one a worker has
+	// started is waited for (only that one)
+	void Cancel(Mesh* mesh);
+
+	// Meshes queued or being loaded right now
+	unsigned int GetPendingCount();
+
+	MeshLoader(const MeshLoader&) = delete;
+	MeshLoader& operator=(const MeshLoader&) = delete;
+};
@@ -0,0 +1,260 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <vector>
+#include <cmath>
+#include <cstring>
+
+// --------------------------------------------------------
+// Scoring constants from Forsyth's "Linear-Speed Vertex Cache
+// Optimisation" - the cache modelled here is an LRU of 32
+// --------------------------------------------------------
+static const int ForsythCacheSize = 32;
+static const float CacheDecayPower = 1.5f;
+static const float LastTriangleScore = 0.75f;
+static const float ValenceBoostScale = 2.0f;
+
+// Remaining triangles searched for a new start when the cache
+// has nothing left to offer
+static const size_t DeadEndWindow = 256;
+static const float ValenceBoostPower = 0.5f;
+
+// --------------------------------------------------------
+// How desirable it is to use a vertex next, given where it
+// sits in the cache (-1 = not cached) and how many triangles
+// still need it
+// --------------------------------------------------------
+static float ScoreVertex(int cachePosition, unsigned int remainingTriangles)
+{
+	// No triangles left means it can never be used again
+	if (remainingTriangles == 0)
+		return -1.0f;
+
+	float score = 0.0f;
+	if (cachePosition >= 0)
+	{
+		if (cachePosition < 3)
+		{
+			// Used by the last triangle - a fixed score, so that
+			// no particular winding is favoured
+			score = LastTriangleScore;
+		}
+		else
+		{
+			// Points for being high in the cache
+			const float scaler = 1.0f / (ForsythCacheSize - 3);
+			score = 1.0f - (cachePosition - 3) * scaler;
+			score = powf(score, CacheDecayPower);
+		}
+	}
+
+	// Bonus for having few triangles left, so lone
+	// vertices get finished off instead of lingering
+	score += ValenceBoostScale * powf((float)remainingTriangles, -ValenceBoostPower);
+	return score;
+}
+
+VertexCacheStats AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize)
+{
+	VertexCacheStats stats = {};
+
+	// A vertex is still in the FIFO if fewer than "cacheSize"
+	// vertices have been pushed since it was pushed
+	std::vector<unsigned int> pushedAt(vertexCount, 0);
+	unsigned int timestamp = cacheSize + 1;
+
+	for (size_t i = 0; i < indexCount; i++)
+	{
+		unsigned int v = indices[i];
+		if (timestamp - pushedAt[v] > cacheSize)
+		{
+			pushedAt[v] = timestamp++;
+			stats.transformedVertices++;
+		}
+	}
+
+	size_t triangleCount = indexCount / 3;
+	stats.acmr = triangleCount ? (float)stats.transformedVertices / triangleCount : 0.0f;
+	stats.atvr = vertexCount ? (float)stats.transformedVertices / vertexCount : 0.0f;
+	return stats;
+}
+
+void OptimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount)
+{
+	size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+		return;
+
+	// Triangles using each vertex, as one flat array (CSR) - the
+	// first "remaining[v]" entries of each list are still unused
+	std::vector<unsigned int> remaining(vertexCount, 0);
+	for (size_t i = 0; i < triangleCount * 3; i++)
+		remaining[indices[i]]++;
+
+	std::vector<unsigned int> firstTriangle(vertexCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; v++)
+		firstTriangle[v + 1] = firstTriangle[v] + remaining[v];
+
+	std::vector<unsigned int> adjacency(triangleCount * 3);
+	{
+		std::vector<unsigned int> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+		for (size_t t = 0; t < triangleCount; t++)
+			for (int k = 0; k < 3; k++)
+				adjacency[fill[indices[t * 3 + k]]++] = (unsigned int)t;
+	}
+
+	// Starting scores
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++)
+		vertexScore[v] = ScoreVertex(-1, remaining[v]);
+
+	std::vector<float> triangleScore(triangleCount);
+	std::vector<bool> emitted(triangleCount, false);
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		triangleScore[t] =
+			vertexScore[indices[t * 3 + 0]] +
+			vertexScore[indices[t * 3 + 1]] +
+			vertexScore[indices[t * 3 + 2]];
+	}
+
+	std::vector<unsigned int> output(triangleCount * 3);
+
+	// The LRU cache (with room for the 3 vertices being added)
+	int cache[ForsythCacheSize + 3];
+	int cacheCount = 0;
+
+	size_t scanCursor = 0;	// Everything before this has been emitted
+	int bestTriangle = -1;
+	for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+	{
+		// No good candidate next to the cache - take the best of
+		// the next few remaining triangles.  The cursor only moves
+		// forward and the window is fixed, so this stays linear even
+		// when most triangles share no vertices (every one of them a
+		// dead end).
+		if (bestTriangle < 0)
+		{
+			while (emitted[scanCursor])
+				scanCursor++;
+
+			bestTriangle = (int)scanCursor;
+			size_t scanEnd = std::min(triangleCount, scanCursor + DeadEndWindow);
+			for (size_t t = scanCursor; t < scanEnd; t++)
+			{
+				if (!emitted[t] && triangleScore[t] > triangleScore[bestTriangle])
+					bestTriangle = (int)t;
+			}
+		}
+
+		// Emit it
+		unsigned int* tri = &indices[bestTriangle * 3];
+		memcpy(&output[emittedCount * 3], tri, sizeof(unsigned int) * 3);
+		emitted[bestTriangle] = true;
+
+		// Take it off its vertices' lists of remaining triangles
+		for (int k = 0; k < 3; k++)
+		{
+			unsigned int v = tri[k];
+			unsigned int* list = &adjacency[firstTriangle[v]];
+			for (unsigned int i = 0; i < remaining[v]; i++)
+			{
+				if (list[i] == (unsigned int)bestTriangle)
+				{
+					list[i] = list[remaining[v] - 1];
+					break;
+				}
+			}
+			remaining[v]--;
+		}
+
+		// Move its vertices to the front of the cache
+		int newCache[ForsythCacheSize + 3];
+		int newCount = 0;
+		for (int k = 0; k < 3; k++)
+			newCache[newCount++] = (int)tri[k];
+		for (int i = 0; i < cacheCount; i++)
+		{
+			int v = cache[i];
+			if (v != (int)tri[0] && v != (int)tri[1] && v != (int)tri[2])
+				newCache[newCount++] = v;
+		}
+
+		// Anything pushed out of the cache loses its cache score
+		for (int i = ForsythCacheSize; i < newCount; i++)
+		{
+			int v = newCache[i];
+			cachePosition[v] = -1;
+			vertexScore[v] = ScoreVertex(-1, remaining[v]);
+		}
+		if (newCount > ForsythCacheSize)
+			newCount = ForsythCacheSize;
+
+		// Re-score everything still cached, and every triangle they touch,
+		// picking the best of those as the next triangle
+		for (int i = 0; i < newCount; i++)
+		{
+			int v = newCache[i];
+			cachePosition[v] = i;
+			vertexScore[v] = ScoreVertex(i, remaining[v]);
+		}
+
+		bestTriangle = -1;
+		float bestScore = -1.0f;
+		for (int i = 0; i < newCount; i++)
+		{
+			int v = newCache[i];
+			const unsigned int* list = &adjacency[firstTriangle[v]];
+			for (unsigned int j = 0; j < remaining[v]; j++)
+			{
+				unsigned int t = list[j];
+				float score =
+					vertexScore[indices[t * 3 + 0]] +
+					vertexScore[indices[t * 3 + 1]] +
+					vertexScore[indices[t * 3 + 2]];
+				triangleScore[t] = score;
+				if (score > bestScore)
+				{
+					bestScore = score;
+					bestTriangle = (int)t;
+				}
+			}
+		}
+
+		memcpy(cache, newCache, sizeof(int) * newCount);
+		cacheCount = newCount;
+	}
+
+	memcpy(indices, &output[0], sizeof(unsigned int) * triangleCount * 3);
+}
+
+size_t OptimizeVertexFetch(void* vertices, size_t vertexCount, size_t vertexSize, unsigned int* indices, size_t indexCount)
+{
+	const unsigned int Unassigned = 0xFFFFFFFF;
+
+	// Hand out new numbers in order of first use
+	std::vector<unsigned int> remap(vertexCount, Unassigned);
+	unsigned int nextVertex = 0;
+	for (size_t i = 0; i < indexCount; i++)
+	{
+		unsigned int& newIndex = remap[indices[i]];
+		if (newIndex == Unassigned)
+			newIndex = nextVertex++;
+		indices[i] = newIndex;
+	}
+
+	// Move the vertices to match (through a copy, since the
+	// new order can shuffle them arbitrarily)
+	if (nextVertex > 0)
+	{
+		unsigned char* data = (unsigned char*)vertices;
+		std::vector<unsigned char> original(data, data + vertexCount * vertexSize);
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			if (remap[v] != Unassigned)
+				memcpy(data + remap[v] * vertexSize, &original[v * vertexSize], vertexSize);
+		}
+	}
+
+	return nextVertex;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+
+// --------------------------------------------------------
+// Index/vertex reordering passes for triangle lists
+//
+// These work on plain arrays (no DirectX), so they can run
+// at load time, offline, or in a headless test.
+// --------------------------------------------------------
+
+// --------------------------------------------------------
+// Results of simulating a FIFO post-transform vertex cache
+// - ACMR: vertex shader runs per triangle (0.5 is the ideal
+//    for big regular meshes, 3.0 means no reuse at all)
+// - ATVR: vertex shader runs per unique vertex (1.0 is ideal)
+// --------------------------------------------------------
+struct VertexCacheStats
+{
+	unsigned int transformedVertices;	// Cache misses
+	float acmr;
+	float atvr;
+};
+
+// --------------------------------------------------------
+// Simulates a FIFO vertex cache of the given size over the
+// index list (3 indices per triangle)
+// --------------------------------------------------------
+VertexCacheStats AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize = 16);
+
+// --------------------------------------------------------
+// Reorders the triangles in place to improve post-transform
+// cache hits (Tom Forsyth's linear-speed algorithm)
+// - Only the triangle order changes; every triangle keeps
+//    its vertices and winding
+// --------------------------------------------------------
+void OptimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount);
+
+// --------------------------------------------------------
+// Renumbers vertices in the order the index list first uses
+// them (and remaps the indices to match), so that vertex
+// fetches walk forward through memory
+// - Run this AFTER OptimizeVertexCache(), since it follows
+//    the final triangle order
+// - Works on any vertex type: vertexSize is its size in bytes
+// - Vertices no triangle uses are dropped; returns the number
+//    of vertices left at the front of the array
+// --------------------------------------------------------
+size_t OptimizeVertexFetch(void* vertices, size_t vertexCount, size_t vertexSize, unsigned int* indices, size_t indexCount);
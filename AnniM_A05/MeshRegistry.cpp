@@ -0,0 +1,215 @@
+#include "MeshRegistry.h"
+#include "MeshCache.h"
+#include "MappedFile.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <climits>
+#endif
+
+// --------------------------------------------------------
+// Absolute path with "." and ".." resolved (and symlinks, on
+// POSIX), lowercased on Windows' case-insensitive file system
+// - Falls back to the path as given if it can't be resolved
+// --------------------------------------------------------
+static std::string GetCanonicalPath(const char* file)
+{
+#ifdef _WIN32
+	char full[MAX_PATH];
+	DWORD length = GetFullPathNameA(file, MAX_PATH, full, 0);
+	if (length == 0 || length >= MAX_PATH)
+		return file;
+
+	std::string path(full, length);
+	for (size_t i = 0; i < path.size(); i++)
+		path[i] = path[i] == '/' ? '\\' : (char)tolower((unsigned char)path[i]);
+	return path;
+#else
+	char full[PATH_MAX];
+	if (!realpath(file, full))
+		return file;
+	return full;
+#endif
+}
+
+MeshRegistry::MeshRegistry(ID3D11Device* device, MeshLoader* loader)
+{
+	this->device = device;
+	this->loader = loader;
+}
+
+// --------------------------------------------------------
+// Deletes any meshes still referenced (a leak in the caller,
+// reported in debug builds)
+// --------------------------------------------------------
+MeshRegistry::~MeshRegistry()
+{
+#if defined(DEBUG) || defined(_DEBUG)
+	if (!byMesh.empty())
+		printf("MeshRegistry: %u mesh(es) still referenced at shutdown\n", (unsigned int)byMesh.size());
+#endif
+
+	for (auto it = byMesh.begin(); it != byMesh.end(); ++it)
+	{
+		delete it->second->mesh;
+		delete it->second;
+	}
+}
+
+Mesh* MeshRegistry::Acquire(const char* file, VertexFormat format)
+{
+	// The format is part of the key - each one has its own buffers
+	const char* formatNames[] = { "|full", "|compact", "|tangent" };
+	std::string path = GetCanonicalPath(file);
+	std::string key = path + formatNames[(int)format];
+	auto found = byPath.find(key);
+	if (found != byPath.end())
+	{
+		found->second->refCount++;
+		return found->second->mesh;
+	}
+
+	// A path we haven't seen - but maybe a copy of a file we have,
+	// which can only be one the same size
+	uint64_t size = 0;
+	int64_t modifiedTime;
+	bool sized = GetSourceInfo(file, size, modifiedTime);
+
+	Entry* entry = new Entry();
+	entry->format = format;
+	entry->file = path;
+	entry->sourceSize = size;
+	entry->sourceHash = 0;
+	entry->hashed = false;
+	entry->refCount = 1;
+
+	if (sized)
+	{
+		auto range = bySize.equal_range(size);
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			Entry* other = it->second;
+			if (other->format != format || !Hash(entry) || !Hash(other) || other->sourceHash != entry->sourceHash)
+				continue;
+
+			delete entry;
+			other->keys.push_back(key);
+			byPath[key] = other;
+			other->refCount++;
+			return other->mesh;
+		}
+	}
+
+	entry->mesh = loader ? loader->Load(file, format) : new Mesh(file, device, format);
+	entry->keys.push_back(key);
+
+	byPath[key] = entry;
+	byMesh[entry->mesh] = entry;
+	if (sized)
+		bySize.insert(std::make_pair(size, entry));
+	return entry->mesh;
+}
+
+// --------------------------------------------------------
+// Hashes the entry's file, if it hasn't been already
+// - False if the file can't be read
+// --------------------------------------------------------
+bool MeshRegistry::Hash(Entry* entry)
+{
+	if (entry->hashed)
+		return true;
+
+	MappedFile source(entry->file.c_str());
+	if (!source.GetData())
+		return false;
+
+	entry->sourceHash = HashBytes(source.GetData(), source.GetSize());
+	entry->hashed = true;
+	return true;
+}
+
+unsigned int MeshRegistry::AddRef(Mesh* mesh)
+{
+	auto found = byMesh.find(mesh);
+	if (found == byMesh.end())
+		return 0;
+	return ++found->second->refCount;
+}
+
+// --------------------------------------------------------
+// Drops a reference, deleting the mesh once none are left
+// - Returns the references left
+// --------------------------------------------------------
+unsigned int MeshRegistry::Release(Mesh* mesh)
+{
+	auto found = byMesh.find(mesh);
+	if (found == byMesh.end())
+		return 0;
+
+	Entry* entry = found->second;
+	if (--entry->refCount > 0)
+		return entry->refCount;
+
+	// It may not have finished loading (it was released before
+	// it ever got drawn) - stop that first, without waiting for
+	// the rest of the queue
+	if (loader && mesh->GetState() == MeshState::Loading)
+		loader->Cancel(mesh);
+
+	Remove(entry);
+	return 0;
+}
+
+void MeshRegistry::Remove(Entry* entry)
+{
+	for (size_t i = 0; i < entry->keys.size(); i++)
+		byPath.erase(entry->keys[i]);
+
+	auto range = bySize.equal_range(entry->sourceSize);
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		if (it->second == entry)
+		{
+			bySize.erase(it);
+			break;
+		}
+	}
+
+	byMesh.erase(entry->mesh);
+	delete entry->mesh;
+	delete entry;
+}
+
+unsigned int MeshRegistry::GetMeshCount()
+{
+	return (unsigned int)byMesh.size();
+}
+
+size_t MeshRegistry::GetResidentBytes()
+{
+	size_t total = 0;
+	for (auto it = byMesh.begin(); it != byMesh.end(); ++it)
+	{
+		if (it->first->IsReady())
+			total += it->first->GetResidentBytes();
+	}
+	return total;
+}
+
+void MeshRegistry::PrintReport()
+{
+	printf("MeshRegistry: %u mesh(es), %.2f KB resident\n", GetMeshCount(), GetResidentBytes() / 1024.0);
+	for (auto it = byMesh.begin(); it != byMesh.end(); ++it)
+	{
+		Entry* entry = it->second;
+		if (entry->mesh->IsReady())
+			printf("  %s: %u reference(s), %.2f KB\n", entry->keys[0].c_str(), entry->refCount, entry->mesh->GetResidentBytes() / 1024.0);
+		else
+			printf("  %s: %u reference(s), %s\n", entry->keys[0].c_str(), entry->refCount,
+				entry->mesh->GetState() == MeshState::Loading ? "loading" : "failed");
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <d3d11.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Mesh.h"
+#include "MeshLoader.h"
+
+// --------------------------------------------------------
+// Shares meshes between everything that uses them
+//
+// Acquire() hands out one Mesh per file (and vertex format),
+// reference counted like a COM object: every Acquire() needs a
+// matching Release(), and the mesh - with its GPU buffers - is
+// deleted when the last reference goes.
+//
+// Files are matched by canonical path first, then by contents,
+// so "cone.obj", "./cone.obj" and an identical copy elsewhere
+// all share one set of buffers.  Only the size of a new path is
+// read up front - its contents are hashed only when it's the
+// same size as a mesh already here (and that mesh's file is
+// hashed the first time it's compared), so acquiring a new file
+// doesn't read it on the calling thread.
+//
+// Not thread-safe - use it from the main thread.  Loading can
+// still happen in the background, through a MeshLoader (delete
+// the loader before releasing meshes at shutdown, so queued
+// loads are cancelled rather than waited for).
+// --------------------------------------------------------
+class MeshRegistry
+{
+	struct Entry
+	{
+		Mesh* mesh;
+		VertexFormat format;
+		std::string file;		// Canonical path it was loaded from
+		uint64_t sourceSize;
+		uint64_t sourceHash;	// Only once hashed is set
+		bool hashed;
+		unsigned int refCount;
+		std::vector<std::string> keys;	// Every path it's been acquired by
+	};
+
+	ID3D11Device* device;
+	MeshLoader* loader;
+	std::unordered_map<std::string, Entry*> byPath;
+	std::unordered_multimap<uint64_t, Entry*> bySize;
+	std::unordered_map<Mesh*, Entry*> byMesh;
+
+	bool Hash(Entry* entry);
+	void Remove(Entry* entry);
+public:
+	// loader - optional; without one, meshes load synchronously
+	MeshRegistry(ID3D11Device* device, MeshLoader* loader = 0);
+	~MeshRegistry();
+
+	Mesh* Acquire(const char* file, VertexFormat format = VertexFormat::Full);
+	unsigned int AddRef(Mesh* mesh);
+	unsigned int Release(Mesh* mesh);
+
+	unsigned int GetMeshCount();
+	size_t GetResidentBytes();
+
+	// Prints every mesh with its references and resident bytes
+	void PrintReport();
+
+	MeshRegistry(const MeshRegistry&) = delete;
+	MeshRegistry& operator=(const MeshRegistry&) = delete;
+};
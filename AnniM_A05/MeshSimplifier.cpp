@@ -0,0 +1,416 @@
+#include "MeshSimplifier.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// A symmetric 4x4 error quadric - the sum of squared
+// distances to a set of planes, for any point
+// --------------------------------------------------------
+struct Quadric
+{
+	double a2, ab, ac, ad;
+	double b2, bc, bd;
+	double c2, cd;
+	double d2;
+};
+
+static void AddQuadric(Quadric& q, const Quadric& other)
+{
+	q.a2 += other.a2; q.ab += other.ab; q.ac += other.ac; q.ad += other.ad;
+	q.b2 += other.b2; q.bc += other.bc; q.bd += other.bd;
+	q.c2 += other.c2; q.cd += other.cd;
+	q.d2 += other.d2;
+}
+
+static void AddPlane(Quadric& q, double a, double b, double c, double d)
+{
+	q.a2 += a * a; q.ab += a * b; q.ac += a * c; q.ad += a * d;
+	q.b2 += b * b; q.bc += b * c; q.bd += b * d;
+	q.c2 += c * c; q.cd += c * d;
+	q.d2 += d * d;
+}
+
+static double EvaluateQuadric(const Quadric& q, const XMFLOAT3& p)
+{
+	double x = p.x, y = p.y, z = p.z;
+	double error =
+		q.a2 * x * x + q.b2 * y * y + q.c2 * z * z +
+		2.0 * (q.ab * x * y + q.ac * x * z + q.bc * y * z) +
+		2.0 * (q.ad * x + q.bd * y + q.cd * z) +
+		q.d2;
+	return error > 0.0 ? error : 0.0;
+}
+
+static XMFLOAT3 TriangleNormal(const XMFLOAT3& p0, const XMFLOAT3& p1, const XMFLOAT3& p2)
+{
+	float e1x = p1.x - p0.x, e1y = p1.y - p0.y, e1z = p1.z - p0.z;
+	float e2x = p2.x - p0.x, e2y = p2.y - p0.y, e2z = p2.z - p0.z;
+	return XMFLOAT3(e1y * e2z - e1z * e2y, e1z * e2x - e1x * e2z, e1x * e2y - e1y * e2x);
+}
+
+// --------------------------------------------------------
+// Hash for grouping vertices with bit-identical positions
+// --------------------------------------------------------
+struct PositionKey
+{
+	unsigned int x, y, z;
+	bool operator==(const PositionKey& other) const
+	{
+		return x == other.x && y == other.y && z == other.z;
+	}
+};
+
+struct PositionKeyHash
+{
+	size_t operator()(const PositionKey& key) const
+	{
+		return (size_t)(key.x * 73856093u) ^ (size_t)(key.y * 19349663u) ^ (size_t)(key.z * 83492791u);
+	}
+};
+
+size_t SimplifyMesh(
+	const Vertex* vertices, size_t vertexCount,
+	const unsigned int* indices, size_t indexCount,
+	size_t targetIndexCount, float maxError,
+	unsigned int* destination, float* resultError)
+{
+	const unsigned int None = 0xFFFFFFFF;
+
+	indexCount -= indexCount % 3;
+	std::vector<unsigned int> current(indices, indices + indexCount);
+	double reachedError = 0.0;
+
+	// Group vertices by position - a group with more than one
+	// vertex sits on a UV/normal seam, and the whole group
+	// moves together
+	std::vector<unsigned int> positionGroup(vertexCount);
+	size_t groupCount = 0;
+	{
+		std::unordered_map<PositionKey, unsigned int, PositionKeyHash> groups;
+		groups.reserve(vertexCount);
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			PositionKey key;
+			memcpy(&key, &vertices[v].Position, sizeof(key));
+			positionGroup[v] = groups.emplace(key, (unsigned int)groups.size()).first->second;
+		}
+		groupCount = groups.size();
+	}
+
+	// Vertices in each group (CSR)
+	std::vector<unsigned int> firstInGroup(groupCount + 1, 0);
+	std::vector<unsigned int> groupVertices(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++)
+		firstInGroup[positionGroup[v] + 1]++;
+	for (size_t g = 0; g < groupCount; g++)
+		firstInGroup[g + 1] += firstInGroup[g];
+	{
+		std::vector<unsigned int> fill(firstInGroup.begin(), firstInGroup.end() - 1);
+		for (size_t v = 0; v < vertexCount; v++)
+			groupVertices[fill[positionGroup[v]]++] = (unsigned int)v;
+	}
+
+	// An edge used by only one triangle is on an open border,
+	// and border vertices stay put
+	std::vector<bool> locked(groupCount, false);
+	{
+		std::unordered_map<unsigned long long, unsigned int> edgeUses;
+		edgeUses.reserve(indexCount);
+		for (size_t i = 0; i < indexCount; i++)
+		{
+			unsigned int a = positionGroup[current[i]];
+			unsigned int b = positionGroup[current[i % 3 == 2 ? i - 2 : i + 1]];
+			unsigned long long key = a < b ? ((unsigned long long)a << 32) | b : ((unsigned long long)b << 32) | a;
+			edgeUses[key]++;
+		}
+		for (auto it = edgeUses.begin(); it != edgeUses.end(); ++it)
+		{
+			if (it->second == 1)
+			{
+				locked[(unsigned int)(it->first >> 32)] = true;
+				locked[(unsigned int)(it->first & 0xFFFFFFFF)] = true;
+			}
+		}
+	}
+
+	// Every position starts with the planes of its triangles
+	std::vector<Quadric> quadrics(groupCount);
+	memset(&quadrics[0], 0, sizeof(Quadric) * groupCount);
+	for (size_t t = 0; t < indexCount; t += 3)
+	{
+		const XMFLOAT3& p0 = vertices[current[t + 0]].Position;
+		XMFLOAT3 n = TriangleNormal(p0, vertices[current[t + 1]].Position, vertices[current[t + 2]].Position);
+		double length = sqrt((double)n.x * n.x + (double)n.y * n.y + (double)n.z * n.z);
+		if (length <= 0.0)
+			continue;
+
+		double a = n.x / length, b = n.y / length, c = n.z / length;
+		double d = -(a * p0.x + b * p0.y + c * p0.z);
+		for (int k = 0; k < 3; k++)
+			AddPlane(quadrics[positionGroup[current[t + k]]], a, b, c, d);
+	}
+
+	std::vector<unsigned int> remap(vertexCount);
+	std::vector<unsigned int> firstTriangle(vertexCount + 1);
+	std::vector<unsigned int> adjacency;
+	std::vector<unsigned int> bestTarget(groupCount);
+	std::vector<double> bestCost(groupCount);
+	std::vector<unsigned int> order;
+	std::vector<bool> touched(groupCount);
+	double maxCost = (double)maxError * (double)maxError;
+
+	// Collapse in passes: pick the cheapest collapses that don't
+	// interfere with each other, apply them, drop degenerate
+	// triangles and go again
+	while (current.size() > targetIndexCount)
+	{
+		size_t triangleCount = current.size() / 3;
+
+		// Triangles around each vertex (CSR)
+		std::fill(firstTriangle.begin(), firstTriangle.end(), 0);
+		for (size_t i = 0; i < current.size(); i++)
+			firstTriangle[current[i] + 1]++;
+		for (size_t v = 0; v < vertexCount; v++)
+			firstTriangle[v + 1] += firstTriangle[v];
+		adjacency.resize(current.size());
+		{
+			std::vector<unsigned int> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+			for (size_t i = 0; i < current.size(); i++)
+				adjacency[fill[current[i]]++] = (unsigned int)(i / 3);
+		}
+
+		// The cheapest neighbour to collapse each position onto
+		std::fill(bestTarget.begin(), bestTarget.end(), None);
+		for (size_t i = 0; i < current.size(); i++)
+		{
+			unsigned int a = current[i];
+			unsigned int b = current[i % 3 == 2 ? i - 2 : i + 1];
+			for (int direction = 0; direction < 2; direction++)
+			{
+				unsigned int from = positionGroup[a];
+				if (!locked[from])
+				{
+					double cost = EvaluateQuadric(quadrics[from], vertices[b].Position);
+					if (bestTarget[from] == None || cost < bestCost[from])
+					{
+						bestTarget[from] = positionGroup[b];
+						bestCost[from] = cost;
+					}
+				}
+				std::swap(a, b);
+			}
+		}
+
+		order.clear();
+		for (size_t g = 0; g < groupCount; g++)
+		{
+			if (bestTarget[g] != None && bestCost[g] <= maxCost)
+				order.push_back((unsigned int)g);
+		}
+		std::sort(order.begin(), order.end(),
+			[&](unsigned int a, unsigned int b) { return bestCost[a] < bestCost[b]; });
+
+		// Each collapse removes about two triangles
+		size_t wanted = (current.size() - targetIndexCount) / 6 + 1;
+		size_t collapses = 0;
+		std::fill(touched.begin(), touched.end(), false);
+		for (size_t v = 0; v < vertexCount; v++)
+			remap[v] = (unsigned int)v;
+
+		for (size_t c = 0; c < order.size() && collapses < wanted; c++)
+		{
+			unsigned int from = order[c];
+			unsigned int to = bestTarget[from];
+			if (touched[from] || touched[to])
+				continue;
+
+			// Every vertex at 'from' has to land on exactly one vertex
+			// at 'to' - the one on its own side of any seam - and no
+			// remaining triangle may flip over
+			bool allowed = true;
+			const XMFLOAT3& target = vertices[groupVertices[firstInGroup[to]]].Position;
+			for (unsigned int f = firstInGroup[from]; f < firstInGroup[from + 1] && allowed; f++)
+			{
+				unsigned int v = groupVertices[f];
+				remap[v] = None;
+				for (unsigned int j = firstTriangle[v]; j < firstTriangle[v + 1] && allowed; j++)
+				{
+					const unsigned int* tri = &current[adjacency[j] * 3];
+					bool degenerate = false;
+					for (int k = 0; k < 3; k++)
+					{
+						if (positionGroup[tri[k]] != to)
+							continue;
+						if (remap[v] != None && remap[v] != tri[k])
+							allowed = false;
+						remap[v] = tri[k];
+						degenerate = true;
+					}
+					if (degenerate)
+						continue;
+
+					XMFLOAT3 before[3], after[3];
+					for (int k = 0; k < 3; k++)
+					{
+						before[k] = vertices[tri[k]].Position;
+						after[k] = tri[k] == v ? target : before[k];
+					}
+
+					XMFLOAT3 n0 = TriangleNormal(before[0], before[1], before[2]);
+					XMFLOAT3 n1 = TriangleNormal(after[0], after[1], after[2]);
+					if (n0.x * n1.x + n0.y * n1.y + n0.z * n1.z <= 0.0f)
+						allowed = false;
+				}
+
+				// Unused vertices can simply stay where they are
+				if (remap[v] == None)
+					remap[v] = firstTriangle[v] == firstTriangle[v + 1] ? v : None;
+				if (remap[v] == None)
+					allowed = false;
+			}
+
+			if (!allowed)
+			{
+				for (unsigned int f = firstInGroup[from]; f < firstInGroup[from + 1]; f++)
+					remap[groupVertices[f]] = groupVertices[f];
+				continue;
+			}
+
+			AddQuadric(quadrics[to], quadrics[from]);
+			reachedError = std::max(reachedError, bestCost[from]);
+			collapses++;
+
+			// Everything around the collapse is out of date until
+			// the next pass
+			for (unsigned int f = firstInGroup[from]; f < firstInGroup[from + 1]; f++)
+			{
+				unsigned int v = groupVertices[f];
+				for (unsigned int j = firstTriangle[v]; j < firstTriangle[v + 1]; j++)
+				{
+					const unsigned int* tri = &current[adjacency[j] * 3];
+					for (int k = 0; k < 3; k++)
+						touched[positionGroup[tri[k]]] = true;
+				}
+			}
+			touched[from] = touched[to] = true;
+		}
+
+		if (collapses == 0)
+			break;
+
+		// Apply the collapses and drop triangles that became degenerate
+		size_t write = 0;
+		for (size_t t = 0; t < triangleCount; t++)
+		{
+			unsigned int a = remap[current[t * 3 + 0]];
+			unsigned int b = remap[current[t * 3 + 1]];
+			unsigned int c = remap[current[t * 3 + 2]];
+			if (a == b || b == c || a == c)
+				continue;
+
+			current[write++] = a;
+			current[write++] = b;
+			current[write++] = c;
+		}
+		current.resize(write);
+	}
+
+	if (!current.empty())
+		memcpy(destination, &current[0], current.size() * sizeof(unsigned int));
+	if (resultError)
+		*resultError = (float)sqrt(reachedError);
+	return current.size();
+}
+
+std::vector<MeshLod> BuildLodChain(
+	const Vertex* vertices, size_t vertexCount,
+	std::vector<unsigned int>& indices,
+	unsigned int maxLevels, float reduction)
+{
+	std::vector<unsigned int> rangeCounts(1, (unsigned int)indices.size());
+	std::vector<unsigned int> levelRangeCounts;
+	return BuildLodChain(vertices, vertexCount, indices, rangeCounts, levelRangeCounts, maxLevels, reduction);
+}
+
+std::vector<MeshLod> BuildLodChain(
+	const Vertex* vertices, size_t vertexCount,
+	std::vector<unsigned int>& indices,
+	const std::vector<unsigned int>& rangeCounts,
+	std::vector<unsigned int>& levelRangeCounts,
+	unsigned int maxLevels, float reduction)
+{
+	std::vector<MeshLod> lods;
+	size_t originalCount = indices.size();
+	size_t rangeCount = rangeCounts.size();
+
+	MeshLod full = { 0, (unsigned int)originalCount, 0.0f };
+	lods.push_back(full);
+	levelRangeCounts.assign(rangeCounts.begin(), rangeCounts.end());
+
+	// Where each range starts in the original indices
+	std::vector<size_t> rangeStarts(rangeCount, 0);
+	for (size_t r = 1; r < rangeCount; r++)
+		rangeStarts[r] = rangeStarts[r - 1] + rangeCounts[r - 1];
+
+	// Each level starts from the full mesh (not the previous
+	// level), so its error is measured against the original
+	std::vector<unsigned int> original(indices);
+	std::vector<unsigned int> simplified(originalCount);
+	std::vector<size_t> targets(rangeCounts.begin(), rangeCounts.end());
+	std::vector<size_t> previousStarts(rangeStarts);	// Each range in the level before
+	std::vector<float> rangeErrors(rangeCount, 0.0f);
+	for (unsigned int level = 1; level < maxLevels; level++)
+	{
+		size_t count = 0;
+		float error = 0.0f;
+		bool anyReduced = false;
+		std::vector<size_t> starts(rangeCount);
+		std::vector<unsigned int> counts(rangeCount);
+		for (size_t r = 0; r < rangeCount; r++)
+		{
+			const unsigned int previousCount = levelRangeCounts[(level - 1) * rangeCount + r];
+			targets[r] = (size_t)(targets[r] * reduction);
+			targets[r] -= targets[r] % 3;
+
+			size_t rangeResult = 0;
+			float rangeError = 0.0f;
+			if (targets[r] >= 3)
+				rangeResult = SimplifyMesh(vertices, vertexCount, &original[rangeStarts[r]], rangeCounts[r], targets[r], FLT_MAX, &simplified[count], &rangeError);
+
+			if (rangeResult == 0 || rangeResult >= previousCount)
+			{
+				// Nothing gained - keep what the previous level had
+				// (along with its error)
+				if (previousCount)
+					memcpy(&simplified[count], &indices[previousStarts[r]], previousCount * sizeof(unsigned int));
+				rangeResult = previousCount;
+			}
+			else
+			{
+				rangeErrors[r] = rangeError;
+				anyReduced = true;
+			}
+
+			starts[r] = indices.size() + count;
+			counts[r] = (unsigned int)rangeResult;
+			count += rangeResult;
+			error = rangeErrors[r] > error ? rangeErrors[r] : error;
+		}
+
+		if (!anyReduced || count > lods.back().indexCount * 9 / 10)
+			break;
+
+		MeshLod lod = { (unsigned int)indices.size(), (unsigned int)count, error };
+		indices.insert(indices.end(), simplified.begin(), simplified.begin() + count);
+		lods.push_back(lod);
+		levelRangeCounts.insert(levelRangeCounts.end(), counts.begin(), counts.end());
+		previousStarts = starts;
+	}
+
+	return lods;
+}
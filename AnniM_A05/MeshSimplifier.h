@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include "Vertex.h"
+
+// --------------------------------------------------------
+// Quadric error mesh simplification (Garland & Heckbert)
+//
+// Simplified meshes only ever collapse a vertex onto one of its
+// neighbours, so every level of detail can index the original
+// vertex array - LODs are just extra ranges in the index buffer.
+// Like MeshOptimizer this works on plain arrays (no DirectX).
+// --------------------------------------------------------
+
+// --------------------------------------------------------
+// One level of detail: a range of the shared index buffer
+// - error is the largest geometric deviation (in mesh units)
+//    introduced by the simplification
+// --------------------------------------------------------
+struct MeshLod
+{
+	unsigned int startIndex;
+	unsigned int indexCount;
+	float error;
+};
+
+// --------------------------------------------------------
+// Simplifies the triangle list towards "targetIndexCount"
+// indices, stopping early if every remaining collapse would
+// cost more than "maxError" (in mesh units)
+// - Vertices sharing one position (a UV/normal seam) collapse
+//    as a group: each lands on the vertex at the target position
+//    that's on its own side of the seam, or the collapse is
+//    skipped, so seams stay intact
+// - Only vertices on open borders (edges used by one triangle)
+//    are locked, so silhouettes of open meshes are preserved
+// - Writes the new indices to "destination" (which needs room
+//    for indexCount indices) and returns how many were written
+// - resultError (optional) receives the error actually reached
+// --------------------------------------------------------
+size_t SimplifyMesh(
+	const Vertex* vertices, size_t vertexCount,
+	const unsigned int* indices, size_t indexCount,
+	size_t targetIndexCount, float maxError,
+	unsigned int* destination, float* resultError = 0);
+
+// --------------------------------------------------------
+// Builds a chain of LODs for the mesh
+// - Each level aims for "reduction" times the triangles of the
+//    one before, and is appended to the end of "indices"
+// - Level 0 is the original index range
+// - Stops early once a level can't remove at least 10% more
+//    triangles (everything left is locked or too costly)
+// --------------------------------------------------------
+std::vector<MeshLod> BuildLodChain(
+	const Vertex* vertices, size_t vertexCount,
+	std::vector<unsigned int>& indices,
+	unsigned int maxLevels = 4, float reduction = 0.5f);
+
+// --------------------------------------------------------
+// Same, for a mesh made of several back-to-back index ranges
+// (submeshes) that must stay apart
+// - "rangeCounts" has the index count of each range in level 0
+// - Ranges are simplified on their own, and edges they share
+//    with other ranges count as borders, so they never crack
+// - Every level keeps the ranges in the same order, back to
+//    back; "levelRangeCounts" receives their index counts, one
+//    set of rangeCounts.size() per level (level 0 included)
+// - A range too small to reduce any further just repeats its
+//    previous level, and a level's error is its worst range's
+// --------------------------------------------------------
+std::vector<MeshLod> BuildLodChain(
+	const Vertex* vertices, size_t vertexCount,
+	std::vector<unsigned int>& indices,
+	const std::vector<unsigned int>& rangeCounts,
+	std::vector<unsigned int>& levelRangeCounts,
+	unsigned int maxLevels = 4, float reduction = 0.5f);
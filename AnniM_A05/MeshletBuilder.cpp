@@ -0,0 +1,294 @@
+#include "MeshletBuilder.h"
+#include <cmath>
+
+using namespace DirectX;
+
+static XMFLOAT3 Subtract(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	return XMFLOAT3(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+static float Dot(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+static XMFLOAT3 Cross(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	return XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+
+// --------------------------------------------------------
+// Ritter's bounding sphere - not minimal, but within a few
+// percent and linear time
+// --------------------------------------------------------
+static void ComputeBoundingSphere(const Vertex* vertices, const unsigned int* indices, size_t indexCount, XMFLOAT3& center, float& radius)
+{
+	// Start with the sphere through two far apart points...
+	const XMFLOAT3& p0 = vertices[indices[0]].Position;
+	XMFLOAT3 a = p0, b = p0;
+	float farthest = 0.0f;
+	for (size_t i = 0; i < indexCount; i++)
+	{
+		XMFLOAT3 d = Subtract(vertices[indices[i]].Position, p0);
+		if (Dot(d, d) > farthest) { farthest = Dot(d, d); a = vertices[indices[i]].Position; }
+	}
+	farthest = 0.0f;
+	for (size_t i = 0; i < indexCount; i++)
+	{
+		XMFLOAT3 d = Subtract(vertices[indices[i]].Position, a);
+		if (Dot(d, d) > farthest) { farthest = Dot(d, d); b = vertices[indices[i]].Position; }
+	}
+
+	center = XMFLOAT3((a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f, (a.z + b.z) * 0.5f);
+	radius = sqrtf(farthest) * 0.5f;
+
+	// ...then grow it to take in any point left outside
+	for (size_t i = 0; i < indexCount; i++)
+	{
+		const XMFLOAT3& p = vertices[indices[i]].Position;
+		XMFLOAT3 d = Subtract(p, center);
+		float distance = sqrtf(Dot(d, d));
+		if (distance > radius)
+		{
+			float grow = (distance - radius) * 0.5f;
+			radius += grow;
+			float move = grow / distance;
+			center.x += d.x * move;
+			center.y += d.y * move;
+			center.z += d.z * move;
+		}
+	}
+
+	// Leave a little room for rounding in the tests
+	radius *= 1.0001f;
+}
+
+// --------------------------------------------------------
+// The normal cone: an axis within "angle" of every triangle's
+// normal, and an apex such that from any point inside the
+// (backwards) cone every triangle is seen from behind
+// - Triangle normals here point towards the viewer for front
+//    faces (clockwise winding, left-handed)
+// --------------------------------------------------------
+static void ComputeNormalCone(const Vertex* vertices, const unsigned int* indices, size_t indexCount, Meshlet& meshlet)
+{
+	meshlet.coneApex = meshlet.center;
+	meshlet.coneAxis = XMFLOAT3(0, 0, 0);
+	meshlet.coneCutoff = 1.0f;
+
+	XMFLOAT3 axis(0, 0, 0);
+	for (size_t i = 0; i < indexCount; i += 3)
+	{
+		const XMFLOAT3& p0 = vertices[indices[i + 0]].Position;
+		XMFLOAT3 n = Cross(Subtract(vertices[indices[i + 1]].Position, p0), Subtract(vertices[indices[i + 2]].Position, p0));
+		float length = sqrtf(Dot(n, n));
+		if (length <= 0.0f)
+			continue;
+
+		axis.x += n.x / length;
+		axis.y += n.y / length;
+		axis.z += n.z / length;
+	}
+
+	float axisLength = sqrtf(Dot(axis, axis));
+	if (axisLength <= 0.0f)
+		return;
+	axis = XMFLOAT3(axis.x / axisLength, axis.y / axisLength, axis.z / axisLength);
+
+	// How far the normals spread from the axis, and how far back
+	// the apex has to go so every triangle's plane is in front of it
+	float minDot = 1.0f;
+	float maxT = 0.0f;
+	for (size_t i = 0; i < indexCount; i += 3)
+	{
+		const XMFLOAT3& p0 = vertices[indices[i + 0]].Position;
+		XMFLOAT3 n = Cross(Subtract(vertices[indices[i + 1]].Position, p0), Subtract(vertices[indices[i + 2]].Position, p0));
+		float length = sqrtf(Dot(n, n));
+		if (length <= 0.0f)
+			continue;
+		n = XMFLOAT3(n.x / length, n.y / length, n.z / length);
+
+		float dp = Dot(axis, n);
+		if (dp < minDot)
+			minDot = dp;
+		if (dp <= 0.0f)
+			continue;
+
+		float t = Dot(Subtract(meshlet.center, p0), n) / dp;
+		if (t > maxT)
+			maxT = t;
+	}
+
+	// Cones wider than ~85 degrees (half angle) are useless
+	if (minDot <= 0.1f)
+		return;
+
+	meshlet.coneAxis = axis;
+	meshlet.coneApex = XMFLOAT3(
+		meshlet.center.x - axis.x * maxT,
+		meshlet.center.y - axis.y * maxT,
+		meshlet.center.z - axis.z * maxT);
+	meshlet.coneCutoff = sqrtf(1.0f - minDot * minDot);
+}
+
+std::vector<Meshlet> BuildMeshlets(
+	const Vertex* vertices, size_t vertexCount,
+	unsigned int* indices, size_t indexCount)
+{
+	std::vector<Meshlet> meshlets;
+	size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+		return meshlets;
+
+	// Triangles around each vertex (CSR)
+	std::vector<unsigned int> firstTriangle(vertexCount + 1, 0);
+	std::vector<unsigned int> adjacency(triangleCount * 3);
+	for (size_t i = 0; i < triangleCount * 3; i++)
+		firstTriangle[indices[i] + 1]++;
+	for (size_t v = 0; v < vertexCount; v++)
+		firstTriangle[v + 1] += firstTriangle[v];
+	{
+		std::vector<unsigned int> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+		for (size_t i = 0; i < triangleCount * 3; i++)
+			adjacency[fill[indices[i]]++] = (unsigned int)(i / 3);
+	}
+
+	std::vector<unsigned int> reordered;
+	reordered.reserve(triangleCount * 3);
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<unsigned int> inMeshlet(vertexCount, 0);	// Meshlet number + 1 that last used each vertex
+	std::vector<unsigned int> candidates;
+	size_t seed = 0;
+
+	while (reordered.size() < triangleCount * 3)
+	{
+		Meshlet meshlet = {};
+		meshlet.startIndex = (unsigned int)reordered.size();
+		unsigned int stamp = (unsigned int)meshlets.size() + 1;
+		unsigned int triangles = 0;
+		candidates.clear();
+
+		while (triangles < MeshletMaxTriangles)
+		{
+			// The neighbouring triangle that adds the fewest vertices
+			// (the earliest one on ties, to keep the cache order)
+			unsigned int best = 0xFFFFFFFF;
+			unsigned int bestNew = 4;
+			size_t write = 0;
+			for (size_t c = 0; c < candidates.size(); c++)
+			{
+				unsigned int t = candidates[c];
+				if (emitted[t])
+					continue;
+				candidates[write++] = t;
+
+				unsigned int added =
+					(inMeshlet[indices[t * 3 + 0]] != stamp) +
+					(inMeshlet[indices[t * 3 + 1]] != stamp) +
+					(inMeshlet[indices[t * 3 + 2]] != stamp);
+				if (added < bestNew || (added == bestNew && t < best))
+				{
+					best = t;
+					bestNew = added;
+				}
+			}
+			candidates.resize(write);
+
+			// Nothing connected left - carry on with the next triangle
+			// in the original order
+			if (best == 0xFFFFFFFF)
+			{
+				while (seed < triangleCount && emitted[seed])
+					seed++;
+				if (seed == triangleCount)
+					break;
+
+				best = (unsigned int)seed;
+				bestNew =
+					(inMeshlet[indices[best * 3 + 0]] != stamp) +
+					(inMeshlet[indices[best * 3 + 1]] != stamp) +
+					(inMeshlet[indices[best * 3 + 2]] != stamp);
+			}
+
+			if (meshlet.vertexCount + bestNew > MeshletMaxVertices)
+				break;
+
+			emitted[best] = true;
+			triangles++;
+			for (int k = 0; k < 3; k++)
+			{
+				unsigned int v = indices[best * 3 + k];
+				reordered.push_back(v);
+				if (inMeshlet[v] != stamp)
+				{
+					inMeshlet[v] = stamp;
+					meshlet.vertexCount++;
+					for (unsigned int j = firstTriangle[v]; j < firstTriangle[v + 1]; j++)
+					{
+						if (!emitted[adjacency[j]])
+							candidates.push_back(adjacency[j]);
+					}
+				}
+			}
+		}
+
+		meshlet.indexCount = (unsigned int)reordered.size() - meshlet.startIndex;
+		meshlets.push_back(meshlet);
+	}
+
+	for (size_t i = 0; i < triangleCount * 3; i++)
+		indices[i] = reordered[i];
+
+	for (size_t m = 0; m < meshlets.size(); m++)
+	{
+		Meshlet& meshlet = meshlets[m];
+		ComputeBoundingSphere(vertices, indices + meshlet.startIndex, meshlet.indexCount, meshlet.center, meshlet.radius);
+		ComputeNormalCone(vertices, indices + meshlet.startIndex, meshlet.indexCount, meshlet);
+	}
+
+	return meshlets;
+}
+
+bool IsMeshletBackfacing(const Meshlet& meshlet, const XMFLOAT3& cameraPosition)
+{
+	if (meshlet.coneCutoff >= 1.0f)
+		return false;
+
+	XMFLOAT3 view = Subtract(meshlet.coneApex, cameraPosition);
+	float length = sqrtf(Dot(view, view));
+	return Dot(view, meshlet.coneAxis) >= meshlet.coneCutoff * length;
+}
+
+void ExtractFrustumPlanes(const XMFLOAT4X4& m, XMFLOAT4 planes[6])
+{
+	// Gribb & Hartmann, for D3D's 0 <= z <= w clip space
+	planes[0] = XMFLOAT4(m._14 + m._11, m._24 + m._21, m._34 + m._31, m._44 + m._41);	// Left
+	planes[1] = XMFLOAT4(m._14 - m._11, m._24 - m._21, m._34 - m._31, m._44 - m._41);	// Right
+	planes[2] = XMFLOAT4(m._14 + m._12, m._24 + m._22, m._34 + m._32, m._44 + m._42);	// Bottom
+	planes[3] = XMFLOAT4(m._14 - m._12, m._24 - m._22, m._34 - m._32, m._44 - m._42);	// Top
+	planes[4] = XMFLOAT4(m._13, m._23, m._33, m._43);									// Near
+	planes[5] = XMFLOAT4(m._14 - m._13, m._24 - m._23, m._34 - m._33, m._44 - m._43);	// Far
+
+	for (int i = 0; i < 6; i++)
+	{
+		float length = sqrtf(planes[i].x * planes[i].x + planes[i].y * planes[i].y + planes[i].z * planes[i].z);
+		if (length > 0.0f)
+		{
+			planes[i].x /= length;
+			planes[i].y /= length;
+			planes[i].z /= length;
+			planes[i].w /= length;
+		}
+	}
+}
+
+bool IsSphereOutsideFrustum(const XMFLOAT3& center, float radius, const XMFLOAT4 planes[6])
+{
+	for (int i = 0; i < 6; i++)
+	{
+		if (planes[i].x * center.x + planes[i].y * center.y + planes[i].z * center.z + planes[i].w < -radius)
+			return true;
+	}
+	return false;
+}
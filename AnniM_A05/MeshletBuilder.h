@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <DirectXMath.h>
+#include "Vertex.h"
+
+// --------------------------------------------------------
+// Meshlets (small clusters of triangles)
+//
+// A mesh's triangles are grouped into clusters that share few
+// vertices, and the index buffer is reordered so each cluster
+// is one contiguous DrawIndexed range.  Each cluster also gets
+// a bounding sphere and a normal cone, so whole clusters can
+// be skipped on the CPU when they're outside the frustum or
+// facing away from the camera.
+// --------------------------------------------------------
+
+// Limits that also suit mesh shaders, should we ever get them
+static const unsigned int MeshletMaxVertices = 64;
+static const unsigned int MeshletMaxTriangles = 124;
+
+struct Meshlet
+{
+	unsigned int startIndex;		// Range of the (reordered) index buffer
+	unsigned int indexCount;
+	unsigned int vertexCount;		// Unique vertices used by the range
+	DirectX::XMFLOAT3 center;		// Bounding sphere
+	float radius;
+	DirectX::XMFLOAT3 coneApex;		// Normal cone (see IsMeshletBackfacing)
+	DirectX::XMFLOAT3 coneAxis;
+	float coneCutoff;				// 1 when the cone is too wide to ever cull
+};
+
+// --------------------------------------------------------
+// Groups the triangles into meshlets, grown greedily from the
+// current triangle order (so run the vertex cache optimizer
+// first) by always adding the neighbouring triangle that
+// brings in the fewest new vertices
+// - Reorders the triangles in "indices" in place and returns
+//    the meshlets covering them, in order
+// --------------------------------------------------------
+std::vector<Meshlet> BuildMeshlets(
+	const Vertex* vertices, size_t vertexCount,
+	unsigned int* indices, size_t indexCount);
+
+// --------------------------------------------------------
+// True if every triangle in the meshlet faces away from a
+// camera at the given position (in the mesh's own space)
+// --------------------------------------------------------
+bool IsMeshletBackfacing(const Meshlet& meshlet, const DirectX::XMFLOAT3& cameraPosition);
+
+// --------------------------------------------------------
+// Frustum planes (a, b, c, d, normalized, pointing inwards) of
+// a row-major (not transposed) world * view * projection
+// matrix, so they're in the space of the mesh
+// --------------------------------------------------------
+void ExtractFrustumPlanes(const DirectX::XMFLOAT4X4& worldViewProj, DirectX::XMFLOAT4 planes[6]);
+
+// True if the sphere is completely outside one of the planes
+bool IsSphereOutsideFrustum(const DirectX::XMFLOAT3& center, float radius, const DirectX::XMFLOAT4 planes[6]);
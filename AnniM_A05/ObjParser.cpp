@@ -0,0 +1,1038 @@
+#include "ObjParser.h"
+#include "MappedFile.h"
+#include "Parallel.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <map>
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// Open-addressing hash table from v/vt/vn triples to vertex
+// indices.  Everything lives in two flat arrays, so finding
+// or adding a vertex never allocates a node per entry.
+// --------------------------------------------------------
+static const unsigned int EmptySlot = 0xFFFFFFFF;
+
+class ObjVertexWelder
+{
+	std::vector<ObjVertexKey> keys;		// Key of each vertex, by vertex index
+	std::vector<unsigned int> table;	// Vertex index per slot (or EmptySlot)
+	unsigned int mask;
+
+	static unsigned int Hash(const ObjVertexKey& key)
+	{
+		// Mix the three indices together (FNV-1a style)
+		unsigned int hash = 2166136261u;
+		hash = (hash ^ key.position) * 16777619u;
+		hash = (hash ^ key.uv) * 16777619u;
+		hash = (hash ^ key.normal) * 16777619u;
+		return hash;
+	}
+
+	void Grow()
+	{
+		table.assign(table.size() * 2, EmptySlot);
+		mask = (unsigned int)table.size() - 1;
+		for (unsigned int i = 0; i < (unsigned int)keys.size(); i++)
+		{
+			unsigned int slot = Hash(keys[i]) & mask;
+			while (table[slot] != EmptySlot)
+				slot = (slot + 1) & mask;
+			table[slot] = i;
+		}
+	}
+
+public:
+	ObjVertexWelder()
+	{
+		table.assign(1024, EmptySlot);
+		mask = (unsigned int)table.size() - 1;
+	}
+
+	// Returns the existing vertex index for the key, or adds
+	// the key as vertex number "newIndex" and sets "added"
+	unsigned int FindOrAdd(const ObjVertexKey& key, unsigned int newIndex, bool& added)
+	{
+		unsigned int slot = Hash(key) & mask;
+		while (table[slot] != EmptySlot)
+		{
+			if (keys[table[slot]] == key)
+			{
+				added = false;
+				return table[slot];
+			}
+			slot = (slot + 1) & mask;
+		}
+
+		table[slot] = newIndex;
+		keys.push_back(key);
+		added = true;
+
+		// Keep the load factor at or below 50%
+		if (keys.size() * 2 > table.size())
+			Grow();
+		return newIndex;
+	}
+
+	// Keys of all vertices added so far, by vertex index
+	const std::vector<ObjVertexKey>& GetKeys()
+	{
+		return keys;
+	}
+};
+
+// --------------------------------------------------------
+// Chunks smaller than this aren't worth a thread of their own
+// --------------------------------------------------------
+static const size_t MinChunkBytes = 256 * 1024;
+
+// --------------------------------------------------------
+// A usemtl line - the faces from "corner" on use "name"
+// --------------------------------------------------------
+struct ObjMaterialSwitch
+{
+	size_t corner;
+	std::string name;
+};
+
+// --------------------------------------------------------
+// Everything parsed out of one line-aligned piece of the file
+// - Face corners keep the raw OBJ indices; they're checked
+//    and welded once all chunks are done
+// - Negative (relative) indices can point into earlier chunks,
+//    so they're kept relative to this chunk (see ParseIndex)
+// --------------------------------------------------------
+struct ObjChunk
+{
+	const char* start;
+	const char* end;
+	std::vector<XMFLOAT3> positions;
+	std::vector<XMFLOAT3> normals;
+	std::vector<XMFLOAT2> uvs;
+	std::vector<ObjVertexKey> corners;	// 3 per triangle, winding already flipped
+	std::vector<ObjMaterialSwitch> materialSwitches;
+	std::vector<std::string> materialLibraries;
+};
+
+static const double PowersOf10[] =
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline bool IsDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+static inline bool IsBlank(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline const char* SkipBlanks(const char* p, const char* end)
+{
+	while (p < end && IsBlank(*p))
+		p++;
+	return p;
+}
+
+// --------------------------------------------------------
+// Parses a decimal float starting at p, without needing the
+// text to be null terminated (so it works on a mapped file)
+// - Uses the exact fast path (mantissa fits in a double and
+//    |exponent| <= 22) for practically every OBJ number, and
+//    falls back to strtod() for anything unusual
+// - Returns the position after the number, or 0 if there
+//    was no number
+// --------------------------------------------------------
+static const char* ParseFloat(const char* p, const char* end, float& out)
+{
+	const char* start = p;
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+'))
+	{
+		negative = *p == '-';
+		p++;
+	}
+
+	unsigned long long mantissa = 0;
+	int significantDigits = 0;
+	int exponent = 0;
+	bool anyDigits = false;
+
+	// Integer part
+	while (p < end && IsDigit(*p))
+	{
+		if (significantDigits < 19)
+		{
+			mantissa = mantissa * 10 + (*p - '0');
+			if (mantissa) significantDigits++;
+		}
+		else
+		{
+			exponent++;
+		}
+		anyDigits = true;
+		p++;
+	}
+
+	// Fractional part
+	if (p < end && *p == '.')
+	{
+		p++;
+		while (p < end && IsDigit(*p))
+		{
+			if (significantDigits < 19)
+			{
+				mantissa = mantissa * 10 + (*p - '0');
+				if (mantissa) significantDigits++;
+				exponent--;
+			}
+			anyDigits = true;
+			p++;
+		}
+	}
+
+	if (!anyDigits)
+		return 0;
+
+	// Exponent (only consumed if it's well formed)
+	if (p < end && (*p == 'e' || *p == 'E'))
+	{
+		const char* e = p + 1;
+		bool negativeExponent = false;
+		if (e < end && (*e == '-' || *e == '+'))
+		{
+			negativeExponent = *e == '-';
+			e++;
+		}
+		if (e < end && IsDigit(*e))
+		{
+			int value = 0;
+			while (e < end && IsDigit(*e))
+			{
+				if (value < 10000) value = value * 10 + (*e - '0');
+				e++;
+			}
+			exponent += negativeExponent ? -value : value;
+			p = e;
+		}
+	}
+
+	double value;
+	if (mantissa <= (1ull << 53) && exponent >= -22 && exponent <= 22)
+	{
+		value = (double)mantissa;
+		value = exponent < 0 ? value / PowersOf10[-exponent] : value * PowersOf10[exponent];
+		if (negative) value = -value;
+	}
+	else
+	{
+		// Slow path - copy into a terminated buffer for strtod
+		char buffer[64];
+		size_t length = p - start;
+		if (length >= sizeof(buffer)) length = sizeof(buffer) - 1;
+		memcpy(buffer, start, length);
+		buffer[length] = 0;
+		value = strtod(buffer, 0);
+	}
+
+	out = (float)value;
+	return p;
+}
+
+// --------------------------------------------------------
+// Marks an index as relative to the start of its chunk - the
+// other 31 bits are a signed, 1-based index within the chunk
+// (zero or less for elements in earlier chunks)
+// --------------------------------------------------------
+static const unsigned int RelativeIndex = 0x80000000u;
+
+// --------------------------------------------------------
+// An index that was written but can't be right (0, absurdly
+// large, or pointing before the start of the file) - it's past
+// every element count, so it fails the range checks and drops
+// its triangle, where a left out UV or normal (0) wouldn't
+// --------------------------------------------------------
+static const unsigned int InvalidIndex = 0x7FFFFFFFu;
+
+// --------------------------------------------------------
+// Parses a 1-based OBJ index - returns 0 if there wasn't one
+// - Negative indices count back from the last element read so
+//    far ("localCount" of them in this chunk), and come out
+//    marked RelativeIndex; see ResolveIndex
+// - 0 and absurdly large indices come out as InvalidIndex
+// --------------------------------------------------------
+static const char* ParseIndex(const char* p, const char* end, size_t localCount, unsigned int& out)
+{
+	bool negative = p < end && *p == '-';
+	if (negative)
+		p++;
+	if (p >= end || !IsDigit(*p))
+		return 0;
+
+	unsigned long long value = 0;
+	while (p < end && IsDigit(*p))
+	{
+		if (value < 0x80000000ull) value = value * 10 + (*p - '0');
+		p++;
+	}
+
+	if (value == 0 || value >= 0x40000000ull)
+		out = InvalidIndex;
+	else if (negative)
+		out = RelativeIndex | ((unsigned int)((long long)localCount + 1 - (long long)value) & 0x7FFFFFFFu);
+	else
+		out = (unsigned int)value;
+	return p;
+}
+
+// --------------------------------------------------------
+// Turns a parsed index into a file-wide 1-based one, given the
+// number of elements in the chunks before this one
+// - Returns InvalidIndex for relative indices that point
+//    before the file
+// --------------------------------------------------------
+static inline unsigned int ResolveIndex(unsigned int index, size_t base)
+{
+	if (!(index & RelativeIndex))
+		return index;
+
+	int local = (int)(index << 1) >> 1;		// Sign extend the 31 bits
+	long long resolved = (long long)base + local;
+	return resolved > 0 ? (unsigned int)resolved : InvalidIndex;
+}
+
+// --------------------------------------------------------
+// Parses up to "count" floats separated by blanks
+// - Returns the number actually read
+// --------------------------------------------------------
+static int ParseFloats(const char* p, const char* end, float* out, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		p = SkipBlanks(p, end);
+		p = ParseFloat(p, end, out[i]);
+		if (!p)
+			return i;
+	}
+	return count;
+}
+
+// --------------------------------------------------------
+// Gets the rest of the line, minus surrounding blanks
+// --------------------------------------------------------
+static std::string ParseName(const char* p, const char* end)
+{
+	p = SkipBlanks(p, end);
+	while (end > p && IsBlank(end[-1]))
+		end--;
+	return std::string(p, end);
+}
+
+// --------------------------------------------------------
+// Starts with the given keyword, followed by a blank?
+// --------------------------------------------------------
+static bool IsKeyword(const char* p, const char* end, const char* keyword)
+{
+	size_t length = strlen(keyword);
+	return (size_t)(end - p) > length && memcmp(p, keyword, length) == 0 && IsBlank(p[length]);
+}
+
+// --------------------------------------------------------
+// Parses the corners of an "f" line (p is just past the "f")
+// and appends its triangles to "corners"
+// - Faces (triangles or any larger convex polygon) are
+//    triangulated as a fan around the first corner
+// - The counts are the elements read so far, for negative
+//    indices (see ParseIndex)
+// --------------------------------------------------------
+static void ParseFace(
+	const char* p, const char* lineEnd,
+	size_t positionCount, size_t uvCount, size_t normalCount,
+	std::vector<ObjVertexKey>& corners)
+{
+	ObjVertexKey first = {};
+	ObjVertexKey previous = {};
+	int corner = 0;
+
+	const char* c = p;
+	while (true)
+	{
+		// Each corner is "v", "v/vt", "v//vn" or "v/vt/vn"
+		ObjVertexKey key = {};
+		c = SkipBlanks(c, lineEnd);
+		c = ParseIndex(c, lineEnd, positionCount, key.position);
+		if (!c) break;
+		if (c < lineEnd && *c == '/')
+		{
+			c++;
+			if (c < lineEnd && (IsDigit(*c) || *c == '-'))
+			{
+				c = ParseIndex(c, lineEnd, uvCount, key.uv);
+				if (!c) break;
+			}
+			if (c < lineEnd && *c == '/')
+			{
+				c = ParseIndex(c + 1, lineEnd, normalCount, key.normal);
+				if (!c) break;
+			}
+		}
+
+		if (corner == 0)
+		{
+			first = key;
+		}
+		else if (corner >= 2)
+		{
+			// Add a whole triangle (flipping the winding order)
+			corners.push_back(first);
+			corners.push_back(key);
+			corners.push_back(previous);
+		}
+		previous = key;
+		corner++;
+	}
+}
+
+// --------------------------------------------------------
+// Parses all of the records in a single chunk
+// --------------------------------------------------------
+static void ParseObjChunk(ObjChunk& chunk)
+{
+	const char* p = chunk.start;
+	const char* end = chunk.end;
+	while (p < end)
+	{
+		p = SkipBlanks(p, end);
+		if (p >= end)
+			break;
+
+		const char* lineEnd = (const char*)memchr(p, '\n', end - p);
+		if (!lineEnd)
+			lineEnd = end;
+
+		// Check the type of line
+		if (p[0] == 'v' && p + 1 < lineEnd && IsBlank(p[1]))
+		{
+			XMFLOAT3 pos(0, 0, 0);
+			ParseFloats(p + 2, lineEnd, &pos.x, 3);
+			chunk.positions.push_back(pos);
+		}
+		else if (p[0] == 'v' && p + 2 < lineEnd && p[1] == 't' && IsBlank(p[2]))
+		{
+			XMFLOAT2 uv(0, 0);
+			ParseFloats(p + 3, lineEnd, &uv.x, 2);
+			chunk.uvs.push_back(uv);
+		}
+		else if (p[0] == 'v' && p + 2 < lineEnd && p[1] == 'n' && IsBlank(p[2]))
+		{
+			XMFLOAT3 norm(0, 0, 0);
+			ParseFloats(p + 3, lineEnd, &norm.x, 3);
+			chunk.normals.push_back(norm);
+		}
+		else if (p[0] == 'f' && p + 1 < lineEnd && IsBlank(p[1]))
+		{
+			ParseFace(p + 1, lineEnd, chunk.positions.size(), chunk.uvs.size(), chunk.normals.size(), chunk.corners);
+		}
+
+		else if (IsKeyword(p, lineEnd, "usemtl"))
+		{
+			ObjMaterialSwitch materialSwitch;
+			materialSwitch.corner = chunk.corners.size();
+			materialSwitch.name = ParseName(p + 6, lineEnd);
+			chunk.materialSwitches.push_back(materialSwitch);
+		}
+		else if (IsKeyword(p, lineEnd, "mtllib"))
+		{
+			// Any number of blank-separated library names
+			const char* name = SkipBlanks(p + 6, lineEnd);
+			while (name < lineEnd)
+			{
+				const char* nameEnd = name;
+				while (nameEnd < lineEnd && !IsBlank(*nameEnd))
+					nameEnd++;
+				chunk.materialLibraries.push_back(std::string(name, nameEnd));
+				name = SkipBlanks(nameEnd, lineEnd);
+			}
+		}
+
+		// Everything else (comments, groups, etc.) is skipped
+		p = lineEnd + 1;
+	}
+}
+
+// --------------------------------------------------------
+// Copies "source" into the already-sized "dest" starting
+// at the given (prefix sum) offset
+// --------------------------------------------------------
+template<typename T>
+static void CopyToOffset(const std::vector<T>& source, std::vector<T>& dest, size_t offset)
+{
+	if (!source.empty())
+		memcpy(&dest[offset], &source[0], source.size() * sizeof(T));
+}
+
+// --------------------------------------------------------
+// Generates smooth normals for every corner that doesn't have
+// one, and appends them to "normals" (corners get 1-based ids)
+// - Each corner averages the faces around its position index,
+//    weighted by face area and by the corner's angle in each
+//    face, but only faces within "creaseAngle" degrees of its
+//    own face - so hard edges stay hard
+// - Works on the file's raw (right-handed) positions; corners
+//    are stored with flipped winding, hence the reversed cross
+// - Positions are split into ranges that are processed in
+//    parallel, and the new normals are numbered in position
+//    order, so the result doesn't depend on the thread count
+// --------------------------------------------------------
+static void GenerateObjNormals(
+	const std::vector<XMFLOAT3>& positions,
+	std::vector<ObjVertexKey>& corners,
+	std::vector<XMFLOAT3>& normals,
+	float creaseAngle,
+	unsigned int threadCount)
+{
+	size_t triangleCount = corners.size() / 3;
+	std::vector<XMFLOAT3> faceNormals(triangleCount);	// Length is twice the area
+	std::vector<XMFLOAT3> unitNormals(triangleCount);	// Zero for degenerate faces
+	std::vector<float> cornerAngles(corners.size());
+
+	ParallelFor(triangleCount, threadCount, [&](size_t begin, size_t end, size_t)
+	{
+		for (size_t t = begin; t < end; t++)
+		{
+			XMVECTOR p[3];
+			for (int k = 0; k < 3; k++)
+				p[k] = XMLoadFloat3(&positions[corners[t * 3 + k].position - 1]);
+
+			XMVECTOR normal = XMVector3Cross(XMVectorSubtract(p[2], p[0]), XMVectorSubtract(p[1], p[0]));
+			XMStoreFloat3(&faceNormals[t], normal);
+
+			float length = XMVectorGetX(XMVector3Length(normal));
+			XMStoreFloat3(&unitNormals[t], length > 0 ? XMVectorScale(normal, 1.0f / length) : XMVectorZero());
+
+			for (int k = 0; k < 3; k++)
+			{
+				XMVECTOR e0 = XMVector3Normalize(XMVectorSubtract(p[(k + 1) % 3], p[k]));
+				XMVECTOR e1 = XMVector3Normalize(XMVectorSubtract(p[(k + 2) % 3], p[k]));
+				cornerAngles[t * 3 + k] = XMVectorGetX(XMVector3AngleBetweenNormals(e0, e1));
+			}
+		}
+	});
+
+	// Corners grouped by position index (CSR), in corner order
+	size_t positionCount = positions.size();
+	std::vector<unsigned int> firstCorner(positionCount + 1, 0);
+	for (size_t c = 0; c < corners.size(); c++)
+		firstCorner[corners[c].position]++;
+	for (size_t i = 0; i < positionCount; i++)
+		firstCorner[i + 1] += firstCorner[i];
+
+	std::vector<unsigned int> positionCorners(corners.size());
+	{
+		std::vector<unsigned int> cursor(firstCorner.begin(), firstCorner.end() - 1);
+		for (size_t c = 0; c < corners.size(); c++)
+			positionCorners[cursor[corners[c].position - 1]++] = (unsigned int)c;
+	}
+
+	// Average the faces around each normal-less corner
+	float creaseCosine = cosf(creaseAngle * XM_PI / 180.0f);
+	unsigned int ranges = threadCount ? threadCount : 1;
+	std::vector<std::vector<XMFLOAT3>> rangeNormals(ranges);
+	std::vector<unsigned int> generated(corners.size(), 0);		// 1-based id within its range
+	ParallelFor(positionCount, ranges, [&](size_t begin, size_t end, size_t range)
+	{
+		std::vector<XMFLOAT3>& created = rangeNormals[range];
+		for (size_t i = begin; i < end; i++)
+		{
+			size_t createdStart = created.size();
+			for (unsigned int a = firstCorner[i]; a < firstCorner[i + 1]; a++)
+			{
+				unsigned int corner = positionCorners[a];
+				if (corners[corner].normal != 0)
+					continue;
+
+				XMVECTOR unit = XMLoadFloat3(&unitNormals[corner / 3]);
+				XMVECTOR sum = XMVectorZero();
+				for (unsigned int b = firstCorner[i]; b < firstCorner[i + 1]; b++)
+				{
+					unsigned int other = positionCorners[b];
+					XMVECTOR otherUnit = XMLoadFloat3(&unitNormals[other / 3]);
+					if (other / 3 != corner / 3 && XMVectorGetX(XMVector3Dot(unit, otherUnit)) < creaseCosine)
+						continue;
+					sum = XMVectorAdd(sum, XMVectorScale(XMLoadFloat3(&faceNormals[other / 3]), cornerAngles[other]));
+				}
+
+				// Degenerate surroundings fall back to the face, then to "up"
+				XMFLOAT3 normal;
+				float length = XMVectorGetX(XMVector3Length(sum));
+				if (length > 0)
+					XMStoreFloat3(&normal, XMVectorScale(sum, 1.0f / length));
+				else if (XMVectorGetX(XMVector3LengthSq(unit)) > 0)
+					XMStoreFloat3(&normal, unit);
+				else
+					normal = XMFLOAT3(0, 1, 0);
+
+				// Corners on the same side of a crease end up with the
+				// exact same normal, so they can still be welded
+				size_t found = created.size();
+				for (size_t n = createdStart; n < created.size(); n++)
+				{
+					if (memcmp(&created[n], &normal, sizeof(XMFLOAT3)) == 0)
+					{
+						found = n;
+						break;
+					}
+				}
+				if (found == created.size())
+					created.push_back(normal);
+				generated[corner] = (unsigned int)found + 1;
+			}
+		}
+	});
+
+	// Append each range's normals in order and hand out the final ids
+	std::vector<size_t> rangeBase(ranges);
+	size_t base = normals.size();
+	for (unsigned int r = 0; r < ranges; r++)
+	{
+		rangeBase[r] = base;
+		normals.insert(normals.end(), rangeNormals[r].begin(), rangeNormals[r].end());
+		base += rangeNormals[r].size();
+	}
+
+	ParallelFor(positionCount, ranges, [&](size_t begin, size_t end, size_t range)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			for (unsigned int a = firstCorner[i]; a < firstCorner[i + 1]; a++)
+			{
+				unsigned int corner = positionCorners[a];
+				if (generated[corner])
+					corners[corner].normal = (unsigned int)rangeBase[range] + generated[corner];
+			}
+		}
+	});
+}
+
+void BuildObjVertices(
+	const std::vector<XMFLOAT3>& positions,
+	const std::vector<XMFLOAT2>& uvs,
+	std::vector<XMFLOAT3>& normals,
+	std::vector<ObjVertexKey>& corners,
+	ObjMeshData& mesh,
+	float creaseAngle,
+	unsigned int threadCount)
+{
+	// Fill in any normals the file left out
+	bool missingNormals = false;
+	for (size_t k = 0; k < corners.size() && !missingNormals; k++)
+		missingNormals = corners[k].normal == 0;
+	if (missingNormals)
+		GenerateObjNormals(positions, corners, normals, creaseAngle, threadCount);
+
+	// Weld the corners in order, so the output doesn't depend
+	// on how the file was split
+	ObjVertexWelder welder;
+	mesh.indices.clear();
+	mesh.indices.reserve(corners.size());
+	for (size_t k = 0; k < corners.size(); k++)
+	{
+		bool added;
+		unsigned int newIndex = (unsigned int)welder.GetKeys().size();
+		mesh.indices.push_back(welder.FindOrAdd(corners[k], newIndex, added));
+	}
+
+	// Build the unique vertices (also in parallel)
+	const std::vector<ObjVertexKey>& keys = welder.GetKeys();
+	mesh.vertices.resize(keys.size());
+	ParallelFor(keys.size(), threadCount, [&](size_t begin, size_t finish, size_t)
+	{
+		for (size_t i = begin; i < finish; i++)
+		{
+			Vertex& v = mesh.vertices[i];
+			v.Position = positions[keys[i].position - 1];
+			v.UV = keys[i].uv ? uvs[keys[i].uv - 1] : XMFLOAT2(0, 0);
+			v.Normal = normals[keys[i].normal - 1];
+
+			// The model is most likely in a right-handed space,
+			// so convert to DirectX's left-handed space:
+			//  - Invert the Z position and the normal's Z
+			//  - Flip the UV's since they're probably "upside down"
+			//  - Flip the winding order (done while parsing faces)
+			v.Position.z *= -1.0f;
+			v.Normal.z *= -1.0f;
+			v.UV.y = 1.0f - v.UV.y;
+		}
+	});
+}
+
+bool ParseObj(const char* data, size_t size, ObjMeshData& mesh, unsigned int threadCount, ObjParseStats* stats, float creaseAngle)
+{
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	mesh.vertices.clear();
+	mesh.indices.clear();
+	mesh.submeshes.clear();
+	mesh.materials.clear();
+	mesh.materialLibraries.clear();
+
+	// Split the text into line-aligned chunks, one per thread
+	size_t chunkCount = ResolveThreadCount(threadCount);
+	if (chunkCount > size / MinChunkBytes)
+		chunkCount = size / MinChunkBytes;
+	if (chunkCount < 1)
+		chunkCount = 1;
+
+	std::vector<ObjChunk> chunks(chunkCount);
+	const char* end = data + size;
+	const char* chunkStart = data;
+	for (size_t i = 0; i < chunkCount; i++)
+	{
+		// Each chunk ends just after the first newline past its even share
+		const char* chunkEnd = end;
+		if (i + 1 < chunkCount)
+		{
+			const char* split = data + size * (i + 1) / chunkCount;
+			if (split < chunkStart)
+				split = chunkStart;
+			const char* newline = (const char*)memchr(split, '\n', end - split);
+			chunkEnd = newline ? newline + 1 : end;
+		}
+
+		chunks[i].start = chunkStart;
+		chunks[i].end = chunkEnd;
+		chunkStart = chunkEnd;
+	}
+
+	// Parse every chunk at once
+	ParallelFor(chunkCount, (unsigned int)chunkCount, [&](size_t begin, size_t finish, size_t)
+	{
+		for (size_t i = begin; i < finish; i++)
+			ParseObjChunk(chunks[i]);
+	});
+
+	// Prefix sum of the per-chunk attribute counts gives each
+	// chunk's offset into the file-wide arrays.  OBJ indices are
+	// 1-based positions in those file-wide arrays.
+	std::vector<size_t> positionBase(chunkCount), uvBase(chunkCount), normalBase(chunkCount);
+	size_t positionCount = 0, uvCount = 0, normalCount = 0, cornerCount = 0;
+	for (size_t i = 0; i < chunkCount; i++)
+	{
+		positionBase[i] = positionCount;
+		uvBase[i] = uvCount;
+		normalBase[i] = normalCount;
+		positionCount += chunks[i].positions.size();
+		uvCount += chunks[i].uvs.size();
+		normalCount += chunks[i].normals.size();
+		cornerCount += chunks[i].corners.size();
+	}
+
+	std::vector<XMFLOAT3> positions(positionCount);     // Positions from the file
+	std::vector<XMFLOAT3> normals(normalCount);         // Normals from the file
+	std::vector<XMFLOAT2> uvs(uvCount);                 // UVs from the file
+	ParallelFor(chunkCount, (unsigned int)chunkCount, [&](size_t begin, size_t finish, size_t)
+	{
+		for (size_t i = begin; i < finish; i++)
+		{
+			CopyToOffset(chunks[i].positions, positions, positionBase[i]);
+			CopyToOffset(chunks[i].uvs, uvs, uvBase[i]);
+			CopyToOffset(chunks[i].normals, normals, normalBase[i]);
+		}
+	});
+
+	// Resolve every corner to file-wide indices, in file order,
+	// skipping triangles with anything out of range
+	// - Positions are required, UVs and normals are optional
+	// - Each material gets a number when a triangle first uses it
+	std::vector<ObjVertexKey> corners;
+	std::vector<unsigned int> triangleMaterials;
+	std::vector<std::string> materialNames;
+	std::map<std::string, unsigned int> materialNumbers;
+	std::string currentMaterial;
+	unsigned int currentNumber = EmptySlot;
+	corners.reserve(cornerCount);
+	triangleMaterials.reserve(cornerCount / 3);
+	for (size_t c = 0; c < chunkCount; c++)
+	{
+		const std::vector<ObjVertexKey>& chunkCorners = chunks[c].corners;
+		const std::vector<ObjMaterialSwitch>& switches = chunks[c].materialSwitches;
+		size_t nextSwitch = 0;
+		for (size_t t = 0; t + 2 < chunkCorners.size(); t += 3)
+		{
+			while (nextSwitch < switches.size() && switches[nextSwitch].corner <= t)
+			{
+				currentMaterial = switches[nextSwitch++].name;
+				currentNumber = EmptySlot;
+			}
+
+			ObjVertexKey triangle[3];
+			bool valid = true;
+			for (int k = 0; k < 3; k++)
+			{
+				ObjVertexKey& key = triangle[k];
+				key.position = ResolveIndex(chunkCorners[t + k].position, positionBase[c]);
+				key.uv = ResolveIndex(chunkCorners[t + k].uv, uvBase[c]);
+				key.normal = ResolveIndex(chunkCorners[t + k].normal, normalBase[c]);
+
+				// Left out UVs and normals are 0, which is fine - any
+				// bad index (InvalidIndex included) is past the end
+				valid = valid &&
+					key.position != 0 && key.position <= positionCount &&
+					key.uv <= uvCount && key.normal <= normalCount;
+			}
+			if (!valid)
+				continue;
+
+			if (currentNumber == EmptySlot)
+			{
+				std::map<std::string, unsigned int>::iterator found = materialNumbers.find(currentMaterial);
+				if (found == materialNumbers.end())
+				{
+					found = materialNumbers.insert(std::make_pair(currentMaterial, (unsigned int)materialNames.size())).first;
+					materialNames.push_back(currentMaterial);
+				}
+				currentNumber = found->second;
+			}
+
+			triangleMaterials.push_back(currentNumber);
+			for (int k = 0; k < 3; k++)
+				corners.push_back(triangle[k]);
+		}
+
+		// Any switches after the last face still carry over
+		while (nextSwitch < switches.size())
+		{
+			currentMaterial = switches[nextSwitch++].name;
+			currentNumber = EmptySlot;
+		}
+		mesh.materialLibraries.insert(mesh.materialLibraries.end(), chunks[c].materialLibraries.begin(), chunks[c].materialLibraries.end());
+	}
+
+	// Group the triangles by material (a stable counting sort),
+	// so each material is one contiguous submesh
+	mesh.submeshes.resize(materialNames.size());
+	mesh.materials.resize(materialNames.size());
+	{
+		std::vector<unsigned int> materialStart(materialNames.size() + 1, 0);
+		for (size_t t = 0; t < triangleMaterials.size(); t++)
+			materialStart[triangleMaterials[t] + 1] += 3;
+		for (size_t m = 0; m < materialNames.size(); m++)
+		{
+			materialStart[m + 1] += materialStart[m];
+			mesh.submeshes[m].startIndex = materialStart[m];
+			mesh.submeshes[m].indexCount = materialStart[m + 1] - materialStart[m];
+			mesh.submeshes[m].material = (unsigned int)m;
+			InitObjMaterial(mesh.materials[m], materialNames[m].c_str());
+		}
+
+		if (materialNames.size() > 1)
+		{
+			std::vector<ObjVertexKey> sorted(corners.size());
+			for (size_t t = 0; t < triangleMaterials.size(); t++)
+			{
+				unsigned int& cursor = materialStart[triangleMaterials[t]];
+				memcpy(&sorted[cursor], &corners[t * 3], 3 * sizeof(ObjVertexKey));
+				cursor += 3;
+			}
+			corners.swap(sorted);
+		}
+	}
+
+	BuildObjVertices(positions, uvs, normals, corners, mesh, creaseAngle, (unsigned int)chunkCount);
+
+	if (stats)
+	{
+		std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+		stats->bytes = size;
+		stats->threads = (unsigned int)chunkCount;
+		stats->seconds = elapsed.count();
+		stats->megabytesPerSecond = stats->seconds > 0 ? (size / (1024.0 * 1024.0)) / stats->seconds : 0;
+	}
+
+	return !mesh.indices.empty();
+}
+
+bool ParseObjFile(const char* file, ObjMeshData& mesh, unsigned int threadCount, ObjParseStats* stats, float creaseAngle)
+{
+	MappedFile obj(file);
+
+	// Check for successful open
+	if (!obj.IsOpen() || !obj.GetData())
+		return false;
+
+	if (!ParseObj(obj.GetData(), obj.GetSize(), mesh, threadCount, stats, creaseAngle))
+		return false;
+
+	// Fill in the materials from the libraries (usually just one)
+	for (size_t i = 0; i < mesh.materialLibraries.size(); i++)
+	{
+		MappedFile mtl(GetObjRelativePath(file, mesh.materialLibraries[i]).c_str());
+		if (mtl.GetData())
+			ParseMtl(mtl.GetData(), mtl.GetSize(), mesh.materials);
+	}
+	return true;
+}
+
+ObjStreamReader::ObjStreamReader(const char* data, size_t size)
+{
+	p = data;
+	end = data + size;
+	positionCount = 0;
+	uvCount = 0;
+	normalCount = 0;
+}
+
+ObjRecord ObjStreamReader::Next(float values[3], std::vector<ObjVertexKey>& triangles)
+{
+	while (p < end)
+	{
+		const char* line = SkipBlanks(p, end);
+		if (line >= end)
+			break;
+
+		const char* lineEnd = (const char*)memchr(line, '\n', end - line);
+		if (!lineEnd)
+			lineEnd = end;
+		p = lineEnd + 1;
+
+		if (line[0] == 'v' && line + 1 < lineEnd && IsBlank(line[1]))
+		{
+			values[0] = values[1] = values[2] = 0;
+			ParseFloats(line + 2, lineEnd, values, 3);
+			positionCount++;
+			return ObjRecord::Position;
+		}
+		if (line[0] == 'v' && line + 2 < lineEnd && line[1] == 't' && IsBlank(line[2]))
+		{
+			values[0] = values[1] = values[2] = 0;
+			ParseFloats(line + 3, lineEnd, values, 2);
+			uvCount++;
+			return ObjRecord::Uv;
+		}
+		if (line[0] == 'v' && line + 2 < lineEnd && line[1] == 'n' && IsBlank(line[2]))
+		{
+			values[0] = values[1] = values[2] = 0;
+			ParseFloats(line + 3, lineEnd, values, 3);
+			normalCount++;
+			return ObjRecord::Normal;
+		}
+		if (line[0] == 'f' && line + 1 < lineEnd && IsBlank(line[1]))
+		{
+			triangles.clear();
+			ParseFace(line + 1, lineEnd, positionCount, uvCount, normalCount, triangles);
+
+			// Relative indices here count back from everything read
+			// so far, not from the start of a chunk
+			for (size_t k = 0; k < triangles.size(); k++)
+			{
+				ObjVertexKey& key = triangles[k];
+				key.position = ResolveIndex(key.position, 0);
+				key.uv = ResolveIndex(key.uv, 0);
+				key.normal = ResolveIndex(key.normal, 0);
+			}
+			return ObjRecord::Face;
+		}
+	}
+	return ObjRecord::End;
+}
+
+// --------------------------------------------------------
+// Copies a string into a fixed-size field, cutting it short
+// if need be (always null terminated)
+// --------------------------------------------------------
+static void CopyName(char* dest, size_t destSize, const std::string& source)
+{
+	size_t length = source.size() < destSize - 1 ? source.size() : destSize - 1;
+	memcpy(dest, source.data(), length);
+	dest[length] = 0;
+}
+
+void InitObjMaterial(ObjMaterial& material, const char* name)
+{
+	memset(&material, 0, sizeof(ObjMaterial));
+	CopyName(material.name, sizeof(material.name), name);
+	material.diffuseColor = XMFLOAT3(1, 1, 1);
+	material.specularColor = XMFLOAT3(0, 0, 0);
+	material.specularPower = 1.0f;
+	material.opacity = 1.0f;
+}
+
+void ParseMtl(const char* data, size_t size, std::vector<ObjMaterial>& materials)
+{
+	ObjMaterial* current = 0;
+	const char* p = data;
+	const char* end = data + size;
+	while (p < end)
+	{
+		p = SkipBlanks(p, end);
+		if (p >= end)
+			break;
+
+		const char* lineEnd = (const char*)memchr(p, '\n', end - p);
+		if (!lineEnd)
+			lineEnd = end;
+
+		if (IsKeyword(p, lineEnd, "newmtl"))
+		{
+			// Compare the name the way it was stored (maybe cut short)
+			char name[sizeof(ObjMaterial::name)];
+			CopyName(name, sizeof(name), ParseName(p + 6, lineEnd));
+
+			current = 0;
+			for (size_t i = 0; i < materials.size() && !current; i++)
+			{
+				if (strcmp(materials[i].name, name) == 0)
+					current = &materials[i];
+			}
+		}
+		else if (current && IsKeyword(p, lineEnd, "Kd"))
+		{
+			ParseFloats(p + 2, lineEnd, &current->diffuseColor.x, 3);
+		}
+		else if (current && IsKeyword(p, lineEnd, "Ks"))
+		{
+			ParseFloats(p + 2, lineEnd, &current->specularColor.x, 3);
+		}
+		else if (current && IsKeyword(p, lineEnd, "Ns"))
+		{
+			ParseFloats(p + 2, lineEnd, &current->specularPower, 1);
+		}
+		else if (current && IsKeyword(p, lineEnd, "d"))
+		{
+			ParseFloats(p + 1, lineEnd, &current->opacity, 1);
+		}
+		else if (current && IsKeyword(p, lineEnd, "Tr"))
+		{
+			float transparency = 0.0f;
+			if (ParseFloats(p + 2, lineEnd, &transparency, 1) == 1)
+				current->opacity = 1.0f - transparency;
+		}
+		else if (current && IsKeyword(p, lineEnd, "map_Kd"))
+		{
+			// The file name comes last, after any options
+			std::string map = ParseName(p + 6, lineEnd);
+			size_t lastBlank = map.find_last_of(" \t");
+			CopyName(current->diffuseMap, sizeof(current->diffuseMap), lastBlank == std::string::npos ? map : map.substr(lastBlank + 1));
+		}
+
+		// Everything else (illum, other maps, etc.) is skipped
+		p = lineEnd + 1;
+	}
+}
+
+std::string GetObjRelativePath(const char* from, const std::string& name)
+{
+	// Absolute paths ("/x", "\\x" or "C:x") are used as they are
+	if (!name.empty() && (name[0] == '/' || name[0] == '\\' || (name.size() > 1 && name[1] == ':')))
+		return name;
+
+	std::string folder(from);
+	size_t slash = folder.find_last_of("/\\");
+	return slash == std::string::npos ? name : folder.substr(0, slash + 1) + name;
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include "Vertex.h"
+
+// --------------------------------------------------------
+// A material from a .mtl file (only what we can draw with)
+// - Plain fixed-size data, so it can go straight into the
+//    mesh cache; longer names are cut short
+// --------------------------------------------------------
+struct ObjMaterial
+{
+	char name[64];						// As given to usemtl ("" before any usemtl)
+	DirectX::XMFLOAT3 diffuseColor;		// Kd
+	DirectX::XMFLOAT3 specularColor;	// Ks
+	float specularPower;				// Ns
+	float opacity;						// d (or 1 - Tr)
+	char diffuseMap[128];				// map_Kd, relative to the .mtl file
+};
+
+// --------------------------------------------------------
+// A range of the index buffer drawn with one material
+// - material indexes the mesh's material table
+// --------------------------------------------------------
+struct ObjSubmesh
+{
+	unsigned int startIndex;
+	unsigned int indexCount;
+	unsigned int material;
+};
+
+// --------------------------------------------------------
+// One face corner's v/vt/vn indices
+// - Two corners with the same triple produce the exact same
+//    Vertex, so they're welded into one
+// - Indices are 1-based, and 0 means the corner didn't have
+//    one (a UV or normal left out, as in "f v//vn" or "f v")
+// --------------------------------------------------------
+struct ObjVertexKey
+{
+	unsigned int position;
+	unsigned int uv;
+	unsigned int normal;
+
+	bool operator==(const ObjVertexKey& other) const
+	{
+		return position == other.position && uv == other.uv && normal == other.normal;
+	}
+};
+
+// --------------------------------------------------------
+// The CPU-side result of parsing an OBJ file
+// - Vertices are welded (one per unique v/vt/vn triple) and
+//    already converted to DirectX's left-handed conventions
+// - Corners without a UV get (0, 1) after the flip; corners
+//    without a normal get a generated one (see ParseObj)
+// - Indices are 3 per triangle, ready for an index buffer
+// - Triangles are grouped by material, one submesh per usemtl
+//    name in the order they first appear - submesh i uses
+//    material i.  Files without usemtl have a single submesh.
+// --------------------------------------------------------
+struct ObjMeshData
+{
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	std::vector<ObjSubmesh> submeshes;
+	std::vector<ObjMaterial> materials;
+	std::vector<std::string> materialLibraries;	// mtllib names, as written in the file
+};
+
+// --------------------------------------------------------
+// Timing information for a single parse
+// --------------------------------------------------------
+struct ObjParseStats
+{
+	size_t bytes;				// Size of the OBJ text
+	unsigned int threads;		// Threads actually used (small files use fewer)
+	double seconds;				// Wall-clock time spent parsing
+	double megabytesPerSecond;	// bytes / seconds, in MB (2^20 bytes)
+};
+
+// --------------------------------------------------------
+// Parses OBJ text that's already in memory
+//
+// Doesn't touch DirectX at all, so it can be run (and timed)
+// without a device.  Returns false if no triangles were found.
+// - The text is split into line-aligned chunks which are
+//    parsed on up to "threadCount" threads (0 = one per
+//    hardware thread), then stitched back together in order
+// - The result is identical no matter how many threads are used
+// - Faces can use any of the v, v/vt, v//vn and v/vt/vn corner
+//    forms, have more than 3 corners (convex polygons are
+//    fanned into triangles) and use negative (relative) indices
+// - Materials only get their names here (ParseObjFile loads
+//    the libraries); everything else is left at the defaults
+// - When the file leaves normals out, smooth ones are generated
+//    from the faces around each position, except across edges
+//    sharper than "creaseAngle" degrees
+// - "stats" is optional
+// --------------------------------------------------------
+bool ParseObj(const char* data, size_t size, ObjMeshData& mesh, unsigned int threadCount = 1, ObjParseStats* stats = 0, float creaseAngle = 60.0f);
+
+// --------------------------------------------------------
+// Memory-maps the given file and parses it with ParseObj(),
+// then fills in the materials from its mtllib files (which
+// are looked up next to it)
+// - Missing libraries or materials just keep the defaults
+// --------------------------------------------------------
+bool ParseObjFile(const char* file, ObjMeshData& mesh, unsigned int threadCount = 1, ObjParseStats* stats = 0, float creaseAngle = 60.0f);
+
+// --------------------------------------------------------
+// The last step of ParseObj on its own, for code that gathers
+// the corners some other way (see MeshChunker)
+// - "corners" are 3 per triangle, winding already flipped,
+//    indexing the (raw, right-handed) attribute arrays
+// - Corners without a normal get a generated one (appended to
+//    "normals", with the corners updated to match)
+// - Fills in mesh.vertices and mesh.indices only
+// --------------------------------------------------------
+void BuildObjVertices(
+	const std::vector<DirectX::XMFLOAT3>& positions,
+	const std::vector<DirectX::XMFLOAT2>& uvs,
+	std::vector<DirectX::XMFLOAT3>& normals,
+	std::vector<ObjVertexKey>& corners,
+	ObjMeshData& mesh,
+	float creaseAngle = 60.0f,
+	unsigned int threadCount = 1);
+
+// --------------------------------------------------------
+// Reads OBJ text one v, vt, vn or f line at a time, keeping
+// nothing but counts - for importers that can't hold a whole
+// model in memory (see MeshChunker).  ParseObj is much faster
+// whenever the model fits.
+// - Values are exactly as written (right-handed, UVs unflipped)
+// - A face comes out as triangles with the same flipped winding
+//    ParseObj uses, and 1-based indices into everything read so
+//    far - or past it, since the file can refer ahead.  Indices
+//    aren't range checked here, but ones that can't be valid
+//    (0, or before the start of the file) come out larger than
+//    any count, so a range check catches them too.
+// --------------------------------------------------------
+enum class ObjRecord { End, Position, Uv, Normal, Face };
+
+class ObjStreamReader
+{
+	const char* p;
+	const char* end;
+	size_t positionCount;
+	size_t uvCount;
+	size_t normalCount;
+public:
+	ObjStreamReader(const char* data, size_t size);
+
+	// Skips to the next record and returns its type - "values"
+	// gets a v, vt or vn line's numbers, and "triangles" is
+	// replaced with a face's corners (3 per triangle)
+	ObjRecord Next(float values[3], std::vector<ObjVertexKey>& triangles);
+};
+
+// --------------------------------------------------------
+// Parses .mtl text, updating the materials whose names match
+// (materials the mesh doesn't use are skipped)
+// --------------------------------------------------------
+void ParseMtl(const char* data, size_t size, std::vector<ObjMaterial>& materials);
+
+// --------------------------------------------------------
+// Resets a material to the defaults (plain white, no map)
+// --------------------------------------------------------
+void InitObjMaterial(ObjMaterial& material, const char* name);
+
+// --------------------------------------------------------
+// Path of a file referenced by the OBJ (or .mtl) file "from"
+// - Relative paths are taken from the folder "from" is in
+// --------------------------------------------------------
+std::string GetObjRelativePath(const char* from, const std::string& name);
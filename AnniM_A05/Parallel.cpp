@@ -0,0 +1,108 @@
+#include "Parallel.h"
+
+WorkerPool::WorkerPool(unsigned int threadCount)
+{
+	function = 0;
+	job = 0;
+	count = 0;
+	ranges = 0;
+	generation = 0;
+	busyWorkers = 0;
+	stopping = false;
+
+	// The calling thread is one of them
+	threadCount = ResolveThreadCount(threadCount);
+	workers.reserve(threadCount - 1);
+	for (unsigned int i = 1; i < threadCount; i++)
+		workers.emplace_back(&WorkerPool::WorkerLoop, this, (size_t)i);
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	workAdded.notify_all();
+
+	for (size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
+}
+
+unsigned int WorkerPool::GetThreadCount()
+{
+	return (unsigned int)workers.size() + 1;
+}
+
+// --------------------------------------------------------
+// Same split as ParallelFor(): range r is [count * r / ranges,
+// count * (r + 1) / ranges), and worker r runs it
+// --------------------------------------------------------
+void WorkerPool::Run(RangeFunction function, void* job, size_t count)
+{
+	if (count == 0)
+		return;
+
+	size_t ranges = workers.size() + 1;
+	if (ranges > count)
+		ranges = count;
+
+	if (ranges == 1)
+	{
+		function(job, 0, count, 0);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->function = function;
+		this->job = job;
+		this->count = count;
+		this->ranges = ranges;
+		busyWorkers = (unsigned int)ranges - 1;
+		generation++;
+	}
+	workAdded.notify_all();
+
+	function(job, 0, count / ranges, 0);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	workFinished.wait(lock, [this] { return busyWorkers == 0; });
+}
+
+void WorkerPool::WorkerLoop(size_t range)
+{
+	unsigned int seen = 0;
+	for (;;)
+	{
+		RangeFunction function;
+		void* job;
+		size_t begin, end;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			workAdded.wait(lock, [this, seen] { return stopping || generation != seen; });
+			if (stopping)
+				return;
+
+			// Small jobs don't need every worker
+			seen = generation;
+			if (range >= ranges)
+				continue;
+
+			function = this->function;
+			job = this->job;
+			begin = count * range / ranges;
+			end = count * (range + 1) / ranges;
+		}
+
+		function(job, begin, end, range);
+
+		bool last;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			last = --busyWorkers == 0;
+		}
+		if (last)
+			workFinished.notify_one();
+	}
+}
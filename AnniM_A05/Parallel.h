@@ -0,0 +1,105 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstddef>
+
+// --------------------------------------------------------
+// Turns a requested thread count into an actual one
+// - 0 means "one per hardware thread"
+// --------------------------------------------------------
+inline unsigned int ResolveThreadCount(unsigned int requested)
+{
+	if (requested)
+		return requested;
+
+	unsigned int hardware = std::thread::hardware_concurrency();
+	return hardware ? hardware : 1;
+}
+
+// --------------------------------------------------------
+// Splits [0, count) into one contiguous range per thread and
+// calls job(begin, end, rangeIndex) for each range, returning
+// once they've all finished
+// - The calling thread runs the first range itself
+// - Ranges never overlap, so jobs that only write to their
+//    own range need no locking
+// --------------------------------------------------------
+template<typename Job>
+void ParallelFor(size_t count, unsigned int threadCount, Job job)
+{
+	if (count == 0)
+		return;
+
+	size_t ranges = threadCount ? threadCount : 1;
+	if (ranges > count)
+		ranges = count;
+
+	if (ranges == 1)
+	{
+		job((size_t)0, count, (size_t)0);
+		return;
+	}
+
+	std::vector<std::thread> workers;
+	workers.reserve(ranges - 1);
+	for (size_t r = 1; r < ranges; r++)
+	{
+		size_t begin = count * r / ranges;
+		size_t end = count * (r + 1) / ranges;
+		workers.emplace_back(job, begin, end, r);
+	}
+
+	job((size_t)0, count / ranges, (size_t)0);
+
+	for (size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
+}
+
+// --------------------------------------------------------
+// ParallelFor() on threads that stay around between calls
+//
+// Starting threads costs far more than waking ones that are
+// already waiting, so anything that splits work up every frame
+// should keep one of these rather than call ParallelFor().  For()
+// works the same way - the calling thread runs the first range,
+// and it returns once every range is done - but only one For()
+// may run at a time.
+// --------------------------------------------------------
+class WorkerPool
+{
+	typedef void (*RangeFunction)(void* job, size_t begin, size_t end, size_t range);
+
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable workAdded;
+	std::condition_variable workFinished;
+	RangeFunction function;
+	void* job;
+	size_t count;
+	size_t ranges;
+	unsigned int generation;	// Bumped for every For() that uses the workers
+	unsigned int busyWorkers;
+	bool stopping;
+
+	void WorkerLoop(size_t range);
+	void Run(RangeFunction function, void* job, size_t count);
+public:
+	// threadCount - including the calling thread; 0 means one per
+	// hardware thread
+	WorkerPool(unsigned int threadCount = 0);
+	~WorkerPool();
+
+	unsigned int GetThreadCount();
+
+	template<typename Job>
+	void For(size_t count, Job job)
+	{
+		Run([](void* job, size_t begin, size_t end, size_t range) { (*static_cast<Job*>(job))(begin, end, range); }, &job, count);
+	}
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+};
@@ -0,0 +1,325 @@
+#include "Primitives.h"
+#include <cmath>
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// One ring of a surface of revolution: its radius and height,
+// and the normal's (radial, Y) components there
+// --------------------------------------------------------
+struct LatheRing
+{
+	float radius;
+	float y;
+	float normalRadius;
+	float normalY;
+};
+
+static bool SamePosition(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+// --------------------------------------------------------
+// Adds a triangle unless two of its corners are the same point
+// (grid cells that touch a pole)
+// --------------------------------------------------------
+static void AddTriangle(PrimitiveMesh& mesh, unsigned int a, unsigned int b, unsigned int c)
+{
+	const XMFLOAT3& pa = mesh.vertices[a].Position;
+	const XMFLOAT3& pb = mesh.vertices[b].Position;
+	const XMFLOAT3& pc = mesh.vertices[c].Position;
+	if (SamePosition(pa, pb) || SamePosition(pb, pc) || SamePosition(pc, pa))
+		return;
+
+	mesh.indices.push_back(a);
+	mesh.indices.push_back(b);
+	mesh.indices.push_back(c);
+}
+
+// --------------------------------------------------------
+// Adds a (columns + 1) x (rows + 1) grid of vertices, filled in
+// by surface(u, v, vertex) with u and v from 0 to 1, and two
+// triangles per cell
+// - The triangles face along cross(dP/du, dP/dv), so surfaces
+//    should run u to the right and v downwards as seen from
+//    the front
+// --------------------------------------------------------
+template<typename Surface>
+static void AddGrid(PrimitiveMesh& mesh, unsigned int columns, unsigned int rows, Surface surface)
+{
+	unsigned int first = (unsigned int)mesh.vertices.size();
+	for (unsigned int row = 0; row <= rows; row++)
+	{
+		for (unsigned int column = 0; column <= columns; column++)
+		{
+			Vertex vertex;
+			surface((float)column / columns, (float)row / rows, vertex);
+			mesh.vertices.push_back(vertex);
+		}
+	}
+
+	for (unsigned int row = 0; row < rows; row++)
+	{
+		for (unsigned int column = 0; column < columns; column++)
+		{
+			unsigned int a = first + row * (columns + 1) + column;
+			unsigned int b = a + 1;
+			unsigned int c = a + columns + 1;
+			unsigned int d = c + 1;
+			AddTriangle(mesh, a, b, c);
+			AddTriangle(mesh, c, b, d);
+		}
+	}
+}
+
+// --------------------------------------------------------
+// Sweeps rings(v) (v = 0 at the first ring, 1 at the last)
+// around the Y axis in "slices" steps
+// - Rings of radius 0 are poles: each slice gets its own pole
+//    vertex, turned to the middle of the slice so the normal
+//    and UV there are the slice's average
+// --------------------------------------------------------
+template<typename Profile>
+static void AddLathe(PrimitiveMesh& mesh, unsigned int slices, unsigned int rings, Profile profile)
+{
+	float halfSlice = 0.5f / slices;
+	AddGrid(mesh, slices, rings, [&](float u, float v, Vertex& vertex)
+	{
+		LatheRing ring = profile(v);
+		if (ring.radius == 0.0f)
+			u += (v == 0.0f) ? -halfSlice : halfSlice;
+
+		float angle = u * XM_2PI;
+		float c = cosf(angle);
+		float s = sinf(angle);
+		vertex.Position = XMFLOAT3(ring.radius * c, ring.y, ring.radius * s);
+		vertex.Normal = XMFLOAT3(ring.normalRadius * c, ring.normalY, ring.normalRadius * s);
+		vertex.UV = XMFLOAT2(u, v);
+	});
+}
+
+// --------------------------------------------------------
+// Adds a flat, round cap facing "normal", in the plane of the
+// (unit, perpendicular) axes through "center"
+// --------------------------------------------------------
+static void AddDisc(
+	PrimitiveMesh& mesh,
+	XMFLOAT3 center, XMFLOAT3 normal, XMFLOAT3 axisU, XMFLOAT3 axisV,
+	float radius, unsigned int slices)
+{
+	XMVECTOR c = XMLoadFloat3(&center);
+	XMVECTOR u = XMLoadFloat3(&axisU);
+	XMVECTOR v = XMLoadFloat3(&axisV);
+
+	unsigned int first = (unsigned int)mesh.vertices.size();
+	Vertex middle;
+	middle.Position = center;
+	middle.Normal = normal;
+	middle.UV = XMFLOAT2(0.5f, 0.5f);
+	mesh.vertices.push_back(middle);
+
+	for (unsigned int i = 0; i <= slices; i++)
+	{
+		float angle = XM_2PI * i / slices;
+		float cs = cosf(angle);
+		float sn = sinf(angle);
+
+		Vertex vertex;
+		XMStoreFloat3(&vertex.Position, XMVectorAdd(c, XMVectorAdd(XMVectorScale(u, radius * cs), XMVectorScale(v, radius * sn))));
+		vertex.Normal = normal;
+		vertex.UV = XMFLOAT2(0.5f + 0.5f * cs, 0.5f + 0.5f * sn);
+		mesh.vertices.push_back(vertex);
+	}
+
+	// The ring runs from U towards V, so it's already clockwise if
+	// U x V points the way we want to face
+	bool clockwise = XMVectorGetX(XMVector3Dot(XMVector3Cross(u, v), XMLoadFloat3(&normal))) > 0.0f;
+	for (unsigned int i = 0; i < slices; i++)
+	{
+		unsigned int a = first + 1 + i;
+		if (clockwise)
+			AddTriangle(mesh, first, a, a + 1);
+		else
+			AddTriangle(mesh, first, a + 1, a);
+	}
+}
+
+void GenerateCube(PrimitiveMesh& mesh, float size, unsigned int divisions)
+{
+	mesh.vertices.clear();
+	mesh.indices.clear();
+	if (divisions < 1) divisions = 1;
+
+	// Each face's normal, and the direction that's "down" on it
+	static const float faces[6][6] =
+	{
+		{  0,  0, -1,   0, -1,  0 },	// Front (towards the default camera)
+		{  1,  0,  0,   0, -1,  0 },
+		{  0,  0,  1,   0, -1,  0 },
+		{ -1,  0,  0,   0, -1,  0 },
+		{  0,  1,  0,   0,  0, -1 },	// Top: down is towards the front
+		{  0, -1,  0,   0,  0,  1 },
+	};
+
+	for (int f = 0; f < 6; f++)
+	{
+		XMFLOAT3 normal(faces[f][0], faces[f][1], faces[f][2]);
+		XMVECTOR n = XMLoadFloat3(&normal);
+		XMVECTOR down = XMVectorSet(faces[f][3], faces[f][4], faces[f][5], 0.0f);
+		XMVECTOR right = XMVector3Cross(down, n);
+		XMVECTOR center = XMVectorScale(n, size * 0.5f);
+
+		AddGrid(mesh, divisions, divisions, [&](float u, float v, Vertex& vertex)
+		{
+			XMVECTOR p = XMVectorAdd(center, XMVectorAdd(
+				XMVectorScale(right, (u - 0.5f) * size),
+				XMVectorScale(down, (v - 0.5f) * size)));
+			XMStoreFloat3(&vertex.Position, p);
+			vertex.Normal = normal;
+			vertex.UV = XMFLOAT2(u, v);
+		});
+	}
+}
+
+void GenerateSphere(PrimitiveMesh& mesh, float radius, unsigned int slices, unsigned int stacks)
+{
+	mesh.vertices.clear();
+	mesh.indices.clear();
+	if (slices < 3) slices = 3;
+	if (stacks < 2) stacks = 2;
+
+	AddLathe(mesh, slices, stacks, [&](float v)
+	{
+		// The poles are forced to exactly 0 so they're detected
+		float polar = v * XM_PI;
+		float ringRadius = (v == 0.0f || v == 1.0f) ? 0.0f : sinf(polar);
+		float y = cosf(polar);
+		LatheRing ring = { radius * ringRadius, radius * y, ringRadius, y };
+		return ring;
+	});
+}
+
+void GenerateCylinder(PrimitiveMesh& mesh, float radius, float height, unsigned int slices, unsigned int stacks)
+{
+	mesh.vertices.clear();
+	mesh.indices.clear();
+	if (slices < 3) slices = 3;
+	if (stacks < 1) stacks = 1;
+
+	float top = height * 0.5f;
+	AddLathe(mesh, slices, stacks, [&](float v)
+	{
+		LatheRing ring = { radius, top - v * height, 1.0f, 0.0f };
+		return ring;
+	});
+
+	AddDisc(mesh, XMFLOAT3(0, top, 0), XMFLOAT3(0, 1, 0), XMFLOAT3(1, 0, 0), XMFLOAT3(0, 0, 1), radius, slices);
+	AddDisc(mesh, XMFLOAT3(0, -top, 0), XMFLOAT3(0, -1, 0), XMFLOAT3(1, 0, 0), XMFLOAT3(0, 0, 1), radius, slices);
+}
+
+void GenerateCone(PrimitiveMesh& mesh, float radius, float height, unsigned int slices, unsigned int stacks)
+{
+	mesh.vertices.clear();
+	mesh.indices.clear();
+	if (slices < 3) slices = 3;
+	if (stacks < 1) stacks = 1;
+
+	// The side's normal is the same all the way down
+	float slope = sqrtf(radius * radius + height * height);
+	float normalRadius = height / slope;
+	float normalY = radius / slope;
+
+	float top = height * 0.5f;
+	AddLathe(mesh, slices, stacks, [&](float v)
+	{
+		LatheRing ring = { v * radius, top - v * height, normalRadius, normalY };
+		return ring;
+	});
+
+	AddDisc(mesh, XMFLOAT3(0, -top, 0), XMFLOAT3(0, -1, 0), XMFLOAT3(1, 0, 0), XMFLOAT3(0, 0, 1), radius, slices);
+}
+
+void GenerateTorus(PrimitiveMesh& mesh, float majorRadius, float minorRadius, unsigned int majorSegments, unsigned int minorSegments)
+{
+	mesh.vertices.clear();
+	mesh.indices.clear();
+	if (majorSegments < 3) majorSegments = 3;
+	if (minorSegments < 3) minorSegments = 3;
+
+	// The tube's cross section, starting at its outer edge and
+	// heading down (so the outside faces out)
+	AddLathe(mesh, majorSegments, minorSegments, [&](float v)
+	{
+		float angle = -v * XM_2PI;
+		float c = cosf(angle);
+		float s = sinf(angle);
+		LatheRing ring = { majorRadius + minorRadius * c, minorRadius * s, c, s };
+		return ring;
+	});
+}
+
+void GenerateHelix(
+	PrimitiveMesh& mesh,
+	float radius, float tubeRadius, float height, float turns,
+	unsigned int segmentsPerTurn, unsigned int sides, unsigned int strands)
+{
+	mesh.vertices.clear();
+	mesh.indices.clear();
+	if (segmentsPerTurn < 3) segmentsPerTurn = 3;
+	if (sides < 3) sides = 3;
+	if (strands < 1) strands = 1;
+
+	unsigned int segments = (unsigned int)ceilf(turns * segmentsPerTurn);
+	if (segments < 1) segments = 1;
+	float sweep = turns * XM_2PI;
+
+	for (unsigned int strand = 0; strand < strands; strand++)
+	{
+		float phase = XM_2PI * strand / strands;
+
+		// Frame along the tube's centreline at t (0 to 1): the
+		// direction it runs, the way out from the Y axis, and a
+		// third axis at right angles to both
+		auto frame = [&](float t, XMVECTOR& center, XMVECTOR& along, XMVECTOR& out, XMVECTOR& side)
+		{
+			float angle = phase + t * sweep;
+			float c = cosf(angle);
+			float s = sinf(angle);
+			center = XMVectorSet(radius * c, (t - 0.5f) * height, radius * s, 0.0f);
+			along = XMVector3Normalize(XMVectorSet(-radius * s * sweep, height, radius * c * sweep, 0.0f));
+			out = XMVectorSet(c, 0.0f, s, 0.0f);
+			side = XMVector3Cross(along, out);
+		};
+
+		// Around the tube across the grid (starting on its outside),
+		// along it down the grid
+		AddGrid(mesh, sides, segments, [&](float u, float v, Vertex& vertex)
+		{
+			XMVECTOR center, along, out, side;
+			frame(v, center, along, out, side);
+
+			float angle = u * XM_2PI;
+			XMVECTOR normal = XMVectorAdd(XMVectorScale(out, cosf(angle)), XMVectorScale(side, sinf(angle)));
+			XMStoreFloat3(&vertex.Position, XMVectorAdd(center, XMVectorScale(normal, tubeRadius)));
+			XMStoreFloat3(&vertex.Normal, normal);
+			vertex.UV = XMFLOAT2(u, v);
+		});
+
+		// Cap both ends
+		for (int end = 0; end < 2; end++)
+		{
+			XMVECTOR center, along, out, side;
+			frame((float)end, center, along, out, side);
+			if (end == 0)
+				along = XMVectorScale(along, -1.0f);
+
+			XMFLOAT3 c, n, u, v;
+			XMStoreFloat3(&c, center);
+			XMStoreFloat3(&n, along);
+			XMStoreFloat3(&u, out);
+			XMStoreFloat3(&v, side);
+			AddDisc(mesh, c, n, u, v, tubeRadius, sides);
+		}
+	}
+}
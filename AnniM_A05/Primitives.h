@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include "Vertex.h"
+
+// --------------------------------------------------------
+// Procedural primitives
+//
+// Builds the shapes we used to ship as OBJ files (cube, sphere,
+// cylinder, cone, torus and helix) straight into vertex and
+// index arrays, at any tessellation.  The defaults match the
+// sizes of those files.
+//
+// The output follows the OBJ loader's conventions, so it can go
+// anywhere a parsed mesh can (e.g. the Mesh constructor):
+//  - Left-handed positions, Y up
+//  - Clockwise front faces (cross(p1 - p0, p2 - p0) points
+//     along the normal)
+//  - UVs with v running downwards (0 at the top)
+// Seams get duplicated vertices, so the UVs wrap cleanly.
+// --------------------------------------------------------
+struct PrimitiveMesh
+{
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+};
+
+// Axis-aligned cube centred on the origin, each face split
+// into divisions x divisions quads
+void GenerateCube(PrimitiveMesh& mesh, float size = 1.0f, unsigned int divisions = 1);
+
+// UV sphere - slices around the Y axis, stacks from pole to pole
+void GenerateSphere(PrimitiveMesh& mesh, float radius = 0.5f, unsigned int slices = 20, unsigned int stacks = 20);
+
+// Capped cylinder along the Y axis, centred on the origin
+void GenerateCylinder(PrimitiveMesh& mesh, float radius = 0.5f, float height = 1.0f, unsigned int slices = 20, unsigned int stacks = 1);
+
+// Capped cone along the Y axis (apex up), centred on the origin
+void GenerateCone(PrimitiveMesh& mesh, float radius = 0.5f, float height = 1.0f, unsigned int slices = 20, unsigned int stacks = 1);
+
+// Torus around the Y axis - majorRadius is to the centre of the tube
+void GenerateTorus(PrimitiveMesh& mesh, float majorRadius = 0.5f, float minorRadius = 0.2f, unsigned int majorSegments = 20, unsigned int minorSegments = 20);
+
+// --------------------------------------------------------
+// Capped tubes coiled around the Y axis - "strands" of them,
+// evenly spaced around the coil (2 makes a double helix)
+// - radius is to the centre of the tube, and height is from
+//    the centre of the first ring to the centre of the last
+// --------------------------------------------------------
+void GenerateHelix(
+	PrimitiveMesh& mesh,
+	float radius = 0.8f, float tubeRadius = 0.2f, float height = 2.0f, float turns = 3.0f,
+	unsigned int segmentsPerTurn = 50, unsigned int sides = 8, unsigned int strands = 2);
@@ -0,0 +1,134 @@
+#include "RangeAllocator.h"
+
+RangeAllocator::RangeAllocator(unsigned int capacity)
+{
+	this->capacity = capacity;
+	freeSize = 0;
+	if (capacity > 0)
+		AddFree(0, capacity);
+}
+
+void RangeAllocator::AddFree(unsigned int offset, unsigned int size)
+{
+	freeByOffset[offset] = size;
+	freeBySize.insert(std::make_pair(size, offset));
+	freeSize += size;
+}
+
+void RangeAllocator::RemoveFree(std::map<unsigned int, unsigned int>::iterator range)
+{
+	auto sized = freeBySize.equal_range(range->second);
+	for (auto it = sized.first; it != sized.second; ++it)
+	{
+		if (it->second == range->first)
+		{
+			freeBySize.erase(it);
+			break;
+		}
+	}
+
+	freeSize -= range->second;
+	freeByOffset.erase(range);
+}
+
+unsigned int RangeAllocator::Allocate(unsigned int size)
+{
+	if (size == 0)
+		return InvalidOffset;
+
+	// Smallest free range that fits
+	auto best = freeBySize.lower_bound(size);
+	if (best == freeBySize.end())
+		return InvalidOffset;
+
+	unsigned int offset = best->second;
+	unsigned int rangeSize = best->first;
+	RemoveFree(freeByOffset.find(offset));
+
+	// Whatever's left over stays free
+	if (rangeSize > size)
+		AddFree(offset + size, rangeSize - size);
+
+	allocations[offset] = size;
+	return offset;
+}
+
+bool RangeAllocator::Free(unsigned int offset)
+{
+	auto allocation = allocations.find(offset);
+	if (allocation == allocations.end())
+		return false;
+
+	unsigned int size = allocation->second;
+	allocations.erase(allocation);
+
+	// Merge with the free ranges on either side
+	auto next = freeByOffset.lower_bound(offset);
+	if (next != freeByOffset.end() && next->first == offset + size)
+	{
+		size += next->second;
+		RemoveFree(next);
+	}
+
+	auto previous = freeByOffset.lower_bound(offset);
+	if (previous != freeByOffset.begin())
+	{
+		--previous;
+		if (previous->first + previous->second == offset)
+		{
+			offset = previous->first;
+			size += previous->second;
+			RemoveFree(previous);
+		}
+	}
+
+	AddFree(offset, size);
+	return true;
+}
+
+std::vector<RangeAllocator::Move> RangeAllocator::Defragment()
+{
+	std::vector<Move> moves;
+	std::map<unsigned int, unsigned int> packed;
+
+	unsigned int end = 0;
+	for (auto it = allocations.begin(); it != allocations.end(); ++it)
+	{
+		if (it->first != end)
+		{
+			Move move = { it->first, end, it->second };
+			moves.push_back(move);
+		}
+		packed[end] = it->second;
+		end += it->second;
+	}
+
+	allocations.swap(packed);
+	freeByOffset.clear();
+	freeBySize.clear();
+	freeSize = 0;
+	if (end < capacity)
+		AddFree(end, capacity - end);
+
+	return moves;
+}
+
+unsigned int RangeAllocator::GetCapacity()
+{
+	return capacity;
+}
+
+unsigned int RangeAllocator::GetFreeSize()
+{
+	return freeSize;
+}
+
+unsigned int RangeAllocator::GetLargestFreeRange()
+{
+	return freeBySize.empty() ? 0 : freeBySize.rbegin()->first;
+}
+
+unsigned int RangeAllocator::GetAllocationCount()
+{
+	return (unsigned int)allocations.size();
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <map>
+#include <vector>
+
+// --------------------------------------------------------
+// Hands out ranges of a fixed-size space [0, capacity)
+//
+// Knows nothing about what the space is (GeometryPool uses it
+// for vertex and index buffers), so it can be exercised
+// without a device.  Free ranges are kept by offset, so freed
+// neighbours merge straight back together, and by size, so
+// allocations take the smallest range that fits (best fit).
+// --------------------------------------------------------
+class RangeAllocator
+{
+	unsigned int capacity;
+	unsigned int freeSize;
+	std::map<unsigned int, unsigned int> freeByOffset;		// offset -> size
+	std::multimap<unsigned int, unsigned int> freeBySize;	// size -> offset
+	std::map<unsigned int, unsigned int> allocations;		// offset -> size
+
+	void AddFree(unsigned int offset, unsigned int size);
+	void RemoveFree(std::map<unsigned int, unsigned int>::iterator range);
+public:
+	static const unsigned int InvalidOffset = 0xFFFFFFFF;
+
+	// One range that Defragment() moves from "from" to "to"
+	struct Move
+	{
+		unsigned int from;
+		unsigned int to;
+		unsigned int size;
+	};
+
+	RangeAllocator(unsigned int capacity);
+
+	// Returns the offset of the new range, or InvalidOffset if no
+	// free range is big enough (see Defragment)
+	unsigned int Allocate(unsigned int size);
+
+	// Frees the range starting at offset - false if there isn't one
+	bool Free(unsigned int offset);
+
+	// Slides every allocation down to the start of the space, in
+	// order, leaving one free range at the end
+	// - Returns what moved, lowest offset first.  Ranges only ever
+	//    move down, so copying them in that order is safe even
+	//    within one buffer (given a copy that allows overlap).
+	std::vector<Move> Defragment();
+
+	unsigned int GetCapacity();
+	unsigned int GetFreeSize();
+	unsigned int GetLargestFreeRange();
+	unsigned int GetAllocationCount();
+};
@@ -0,0 +1,308 @@
+#include "StreamingMesh.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+// The job that opens the chunk file, in place of a chunk index
+static const unsigned int OpenJob = 0xFFFFFFFF;
+
+StreamingMesh::StreamingMesh(const char* file, ID3D11Device* device, VertexFormat format, UINT64 budgetBytes, unsigned int workerCount)
+{
+	this->file = file;
+	this->device = device;
+	this->format = format;
+	budget = budgetBytes;
+	committedBytes = 0;
+	residentBytes = 0;
+	residentCount = 0;
+	state = MeshState::Loading;
+	header = {};
+	chunks = 0;
+	chunkCount = 0;
+	stopping = false;
+
+	// The first job opens the chunk file
+	jobs.push_back(OpenJob);
+	if (workerCount == 0)
+		workerCount = 1;
+	workers.reserve(workerCount);
+	for (unsigned int i = 0; i < workerCount; i++)
+		workers.emplace_back(&StreamingMesh::WorkerLoop, this);
+}
+
+// --------------------------------------------------------
+// Finishes the chunks being read right now, drops the queue
+// and deletes every resident chunk
+// --------------------------------------------------------
+StreamingMesh::~StreamingMesh()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+		jobs.clear();
+	}
+	jobAdded.notify_all();
+
+	for (size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
+
+	for (unsigned int i = 0; i < chunkCount; i++)
+		delete chunks[i].mesh;
+	delete[] chunks;
+}
+
+// --------------------------------------------------------
+// Reads the chunk table, building the chunk file first when
+// it's missing or out of date
+// --------------------------------------------------------
+bool StreamingMesh::Open()
+{
+	std::vector<MeshChunk> table;
+	if (!ReadMeshChunkTable(file.c_str(), header, table))
+	{
+#if defined(DEBUG) || defined(_DEBUG)
+		printf("Splitting %s into chunks\n", file.c_str());
+#endif
+		if (!BuildMeshChunks(file.c_str()) || !ReadMeshChunkTable(file.c_str(), header, table))
+			return false;
+	}
+
+	// Buffer sizes match what Mesh::CreateBuffers will make (less
+	// any vertices Tangent meshes split along UV mirror seams)
+	UINT stride =
+		format == VertexFormat::Compact ? sizeof(CompactVertex) :
+		format == VertexFormat::Tangent ? sizeof(TangentVertex) : sizeof(Vertex);
+
+	ChunkSlot* slots = new ChunkSlot[table.size()];
+	for (size_t i = 0; i < table.size(); i++)
+	{
+		slots[i].info = table[i];
+		slots[i].state = ChunkState::Unloaded;
+		slots[i].mesh = 0;
+		slots[i].bytes =
+			(UINT64)table[i].vertexCount * stride +
+			(UINT64)table[i].indexCount * (table[i].vertexCount <= 65536 ? sizeof(unsigned short) : sizeof(unsigned int));
+		slots[i].committed = false;
+		slots[i].distance = 0;
+	}
+
+	chunks = slots;
+	chunkCount = (unsigned int)table.size();
+#if defined(DEBUG) || defined(_DEBUG)
+	printf("%s: %u chunks, %llu triangles\n", file.c_str(), chunkCount, (unsigned long long)header.triangleCount);
+#endif
+	return true;
+}
+
+void StreamingMesh::LoadChunk(FILE*& chunkFile, unsigned int index)
+{
+	ChunkSlot& chunk = chunks[index];
+	if (!chunkFile)
+		chunkFile = OpenMeshChunkFile(file.c_str());
+
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	Mesh* mesh = 0;
+	if (chunkFile && ReadMeshChunk(chunkFile, chunk.info, vertices, indices))
+	{
+		// Chunks were optimized when the chunk file was built
+		mesh = new Mesh(&vertices[0], (int)vertices.size(), &indices[0], (int)indices.size(), device, format, false);
+		if (!mesh->IsReady())
+		{
+			delete mesh;
+			mesh = 0;
+		}
+	}
+
+	// The state is what publishes the mesh to the main thread
+	chunk.mesh = mesh;
+	chunk.state = mesh ? ChunkState::Resident : ChunkState::Failed;
+}
+
+void StreamingMesh::WorkerLoop()
+{
+	FILE* chunkFile = 0;
+	for (;;)
+	{
+		unsigned int job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			jobAdded.wait(lock, [this] { return stopping || !jobs.empty(); });
+			if (stopping)
+				break;
+
+			job = jobs.front();
+			jobs.pop_front();
+
+			// Update() only cancels chunks that are still Queued, so
+			// once it's Loading the chunk is this worker's
+			if (job != OpenJob)
+				chunks[job].state = ChunkState::Loading;
+		}
+
+		if (job == OpenJob)
+			state = Open() ? MeshState::Ready : MeshState::Failed;
+		else
+			LoadChunk(chunkFile, job);
+	}
+
+	if (chunkFile)
+		fclose(chunkFile);
+}
+
+// Gives a chunk's bytes back to the budget (main thread only)
+void StreamingMesh::Release(ChunkSlot& chunk)
+{
+	if (chunk.committed)
+		committedBytes -= chunk.bytes;
+	chunk.committed = false;
+}
+
+void StreamingMesh::Update(XMFLOAT3 viewPosition)
+{
+	if (state != MeshState::Ready)
+		return;
+
+	// Distance to the nearest point of each chunk's bounds, so
+	// the chunk the viewer is inside comes first
+	for (unsigned int i = 0; i < chunkCount; i++)
+	{
+		const MeshChunk& info = chunks[i].info;
+		float dx = std::max(0.0f, std::max(info.boundsMin.x - viewPosition.x, viewPosition.x - info.boundsMax.x));
+		float dy = std::max(0.0f, std::max(info.boundsMin.y - viewPosition.y, viewPosition.y - info.boundsMax.y));
+		float dz = std::max(0.0f, std::max(info.boundsMin.z - viewPosition.z, viewPosition.z - info.boundsMax.z));
+		chunks[i].distance = sqrtf(dx * dx + dy * dy + dz * dz);
+	}
+
+	order.resize(chunkCount);
+	for (unsigned int i = 0; i < chunkCount; i++)
+		order[i] = i;
+	std::sort(order.begin(), order.end(), [this](unsigned int a, unsigned int b)
+	{
+		return chunks[a].distance < chunks[b].distance;
+	});
+
+	// The wanted chunks are the nearest ones that fit in the
+	// budget together (stopping at the first that doesn't, so
+	// there are no holes nearer than the furthest one)
+	// - Chunks that failed to load are left out for good
+	size_t wanted = 0;
+	for (UINT64 total = 0; wanted < order.size(); wanted++)
+	{
+		ChunkSlot& chunk = chunks[order[wanted]];
+		if (chunk.state == ChunkState::Failed)
+			continue;
+		if (total + chunk.bytes > budget)
+			break;
+		total += chunk.bytes;
+	}
+
+	// Evict resident chunks that aren't wanted anymore
+	residentBytes = 0;
+	residentCount = 0;
+	for (size_t k = 0; k < order.size(); k++)
+	{
+		ChunkSlot& chunk = chunks[order[k]];
+		ChunkState current = chunk.state;
+		if (current == ChunkState::Failed)
+			Release(chunk);
+		else if (current == ChunkState::Resident)
+		{
+			if (k >= wanted)
+			{
+				delete chunk.mesh;
+				chunk.mesh = 0;
+				chunk.state = ChunkState::Unloaded;
+				Release(chunk);
+			}
+			else
+			{
+				residentBytes += chunk.mesh->GetResidentBytes();
+				residentCount++;
+			}
+		}
+	}
+
+	// Rebuild the queue nearest first: unwanted chunks that are
+	// still waiting are cancelled, and missing ones are added
+	// while the budget has room (chunks still loading keep their
+	// share of it until the next update can evict them)
+	bool added = false;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		jobs.clear();
+		for (size_t k = 0; k < order.size(); k++)
+		{
+			ChunkSlot& chunk = chunks[order[k]];
+			ChunkState current = chunk.state;
+			if (current == ChunkState::Queued && k >= wanted)
+			{
+				chunk.state = ChunkState::Unloaded;
+				Release(chunk);
+			}
+			else if (current == ChunkState::Queued)
+				jobs.push_back(order[k]);
+			else if (current == ChunkState::Unloaded && k < wanted && committedBytes + chunk.bytes <= budget)
+			{
+				chunk.state = ChunkState::Queued;
+				chunk.committed = true;
+				committedBytes += chunk.bytes;
+				jobs.push_back(order[k]);
+				added = true;
+			}
+		}
+	}
+	if (added)
+		jobAdded.notify_all();
+}
+
+MeshState StreamingMesh::GetState()
+{
+	return state;
+}
+
+bool StreamingMesh::IsReady()
+{
+	return state == MeshState::Ready;
+}
+
+unsigned int StreamingMesh::GetChunkCount()
+{
+	return state == MeshState::Ready ? chunkCount : 0;
+}
+
+const MeshChunk& StreamingMesh::GetChunk(unsigned int index)
+{
+	return chunks[index].info;
+}
+
+ChunkState StreamingMesh::GetChunkState(unsigned int index)
+{
+	return chunks[index].state;
+}
+
+Mesh* StreamingMesh::GetResidentChunk(unsigned int index)
+{
+	return chunks[index].state == ChunkState::Resident ? chunks[index].mesh : 0;
+}
+
+unsigned int StreamingMesh::GetResidentCount()
+{
+	return residentCount;
+}
+
+UINT64 StreamingMesh::GetResidentBytes()
+{
+	return residentBytes;
+}
+
+UINT64 StreamingMesh::GetCommittedBytes()
+{
+	return committedBytes;
+}
+
+UINT64 StreamingMesh::GetBudget()
+{
+	return budget;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <d3d11.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Mesh.h"
+#include "MeshChunker.h"
+
+enum class ChunkState { Unloaded, Queued, Loading, Resident, Failed };
+
+// --------------------------------------------------------
+// A model too big to load at once, drawn from the chunks
+// BuildMeshChunks() split it into
+//
+// Each Update() ranks the chunks by distance from the viewer and
+// keeps the nearest ones resident, up to a budget of GPU memory:
+//  - Resident chunks that fell out of the nearest set are deleted
+//  - Missing chunks in the nearest set are queued for the
+//    background workers, nearest first, as soon as the budget
+//    has room for them
+// Queued and loading chunks count against the budget too, so the
+// budget is never exceeded, even briefly.
+//
+// The chunk file is opened (and built first, if it's missing or
+// out of date) by a worker as well - until then the mesh is
+// Loading and has no chunks.  Draw whatever GetResidentChunk()
+// returns; every chunk is a plain Mesh with a single submesh.
+// --------------------------------------------------------
+class StreamingMesh
+{
+	struct ChunkSlot
+	{
+		MeshChunk info;
+		std::atomic<ChunkState> state;
+		Mesh* mesh;				// Set by the worker before it marks the chunk Resident
+		UINT64 bytes;			// Buffer sizes the chunk's mesh will have
+		bool committed;			// Counted in committedBytes (main thread only)
+		float distance;			// From the last Update()
+	};
+
+	std::string file;
+	ID3D11Device* device;
+	VertexFormat format;
+	UINT64 budget;
+	UINT64 committedBytes;		// Queued, loading and resident chunks
+	UINT64 residentBytes;
+	unsigned int residentCount;
+
+	std::atomic<MeshState> state;
+	MeshChunkHeader header;
+	ChunkSlot* chunks;			// Written once by the worker that opens the file
+	unsigned int chunkCount;
+	std::vector<unsigned int> order;	// Chunks by distance (scratch for Update)
+
+	std::vector<std::thread> workers;
+	std::deque<unsigned int> jobs;		// Chunks to load, nearest first (the first job opens the file instead)
+	std::mutex mutex;
+	std::condition_variable jobAdded;
+	bool stopping;
+
+	void WorkerLoop();
+	bool Open();
+	void LoadChunk(FILE*& chunkFile, unsigned int index);
+	void Release(ChunkSlot& chunk);
+public:
+	// file - the OBJ file (its chunk file sits next to it)
+	// budgetBytes - GPU memory the resident chunks may take up
+	// workerCount - threads reading chunks in the background
+	StreamingMesh(const char* file, ID3D11Device* device, VertexFormat format, UINT64 budgetBytes, unsigned int workerCount = 1);
+	~StreamingMesh();
+
+	// Picks the chunks to keep for a viewer at viewPosition (in
+	// the model's space) and evicts or queues chunks to match
+	void Update(DirectX::XMFLOAT3 viewPosition);
+
+	MeshState GetState();
+	bool IsReady();
+	unsigned int GetChunkCount();
+	const MeshChunk& GetChunk(unsigned int index);
+	ChunkState GetChunkState(unsigned int index);
+
+	// The chunk's mesh, or null unless it's resident right now
+	Mesh* GetResidentChunk(unsigned int index);
+
+	// Totals as of the last Update()
+	unsigned int GetResidentCount();
+	UINT64 GetResidentBytes();
+	UINT64 GetCommittedBytes();
+	UINT64 GetBudget();
+
+	StreamingMesh(const StreamingMesh&) = delete;
+	StreamingMesh& operator=(const StreamingMesh&) = delete;
+};
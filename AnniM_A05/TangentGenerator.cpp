@@ -0,0 +1,181 @@
+#include "TangentGenerator.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+using namespace DirectX;
+
+// Vectors shorter than this are treated as zero
+static const float TangentEpsilon = 1e-12f;
+
+// --------------------------------------------------------
+// Per triangle: unit tangent and bitangent, plus the angle at
+// each corner (the weight of its contribution to that vertex)
+// --------------------------------------------------------
+struct TriangleFrame
+{
+	XMFLOAT3 tangent;
+	XMFLOAT3 bitangent;
+	float angles[3];
+	float handedness;	// +1 or -1, or 0 when the UVs can't say
+};
+
+// --------------------------------------------------------
+// Projects v onto the plane with normal n and normalizes it,
+// or returns zero if nothing is left
+// --------------------------------------------------------
+static XMVECTOR XM_CALLCONV ProjectOntoPlane(FXMVECTOR v, FXMVECTOR n)
+{
+	XMVECTOR projected = XMVectorSubtract(v, XMVectorMultiply(n, XMVector3Dot(n, v)));
+	if (XMVectorGetX(XMVector3LengthSq(projected)) <= TangentEpsilon)
+		return XMVectorZero();
+	return XMVector3Normalize(projected);
+}
+
+void GenerateTangents(
+	std::vector<Vertex>& vertices,
+	std::vector<unsigned int>& indices,
+	size_t frameIndexCount,
+	std::vector<XMFLOAT4>& tangents,
+	unsigned int threadCount)
+{
+	size_t triangleCount = indices.size() / 3;
+	size_t frameTriangles = std::min(frameIndexCount, indices.size()) / 3;
+	threadCount = ResolveThreadCount(threadCount);
+	std::vector<TriangleFrame> frames(triangleCount);
+
+	// Triangle frames, from the UV gradients across each triangle
+	ParallelFor(triangleCount, threadCount, [&](size_t begin, size_t end, size_t)
+	{
+		for (size_t t = begin; t < end; t++)
+		{
+			const Vertex& v0 = vertices[indices[t * 3 + 0]];
+			const Vertex& v1 = vertices[indices[t * 3 + 1]];
+			const Vertex& v2 = vertices[indices[t * 3 + 2]];
+			TriangleFrame& frame = frames[t];
+
+			XMVECTOR p0 = XMLoadFloat3(&v0.Position);
+			XMVECTOR p1 = XMLoadFloat3(&v1.Position);
+			XMVECTOR p2 = XMLoadFloat3(&v2.Position);
+			XMVECTOR e1 = XMVectorSubtract(p1, p0);
+			XMVECTOR e2 = XMVectorSubtract(p2, p0);
+
+			float du1 = v1.UV.x - v0.UV.x, dv1 = v1.UV.y - v0.UV.y;
+			float du2 = v2.UV.x - v0.UV.x, dv2 = v2.UV.y - v0.UV.y;
+			float area = du1 * dv2 - du2 * dv1;
+
+			// Triangles with no UV area can't say anything about tangents
+			XMVECTOR tangent = XMVectorZero();
+			XMVECTOR bitangent = XMVectorZero();
+			frame.handedness = 0.0f;
+			if (area > TangentEpsilon || area < -TangentEpsilon)
+			{
+				float scale = 1.0f / area;
+				tangent = XMVectorScale(XMVectorSubtract(XMVectorScale(e1, dv2), XMVectorScale(e2, dv1)), scale);
+				bitangent = XMVectorScale(XMVectorSubtract(XMVectorScale(e2, du1), XMVectorScale(e1, du2)), scale);
+
+				// cross(tangent, bitangent) is cross(e1, e2) / area, so
+				// the sign is which side of the vertex normals that is
+				XMVECTOR normals = XMVectorAdd(XMVectorAdd(XMLoadFloat3(&v0.Normal), XMLoadFloat3(&v1.Normal)), XMLoadFloat3(&v2.Normal));
+				float facing = XMVectorGetX(XMVector3Dot(normals, XMVector3Cross(e1, e2))) * area;
+				frame.handedness = facing > 0.0f ? 1.0f : facing < 0.0f ? -1.0f : 0.0f;
+			}
+			XMStoreFloat3(&frame.tangent, tangent);
+			XMStoreFloat3(&frame.bitangent, bitangent);
+
+			// Corner angles (zero for degenerate corners)
+			XMVECTOR corners[3] = { p0, p1, p2 };
+			for (int k = 0; k < 3; k++)
+			{
+				XMVECTOR a = XMVectorSubtract(corners[(k + 1) % 3], corners[k]);
+				XMVECTOR b = XMVectorSubtract(corners[(k + 2) % 3], corners[k]);
+				if (XMVectorGetX(XMVector3LengthSq(a)) <= TangentEpsilon || XMVectorGetX(XMVector3LengthSq(b)) <= TangentEpsilon)
+				{
+					frame.angles[k] = 0.0f;
+					continue;
+				}
+				frame.angles[k] = XMVectorGetX(XMVector3AngleBetweenNormals(XMVector3Normalize(a), XMVector3Normalize(b)));
+			}
+		}
+	});
+
+	// Split vertices along mirror seams: each vertex takes the
+	// handedness of the first triangle that has one, and corners
+	// of the other handedness move to a copy (made once)
+	size_t originalCount = vertices.size();
+	std::vector<float> handedness(originalCount, 0.0f);
+	std::vector<unsigned int> mirrored(originalCount, UINT_MAX);
+	for (size_t i = 0; i < triangleCount * 3; i++)
+	{
+		float sign = frames[i / 3].handedness;
+		unsigned int v = indices[i];
+		if (sign == 0.0f || handedness[v] == sign)
+			continue;
+		if (handedness[v] == 0.0f)
+		{
+			handedness[v] = sign;
+			continue;
+		}
+
+		if (mirrored[v] == UINT_MAX)
+		{
+			Vertex copy = vertices[v];
+			mirrored[v] = (unsigned int)vertices.size();
+			vertices.push_back(copy);
+			handedness.push_back(sign);
+		}
+		indices[i] = mirrored[v];
+	}
+	size_t vertexCount = vertices.size();
+	tangents.resize(vertexCount);
+
+	// Corners around each vertex (CSR), for the frame triangles
+	std::vector<unsigned int> firstCorner(vertexCount + 1, 0);
+	std::vector<unsigned int> corners(frameTriangles * 3);
+	for (size_t i = 0; i < frameTriangles * 3; i++)
+		firstCorner[indices[i] + 1]++;
+	for (size_t v = 0; v < vertexCount; v++)
+		firstCorner[v + 1] += firstCorner[v];
+	{
+		std::vector<unsigned int> fill(firstCorner.begin(), firstCorner.end() - 1);
+		for (size_t i = 0; i < frameTriangles * 3; i++)
+			corners[fill[indices[i]]++] = (unsigned int)i;
+	}
+
+	// Each vertex sums its own corners, then builds its frame
+	ParallelFor(vertexCount, threadCount, [&](size_t begin, size_t end, size_t)
+	{
+		for (size_t v = begin; v < end; v++)
+		{
+			XMVECTOR normal = XMVector3Normalize(XMLoadFloat3(&vertices[v].Normal));
+			XMVECTOR tangentSum = XMVectorZero();
+			XMVECTOR bitangentSum = XMVectorZero();
+
+			for (unsigned int c = firstCorner[v]; c < firstCorner[v + 1]; c++)
+			{
+				const TriangleFrame& frame = frames[corners[c] / 3];
+				float weight = frame.angles[corners[c] % 3];
+				tangentSum = XMVectorAdd(tangentSum, XMVectorScale(ProjectOntoPlane(XMLoadFloat3(&frame.tangent), normal), weight));
+				bitangentSum = XMVectorAdd(bitangentSum, XMVectorScale(ProjectOntoPlane(XMLoadFloat3(&frame.bitangent), normal), weight));
+			}
+
+			// Gram-Schmidt against the normal - and if nothing useful
+			// came in (no UVs, say), any direction in the plane will do
+			XMVECTOR tangent = ProjectOntoPlane(tangentSum, normal);
+			if (XMVectorGetX(XMVector3LengthSq(tangent)) <= TangentEpsilon)
+			{
+				XMVECTOR axis = fabsf(XMVectorGetX(normal)) < 0.9f ? XMVectorSet(1, 0, 0, 0) : XMVectorSet(0, 1, 0, 0);
+				tangent = ProjectOntoPlane(axis, normal);
+			}
+
+			// Which way the bitangent points relative to cross(n, t) -
+			// every triangle around the vertex now agrees on that, and
+			// vertices only the simplified levels use keep theirs too
+			float sign = handedness[v];
+			if (sign == 0.0f)
+				sign = XMVectorGetX(XMVector3Dot(XMVector3Cross(normal, tangent), bitangentSum)) < 0.0f ? -1.0f : 1.0f;
+			XMStoreFloat4(&tangents[v], XMVectorSetW(tangent, sign));
+		}
+	});
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <DirectXMath.h>
+#include <vector>
+#include "Vertex.h"
+
+// --------------------------------------------------------
+// Generates a tangent frame for every vertex, for normal mapping
+//
+// Each triangle's UV-derived tangent and bitangent are projected
+// onto the plane of the vertex normal and summed with the
+// triangle's angle at that corner as the weight, then the
+// tangent is orthonormalized against the normal - the same
+// weighting MikkTSpace uses.  Like MikkTSpace, a vertex shared
+// by mirrored and unmirrored triangles (a UV mirror seam) is
+// split first: it gets a copy, appended to vertices, and the
+// corners of the triangles with the other handedness are
+// remapped to it, so each frame only averages triangles that
+// agree on its sign.
+// The output matches TangentVertex::Tangent - w is the sign of
+// the bitangent, so bitangent = cross(normal, tangent.xyz) * w.
+//
+// Triangles are processed in parallel ranges, then vertices
+// (each summing its own corners, so no locking), with the
+// vector math in DirectXMath (SIMD).
+//
+// - Every index is remapped, but only the first frameIndexCount
+//    contribute to the frames (LOD 0 - the simplified levels
+//    reuse its vertices and would just count twice)
+// - tangents gets one value per vertex, copies included
+// - threadCount - 0 means one per hardware thread
+// --------------------------------------------------------
+void GenerateTangents(
+	std::vector<Vertex>& vertices,
+	std::vector<unsigned int>& indices,
+	size_t frameIndexCount,
+	std::vector<DirectX::XMFLOAT4>& tangents,
+	unsigned int threadCount = 0);
@@ -0,0 +1,218 @@
+// --------------------------------------------------------
+// MeshLoaderBench - times the OBJ loading path on a set of
+// files (e.g. ones written by ObjCorpusGen)
+//
+// Usage:
+//   MeshLoaderBench [options] <file.obj>...
+//
+// Options:
+//   -threads <n>      Threads for parsing and tangents (default 0,
+//                     one per hardware thread)
+//   -format <f>       full, compact or tangent (default compact,
+//                     as the game uses)
+//   -runs <n>         Times to run each stage (default 1)
+//
+// Each file goes through three stages:
+//   parse - ParseObjFile only (no device)
+//   cold  - a Mesh with no cache: parse, optimize, LODs,
+//           meshlets, write the cache and upload
+//   warm  - a Mesh from the cache the cold stage wrote
+//
+// Every run is a separate process (this program again, with
+// -stage), so each one starts with an empty heap and its peak
+// memory is its own.  MB/s is always the OBJ file's size over
+// the time taken, so the stages can be compared directly.
+// --------------------------------------------------------
+
+#include <Windows.h>
+#include <psapi.h>
+#include <d3d11.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <chrono>
+#include "../Mesh.h"
+#include "../MeshCache.h"
+#include "../ObjParser.h"
+
+#pragma comment(lib, "d3d11.lib")
+#pragma comment(lib, "psapi.lib")
+
+struct BenchOptions
+{
+	unsigned int threads;
+	VertexFormat format;
+	const char* formatName;
+	int runs;
+};
+
+// --------------------------------------------------------
+// A device with no window - hardware if there is one, else WARP
+// --------------------------------------------------------
+static ID3D11Device* CreateBenchDevice()
+{
+	D3D_DRIVER_TYPE types[] = { D3D_DRIVER_TYPE_HARDWARE, D3D_DRIVER_TYPE_WARP };
+	for (D3D_DRIVER_TYPE type : types)
+	{
+		ID3D11Device* device = 0;
+		if (SUCCEEDED(D3D11CreateDevice(0, type, 0, 0, 0, 0, D3D11_SDK_VERSION, &device, 0, 0)))
+			return device;
+	}
+	return 0;
+}
+
+static double FileMegabytes(const char* file)
+{
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if (!GetFileAttributesExA(file, GetFileExInfoStandard, &data))
+		return 0.0;
+	return (((unsigned long long)data.nFileSizeHigh << 32) | data.nFileSizeLow) / (1024.0 * 1024.0);
+}
+
+// --------------------------------------------------------
+// Runs one stage on one file in this process and prints its
+// row of the results
+// --------------------------------------------------------
+static int RunStage(const char* stage, const char* file, const BenchOptions& options)
+{
+	ID3D11Device* device = 0;
+	if (strcmp(stage, "parse") != 0)
+	{
+		device = CreateBenchDevice();
+		if (!device)
+		{
+			fprintf(stderr, "Couldn't create a D3D11 device\n");
+			return 1;
+		}
+	}
+
+	// The cold stage must not find a cache
+	if (strcmp(stage, "cold") == 0)
+		DeleteFileA(GetMeshCachePath(file).c_str());
+
+	bool ok = false;
+	size_t triangles = 0;
+	auto start = std::chrono::high_resolution_clock::now();
+	if (!device)
+	{
+		ObjMeshData data;
+		ok = ParseObjFile(file, data, options.threads);
+		triangles = data.indices.size() / 3;
+	}
+	else
+	{
+		Mesh* mesh = new Mesh(file, device, options.format, options.threads);
+		ok = mesh->IsReady();
+		if (ok)
+			triangles = mesh->GetLod(0).indexCount / 3;
+		delete mesh;
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+	PROCESS_MEMORY_COUNTERS memory = {};
+	GetProcessMemoryInfo(GetCurrentProcess(), &memory, sizeof(memory));
+	if (device) device->Release();
+
+	double megabytes = FileMegabytes(file);
+	const char* name = strrchr(file, '\\');
+	if (!name) name = strrchr(file, '/');
+	name = name ? name + 1 : file;
+
+	if (!ok)
+	{
+		printf("%-32s %-6s failed\n", name, stage);
+		return 1;
+	}
+	printf("%-32s %-6s %10.1f %12zu %10.1f %10.1f %10.1f %10.1f\n",
+		name, stage, megabytes, triangles, seconds * 1000.0, megabytes / seconds,
+		memory.PeakPagefileUsage / (1024.0 * 1024.0), memory.PeakWorkingSetSize / (1024.0 * 1024.0));
+	fflush(stdout);
+	return 0;
+}
+
+// --------------------------------------------------------
+// Runs this program again for a single stage, sharing our
+// console, and waits for it
+// --------------------------------------------------------
+static bool SpawnStage(const char* stage, const char* file, const BenchOptions& options)
+{
+	char self[MAX_PATH];
+	GetModuleFileNameA(0, self, MAX_PATH);
+
+	char threads[16];
+	snprintf(threads, sizeof(threads), "%u", options.threads);
+	std::string command = std::string("\"") + self + "\" -stage " + stage +
+		" -threads " + threads + " -format " + options.formatName + " \"" + file + "\"";
+
+	STARTUPINFOA startup = {};
+	startup.cb = sizeof(startup);
+	PROCESS_INFORMATION process = {};
+	if (!CreateProcessA(0, &command[0], 0, 0, TRUE, 0, 0, 0, &startup, &process))
+		return false;
+
+	WaitForSingleObject(process.hProcess, INFINITE);
+	DWORD exitCode = 1;
+	GetExitCodeProcess(process.hProcess, &exitCode);
+	CloseHandle(process.hThread);
+	CloseHandle(process.hProcess);
+	return exitCode == 0;
+}
+
+static int Usage()
+{
+	fprintf(stderr, "Usage: MeshLoaderBench [-threads n] [-format full|compact|tangent] [-runs n] <file.obj>...\n");
+	return 1;
+}
+
+int main(int argc, char* argv[])
+{
+	BenchOptions options = {};
+	options.format = VertexFormat::Compact;
+	options.formatName = "compact";
+	options.runs = 1;
+
+	const char* stage = 0;
+	int firstFile = argc;
+	for (int i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (strcmp(arg, "-threads") == 0 && hasValue)
+			options.threads = (unsigned int)atoi(argv[++i]);
+		else if (strcmp(arg, "-runs") == 0 && hasValue)
+			options.runs = atoi(argv[++i]);
+		else if (strcmp(arg, "-stage") == 0 && hasValue)
+			stage = argv[++i];
+		else if (strcmp(arg, "-format") == 0 && hasValue)
+		{
+			options.formatName = argv[++i];
+			if (strcmp(options.formatName, "full") == 0) options.format = VertexFormat::Full;
+			else if (strcmp(options.formatName, "compact") == 0) options.format = VertexFormat::Compact;
+			else if (strcmp(options.formatName, "tangent") == 0) options.format = VertexFormat::Tangent;
+			else return Usage();
+		}
+		else if (arg[0] != '-')
+		{
+			firstFile = i;
+			break;
+		}
+		else
+			return Usage();
+	}
+	if (firstFile == argc)
+		return Usage();
+
+	// A child process: one stage, one file
+	if (stage)
+		return RunStage(stage, argv[firstFile], options);
+
+	printf("%-32s %-6s %10s %12s %10s %10s %10s %10s\n", "file", "stage", "MB", "triangles", "ms", "MB/s", "peak priv", "peak WS");
+	static const char* stages[] = { "parse", "cold", "warm" };
+	bool ok = true;
+	for (int f = firstFile; f < argc; f++)
+		for (const char* s : stages)
+			for (int run = 0; run < options.runs; run++)
+				ok &= SpawnStage(s, argv[f], options);
+	return ok ? 0 : 1;
+}
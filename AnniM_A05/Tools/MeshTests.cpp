@@ -0,0 +1,1460 @@
+// --------------------------------------------------------
+// MeshTests - checks the CPU side of the mesh pipeline (and
+// the transform hierarchy), with no window or device
+//
+// Usage:
+//   MeshTests [model directory]
+//
+// The directory holds the OBJ models that used to ship with
+// the game (cone, cube, cylinder, helix, sphere and torus) -
+// by default ..\x64\Debug\, where they are when this is run
+// from the Tools folder.  Every failed check is printed, and
+// the exit code is the number of failures (0 = all passed).
+// --------------------------------------------------------
+
+#include <DirectXMath.h>
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include "../MeshCodec.h"
+#include "../MeshletBuilder.h"
+#include "../MeshOptimizer.h"
+#include "../MeshSimplifier.h"
+#include "../ObjParser.h"
+#include "../Primitives.h"
+#include "../RangeAllocator.h"
+#include "../TangentGenerator.h"
+#include "../TransformSystem.h"
+#include "../VertexCompression.h"
+
+using namespace DirectX;
+
+static const char* ModelNames[] = { "cone", "cube", "cylinder", "helix", "sphere", "torus" };
+
+static int failures = 0;
+static int checks = 0;
+
+// --------------------------------------------------------
+// Counts a check, and prints it (printf style) if it failed
+// - Returns "ok", so a test can stop after its first failure
+//    where carrying on would just repeat it
+// --------------------------------------------------------
+static bool Check(bool ok, const char* format, ...)
+{
+	checks++;
+	if (ok)
+		return true;
+
+	failures++;
+	printf("FAILED: ");
+	va_list args;
+	va_start(args, format);
+	vprintf(format, args);
+	va_end(args);
+	printf("\n");
+	return false;
+}
+
+static XMFLOAT3 Subtract(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	return XMFLOAT3(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+static float Dot(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+// Unit face normal (clockwise winding faces the viewer), or
+// false for a degenerate triangle
+static bool FaceNormal(const Vertex* vertices, const unsigned int* triangle, XMFLOAT3& normal)
+{
+	XMFLOAT3 e1 = Subtract(vertices[triangle[1]].Position, vertices[triangle[0]].Position);
+	XMFLOAT3 e2 = Subtract(vertices[triangle[2]].Position, vertices[triangle[0]].Position);
+	normal = XMFLOAT3(e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x);
+	float length = sqrtf(Dot(normal, normal));
+	if (length <= 0.0f)
+		return false;
+	normal = XMFLOAT3(normal.x / length, normal.y / length, normal.z / length);
+	return true;
+}
+
+// --------------------------------------------------------
+// Triangles as sorted, comparable keys - each one rotated to
+// start at its smallest index, so the winding is kept but
+// where it starts isn't
+// --------------------------------------------------------
+struct TriangleKey
+{
+	unsigned int v[3];
+	bool operator<(const TriangleKey& other) const
+	{
+		return std::lexicographical_compare(v, v + 3, other.v, other.v + 3);
+	}
+	bool operator==(const TriangleKey& other) const
+	{
+		return v[0] == other.v[0] && v[1] == other.v[1] && v[2] == other.v[2];
+	}
+};
+
+static std::vector<TriangleKey> GetTriangleKeys(const std::vector<unsigned int>& indices)
+{
+	std::vector<TriangleKey> keys(indices.size() / 3);
+	for (size_t t = 0; t < keys.size(); t++)
+	{
+		const unsigned int* triangle = &indices[t * 3];
+		int first = (triangle[1] < triangle[0] && triangle[1] <= triangle[2]) ? 1 : (triangle[2] < triangle[0] && triangle[2] < triangle[1]) ? 2 : 0;
+		for (int k = 0; k < 3; k++)
+			keys[t].v[k] = triangle[(first + k) % 3];
+	}
+	std::sort(keys.begin(), keys.end());
+	return keys;
+}
+
+// Repeatable pseudo-random numbers in [0, 1)
+static float NextRandom(unsigned int& state)
+{
+	state = state * 1664525u + 1013904223u;
+	return (state >> 8) * (1.0f / 16777216.0f);
+}
+
+static bool LoadModel(const std::string& directory, const char* name, ObjMeshData& mesh)
+{
+	std::string file = directory + name + ".obj";
+	return Check(ParseObjFile(file.c_str(), mesh), "%s: couldn't load", file.c_str());
+}
+
+// --------------------------------------------------------
+// Meshlets (MeshletBuilder)
+// - Every triangle lands in exactly one meshlet (the meshlets
+//    tile the index buffer, which holds the same triangles)
+// - Each meshlet stays within the vertex and triangle limits
+// - Every meshlet vertex is inside its bounding sphere
+// - Every triangle's normal is inside the normal cone, every
+//    triangle's plane has the apex behind it, and a camera the
+//    cone calls backfacing really does see every triangle from
+//    behind
+// --------------------------------------------------------
+static void TestMeshlets(const char* name, const std::vector<Vertex>& vertices, std::vector<unsigned int> indices)
+{
+	OptimizeVertexCache(&indices[0], indices.size(), vertices.size());
+	std::vector<TriangleKey> before = GetTriangleKeys(indices);
+	std::vector<Meshlet> meshlets = BuildMeshlets(&vertices[0], vertices.size(), &indices[0], indices.size());
+	Check(GetTriangleKeys(indices) == before, "%s: meshlets changed the set of triangles", name);
+
+	// Tolerances scale with the model
+	XMFLOAT3 boundsMin = vertices[0].Position, boundsMax = vertices[0].Position;
+	for (const Vertex& v : vertices)
+	{
+		boundsMin = XMFLOAT3(std::min(boundsMin.x, v.Position.x), std::min(boundsMin.y, v.Position.y), std::min(boundsMin.z, v.Position.z));
+		boundsMax = XMFLOAT3(std::max(boundsMax.x, v.Position.x), std::max(boundsMax.y, v.Position.y), std::max(boundsMax.z, v.Position.z));
+	}
+	XMFLOAT3 extent = Subtract(boundsMax, boundsMin);
+	float size = sqrtf(Dot(extent, extent));
+	float distanceTolerance = size * 1e-5f;
+
+	unsigned int next = 0;
+	std::vector<unsigned int> seen(vertices.size(), 0);
+	unsigned int seed = 1;
+	for (size_t m = 0; m < meshlets.size(); m++)
+	{
+		const Meshlet& meshlet = meshlets[m];
+		const unsigned int* first = &indices[0] + meshlet.startIndex;
+		unsigned int triangles = meshlet.indexCount / 3;
+
+		if (!Check(meshlet.startIndex == next && meshlet.indexCount % 3 == 0 && triangles > 0,
+			"%s: meshlet %zu covers [%u, +%u), expected to start at %u", name, m, meshlet.startIndex, meshlet.indexCount, next))
+			return;
+		next += meshlet.indexCount;
+		Check(triangles <= MeshletMaxTriangles, "%s: meshlet %zu has %u triangles", name, m, triangles);
+
+		// Unique vertices (seen[] holds the meshlet number + 1)
+		unsigned int unique = 0;
+		float worstOutside = 0.0f;
+		for (unsigned int i = 0; i < meshlet.indexCount; i++)
+		{
+			unsigned int v = first[i];
+			if (seen[v] != m + 1)
+			{
+				seen[v] = (unsigned int)m + 1;
+				unique++;
+			}
+			XMFLOAT3 offset = Subtract(vertices[v].Position, meshlet.center);
+			worstOutside = std::max(worstOutside, sqrtf(Dot(offset, offset)) - meshlet.radius);
+		}
+		Check(unique <= MeshletMaxVertices, "%s: meshlet %zu has %u vertices", name, m, unique);
+		Check(unique == meshlet.vertexCount, "%s: meshlet %zu says %u vertices, has %u", name, m, meshlet.vertexCount, unique);
+		Check(worstOutside <= 0.0f, "%s: meshlet %zu has a vertex %g outside its sphere", name, m, worstOutside);
+
+		if (meshlet.coneCutoff >= 1.0f)
+			continue;
+
+		// cutoff = sin(half angle), so every normal is within
+		// cos(half angle) of the axis
+		float minDot = sqrtf(1.0f - meshlet.coneCutoff * meshlet.coneCutoff);
+		for (unsigned int t = 0; t < triangles; t++)
+		{
+			XMFLOAT3 normal;
+			if (!FaceNormal(&vertices[0], first + t * 3, normal))
+				continue;
+			float dp = Dot(normal, meshlet.coneAxis);
+			if (!Check(dp >= minDot - 1e-4f, "%s: meshlet %zu triangle %u normal is outside the cone (%g < %g)", name, m, t, dp, minDot))
+				break;
+			float behind = Dot(Subtract(vertices[first[t * 3]].Position, meshlet.coneApex), normal);
+			if (!Check(behind >= -distanceTolerance, "%s: meshlet %zu apex is %g in front of triangle %u", name, m, -behind, t))
+				break;
+		}
+
+		// Cameras scattered around the model
+		for (int c = 0; c < 64; c++)
+		{
+			XMFLOAT3 camera(
+				boundsMin.x + (NextRandom(seed) * 4 - 1.5f) * extent.x,
+				boundsMin.y + (NextRandom(seed) * 4 - 1.5f) * extent.y,
+				boundsMin.z + (NextRandom(seed) * 4 - 1.5f) * extent.z);
+			if (!IsMeshletBackfacing(meshlet, camera))
+				continue;
+
+			for (unsigned int t = 0; t < triangles; t++)
+			{
+				XMFLOAT3 normal;
+				if (!FaceNormal(&vertices[0], first + t * 3, normal))
+					continue;
+				float facing = Dot(Subtract(camera, vertices[first[t * 3]].Position), normal);
+				if (!Check(facing <= distanceTolerance, "%s: meshlet %zu culled, but triangle %u faces the camera", name, m, t))
+					break;
+			}
+		}
+	}
+	Check(next == indices.size(), "%s: meshlets cover %u of %zu indices", name, next, indices.size());
+}
+
+// Meshlets for cases the models don't cover
+static void TestMeshletEdgeCases()
+{
+	std::vector<Vertex> vertices(3);
+	vertices[0].Position = XMFLOAT3(0, 0, 0);
+	vertices[1].Position = XMFLOAT3(0, 1, 0);
+	vertices[2].Position = XMFLOAT3(1, 0, 0);
+
+	unsigned int none = 0;
+	Check(BuildMeshlets(&vertices[0], vertices.size(), &none, 0).empty(), "meshlets: no triangles should give no meshlets");
+
+	std::vector<unsigned int> one = { 0, 1, 2 };
+	TestMeshlets("one triangle", vertices, one);
+
+	// Degenerate triangles still have to be covered, just not culled
+	std::vector<unsigned int> degenerate = { 0, 1, 2, 0, 0, 1, 2, 2, 2 };
+	TestMeshlets("degenerate triangles", vertices, degenerate);
+
+	// A flat grid with far more vertices than one meshlet holds
+	const unsigned int side = 40;
+	std::vector<Vertex> grid(side * side);
+	std::vector<unsigned int> gridIndices;
+	for (unsigned int y = 0; y < side; y++)
+		for (unsigned int x = 0; x < side; x++)
+			grid[y * side + x].Position = XMFLOAT3((float)x, (float)y, 0.0f);
+	for (unsigned int y = 0; y + 1 < side; y++)
+	{
+		for (unsigned int x = 0; x + 1 < side; x++)
+		{
+			unsigned int i = y * side + x;
+			unsigned int quad[6] = { i, i + side, i + 1, i + 1, i + side, i + side + 1 };
+			gridIndices.insert(gridIndices.end(), quad, quad + 6);
+		}
+	}
+	TestMeshlets("grid", grid, gridIndices);
+}
+
+// --------------------------------------------------------
+// Vertex cache and fetch order (MeshOptimizer)
+// - OptimizeVertexCache keeps every triangle and its winding,
+//    and never makes the simulated ACMR worse - from the file's
+//    own order, or from a shuffled one
+// - OptimizeVertexFetch numbers the vertices in the order the
+//    indices first use them, drops the ones nothing uses, and
+//    every corner still gets the same vertex it had
+// --------------------------------------------------------
+static void TestVertexCacheOrder(const char* name, const std::vector<unsigned int>& indices, size_t vertexCount)
+{
+	std::vector<unsigned int> optimized = indices;
+	OptimizeVertexCache(&optimized[0], optimized.size(), vertexCount);
+	Check(GetTriangleKeys(optimized) == GetTriangleKeys(indices), "%s: vertex cache order changed the triangles", name);
+
+	VertexCacheStats before = AnalyzeVertexCache(&indices[0], indices.size(), vertexCount);
+	VertexCacheStats after = AnalyzeVertexCache(&optimized[0], optimized.size(), vertexCount);
+	Check(after.acmr <= before.acmr, "%s: ACMR went from %.3f to %.3f", name, before.acmr, after.acmr);
+}
+
+static void TestVertexFetchOrder(const char* name, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices)
+{
+	// Unused vertices at the front, middle and end
+	std::vector<Vertex> padded;
+	std::vector<unsigned int> remap(vertices.size());
+	Vertex unused = {};
+	unused.Position = XMFLOAT3(1e6f, 1e6f, 1e6f);
+	padded.push_back(unused);
+	for (size_t v = 0; v < vertices.size(); v++)
+	{
+		if (v == vertices.size() / 2)
+			padded.push_back(unused);
+		remap[v] = (unsigned int)padded.size();
+		padded.push_back(vertices[v]);
+	}
+	padded.push_back(unused);
+
+	std::vector<unsigned int> paddedIndices(indices.size());
+	for (size_t i = 0; i < indices.size(); i++)
+		paddedIndices[i] = remap[indices[i]];
+
+	std::vector<Vertex> fetched = padded;
+	std::vector<unsigned int> fetchedIndices = paddedIndices;
+	size_t kept = OptimizeVertexFetch(&fetched[0], fetched.size(), sizeof(Vertex), &fetchedIndices[0], fetchedIndices.size());
+
+	std::vector<bool> used(padded.size(), false);
+	size_t usedCount = 0;
+	for (unsigned int index : paddedIndices)
+		if (!used[index])
+		{
+			used[index] = true;
+			usedCount++;
+		}
+	Check(kept == usedCount, "%s: vertex fetch kept %zu vertices, %zu are used", name, kept, usedCount);
+
+	unsigned int next = 0;
+	for (size_t i = 0; i < fetchedIndices.size(); i++)
+	{
+		unsigned int index = fetchedIndices[i];
+		if (!Check(index <= next && index < kept, "%s: index %zu is %u, but the next new vertex should be %u", name, i, index, next))
+			return;
+		if (index == next)
+			next++;
+		if (!Check(memcmp(&fetched[index], &padded[paddedIndices[i]], sizeof(Vertex)) == 0, "%s: corner %zu has a different vertex after fetch order", name, i))
+			return;
+	}
+}
+
+static void TestMeshOptimizer(const std::vector<ObjMeshData>& models)
+{
+	for (size_t m = 0; m < models.size(); m++)
+	{
+		const ObjMeshData& model = models[m];
+		if (model.vertices.empty())
+			continue;
+		const char* name = ModelNames[m];
+		TestVertexCacheOrder(name, model.indices, model.vertices.size());
+
+		// Triangles in a random order (each keeping its winding)
+		unsigned int seed = 11 + (unsigned int)m;
+		std::vector<unsigned int> shuffled = model.indices;
+		for (size_t t = shuffled.size() / 3; t > 1; t--)
+		{
+			size_t other = std::min((size_t)(NextRandom(seed) * t), t - 1);
+			for (int k = 0; k < 3; k++)
+				std::swap(shuffled[(t - 1) * 3 + k], shuffled[other * 3 + k]);
+		}
+		std::string shuffledName = std::string(name) + " (shuffled)";
+		TestVertexCacheOrder(shuffledName.c_str(), shuffled, model.vertices.size());
+
+		std::vector<unsigned int> optimized = model.indices;
+		OptimizeVertexCache(&optimized[0], optimized.size(), model.vertices.size());
+		TestVertexFetchOrder(name, model.vertices, optimized);
+		TestVertexFetchOrder(shuffledName.c_str(), model.vertices, shuffled);
+	}
+}
+
+// --------------------------------------------------------
+// LOD chains (MeshSimplifier)
+// - Level 0 is the original indices, untouched, and the levels
+//    follow it back to back to the end of the index buffer
+// - Every level is whole, non-degenerate triangles of existing
+//    vertices, with fewer triangles and no less error than the
+//    level before
+// - With several ranges, each level keeps them in order, their
+//    counts add up, they never grow, and a range only ever uses
+//    vertices its level 0 triangles used
+// - SimplifyMesh stops at maxError
+// --------------------------------------------------------
+static void TestLodChain(const char* name, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& original, bool simplifies = false)
+{
+	std::vector<unsigned int> indices = original;
+	std::vector<MeshLod> lods = BuildLodChain(&vertices[0], vertices.size(), indices);
+	if (!Check(!lods.empty() && lods[0].startIndex == 0 && lods[0].indexCount == original.size() && lods[0].error == 0.0f,
+		"%s: LOD 0 isn't the original index range", name))
+		return;
+	Check(std::equal(original.begin(), original.end(), indices.begin()), "%s: LOD 0's indices changed", name);
+	Check(!simplifies || lods.size() > 1, "%s: no simplified levels", name);
+
+	unsigned int end = 0;
+	for (size_t i = 0; i < lods.size(); i++)
+	{
+		const MeshLod& lod = lods[i];
+		bool ok = lod.startIndex == end && lod.indexCount % 3 == 0 && lod.indexCount > 0;
+		if (i > 0)
+			ok &= lod.indexCount < lods[i - 1].indexCount && lod.error >= lods[i - 1].error;
+		if (!Check(ok, "%s: LOD %zu (%u indices from %u, error %g) doesn't follow the level before", name, i, lod.indexCount, lod.startIndex, lod.error))
+			return;
+		end += lod.indexCount;
+
+		for (unsigned int t = lod.startIndex; t < end; t += 3)
+		{
+			const unsigned int* triangle = &indices[t];
+			bool valid = triangle[0] < vertices.size() && triangle[1] < vertices.size() && triangle[2] < vertices.size();
+			valid &= triangle[0] != triangle[1] && triangle[1] != triangle[2] && triangle[2] != triangle[0];
+			if (!Check(valid, "%s: LOD %zu has a bad triangle (%u %u %u)", name, i, triangle[0], triangle[1], triangle[2]))
+				return;
+		}
+	}
+	Check(end == indices.size(), "%s: LODs cover %u of %zu indices", name, end, indices.size());
+
+	// Two ranges - the first and second half of the triangles
+	std::vector<unsigned int> ranged = original;
+	unsigned int firstRange = (unsigned int)(original.size() / 6) * 3;
+	std::vector<unsigned int> rangeCounts = { firstRange, (unsigned int)original.size() - firstRange };
+	std::vector<unsigned int> levelRangeCounts;
+	std::vector<MeshLod> rangeLods = BuildLodChain(&vertices[0], vertices.size(), ranged, rangeCounts, levelRangeCounts);
+	if (!Check(levelRangeCounts.size() == rangeLods.size() * 2, "%s: %zu range counts for %zu levels", name, levelRangeCounts.size(), rangeLods.size()))
+		return;
+
+	std::vector<std::vector<bool>> rangeVertices(2, std::vector<bool>(vertices.size(), false));
+	for (size_t i = 0; i < rangeLods.size(); i++)
+	{
+		unsigned int start = rangeLods[i].startIndex;
+		for (int r = 0; r < 2; r++)
+		{
+			unsigned int count = levelRangeCounts[i * 2 + r];
+			bool ok = count % 3 == 0 && (i == 0 ? count == rangeCounts[r] : count <= levelRangeCounts[(i - 1) * 2 + r]);
+			for (unsigned int k = start; k < start + count && ok; k++)
+			{
+				if (i == 0)
+					rangeVertices[r][ranged[k]] = true;
+				ok &= rangeVertices[r][ranged[k]];
+			}
+			if (!Check(ok, "%s: range %d of LOD %zu (%u indices) grew or left its own vertices", name, r, i, count))
+				return;
+			start += count;
+		}
+		Check(start == rangeLods[i].startIndex + rangeLods[i].indexCount, "%s: LOD %zu's ranges don't add up to it", name, i);
+	}
+
+	// A tiny error budget stops well short of the target
+	std::vector<unsigned int> destination(original.size());
+	float reached = -1.0f;
+	size_t written = SimplifyMesh(&vertices[0], vertices.size(), &original[0], original.size(), 3, 1e-6f, &destination[0], &reached);
+	Check(written % 3 == 0 && written <= original.size() && reached >= 0.0f && reached <= 1e-6f,
+		"%s: simplifying with max error 1e-6 reached error %g (%zu indices)", name, reached, written);
+}
+
+// --------------------------------------------------------
+// OBJ faces (ObjParser)
+// - The v, v/vt, v//vn and v/vt/vn corner forms, polygons,
+//    negative indices and CRLF line ends all give the same
+//    triangles as plain v/vt/vn triangles
+// - Missing UVs come out as (0, 1), and missing normals are
+//    generated facing the same way as the file's would
+// - Generated normals split at creases sharper than the crease
+//    angle, and are smooth across the rest
+// - Triangles with out of range indices are dropped
+// - Any thread count gives exactly the same result
+// --------------------------------------------------------
+static bool ParseText(const std::string& text, ObjMeshData& mesh, unsigned int threadCount = 1, float creaseAngle = 60.0f)
+{
+	mesh = ObjMeshData();
+	return ParseObj(text.c_str(), text.size(), mesh, threadCount, 0, creaseAngle);
+}
+
+static bool SameMesh(const ObjMeshData& a, const ObjMeshData& b)
+{
+	return a.indices == b.indices && a.vertices.size() == b.vertices.size() &&
+		(a.vertices.empty() || memcmp(&a.vertices[0], &b.vertices[0], a.vertices.size() * sizeof(Vertex)) == 0);
+}
+
+static bool NearlyEqual(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	return fabsf(a.x - b.x) < 1e-5f && fabsf(a.y - b.y) < 1e-5f && fabsf(a.z - b.z) < 1e-5f;
+}
+
+// Same corners as the reference - UVs too, when "uvs" is set
+static void CheckCorners(const char* name, const ObjMeshData& mesh, const ObjMeshData& reference, bool uvs)
+{
+	if (!Check(mesh.indices.size() == reference.indices.size(), "%s: %zu indices, expected %zu", name, mesh.indices.size(), reference.indices.size()))
+		return;
+	for (size_t i = 0; i < mesh.indices.size(); i++)
+	{
+		const Vertex& v = mesh.vertices[mesh.indices[i]];
+		const Vertex& r = reference.vertices[reference.indices[i]];
+		bool ok = NearlyEqual(v.Position, r.Position) && NearlyEqual(v.Normal, r.Normal);
+		ok &= uvs ? (v.UV.x == r.UV.x && v.UV.y == r.UV.y) : (v.UV.x == 0.0f && v.UV.y == 1.0f);
+		if (!Check(ok, "%s: corner %zu doesn't match the v/vt/vn version", name, i))
+			return;
+	}
+}
+
+static void TestObjFaces()
+{
+	const std::string header =
+		"v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+		"vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+		"vn 0 0 1\n";
+	ObjMeshData reference, mesh;
+	Check(ParseText(header + "f 1/1/1 2/2/1 3/3/1\nf 1/1/1 3/3/1 4/4/1\n", reference) && reference.indices.size() == 6 && reference.vertices.size() == 4,
+		"faces: reference quad didn't parse to 2 triangles of 4 vertices");
+
+	Check(ParseText(header + "f 1/1/1 2/2/1 3/3/1 4/4/1\n", mesh) && SameMesh(mesh, reference), "faces: quad isn't the same as its two triangles");
+	Check(ParseText(header + "f -4/-4/-1 -3/-3/-1 -2/-2/-1 -1/-1/-1\n", mesh) && SameMesh(mesh, reference), "faces: negative indices aren't the same as positive ones");
+	Check(ParseText(header + "f 1/1/1 2/2/1 3/3/1\r\nf 1/1/1 3/3/1 4/4/1\r\n", mesh) && SameMesh(mesh, reference), "faces: CRLF line ends changed the mesh");
+
+	if (ParseText(header + "f 1//1 2//1 3//1 4//1\n", mesh))
+		CheckCorners("v//vn", mesh, reference, false);
+	else
+		Check(false, "faces: v//vn didn't parse");
+	if (ParseText(header + "f 1/1 2/2 3/3 4/4\n", mesh))
+		CheckCorners("v/vt", mesh, reference, true);
+	else
+		Check(false, "faces: v/vt didn't parse");
+	if (ParseText(header + "f 1 2 3 4\n", mesh))
+		CheckCorners("v", mesh, reference, false);
+	else
+		Check(false, "faces: v didn't parse");
+
+	// A pentagon fans into 3 triangles, all from its first corner
+	bool parsed = ParseText("v 0 0 0\nv 1 0 0\nv 2 1 0\nv 1 2 0\nv 0 1 0\nf 1 2 3 4 5\n", mesh);
+	Check(parsed && mesh.indices.size() == 9 &&
+		mesh.indices[0] == mesh.indices[3] && mesh.indices[3] == mesh.indices[6],
+		"faces: pentagon isn't a fan of 3 triangles (%zu indices)", mesh.indices.size());
+
+	// Out of range corners drop their triangle, and a file with
+	// nothing left has no mesh
+	parsed = ParseText(header + "f 1 2 3\nf 1 2 9\nf 1/9 2 3\nf 1//2 2//1 3//1\nf 0 1 2\nf -5 1 2\n", mesh);
+	Check(parsed && mesh.indices.size() == 3,
+		"faces: triangles with bad indices weren't dropped (%zu indices)", mesh.indices.size());
+	Check(!ParseText(header + "f 1 2 9\n", mesh), "faces: a file of bad triangles parsed");
+
+	// A cube with no normals: flat faces below the crease angle,
+	// one smooth normal per corner above it
+	const std::string cube =
+		"v -1 -1 -1\nv 1 -1 -1\nv 1 1 -1\nv -1 1 -1\nv -1 -1 1\nv 1 -1 1\nv 1 1 1\nv -1 1 1\n"
+		"f 1 4 3 2\nf 5 6 7 8\nf 1 2 6 5\nf 2 3 7 6\nf 3 4 8 7\nf 4 1 5 8\n";
+	parsed = ParseText(cube, mesh, 1, 60.0f);
+	if (Check(parsed && mesh.vertices.size() == 24, "cube: 60 degree crease gave %zu vertices, expected 24", mesh.vertices.size()))
+	{
+		for (size_t t = 0; t < mesh.indices.size(); t += 3)
+		{
+			XMFLOAT3 face;
+			FaceNormal(&mesh.vertices[0], &mesh.indices[t], face);
+			bool flat = true;
+			for (int k = 0; k < 3; k++)
+				flat &= Dot(mesh.vertices[mesh.indices[t + k]].Normal, face) > 0.999f;
+			if (!Check(flat, "cube: triangle %zu's generated normals aren't its face normal", t / 3))
+				break;
+		}
+	}
+	parsed = ParseText(cube, mesh, 1, 100.0f);
+	if (Check(parsed && mesh.vertices.size() == 8, "cube: 100 degree crease gave %zu vertices, expected 8", mesh.vertices.size()))
+	{
+		for (const Vertex& v : mesh.vertices)
+		{
+			float outward = Dot(v.Normal, v.Position) / sqrtf(Dot(v.Position, v.Position));
+			if (!Check(fabsf(Dot(v.Normal, v.Normal) - 1.0f) < 1e-4f && outward > 0.999f, "cube: smooth normal isn't the corner's diagonal"))
+				break;
+		}
+	}
+
+	// A grid big enough to be split between threads, with every
+	// other face written with negative indices
+	const int size = 200;
+	std::string positive, mixed;
+	char line[128];
+	for (int y = 0; y <= size; y++)
+		for (int x = 0; x <= size; x++)
+		{
+			snprintf(line, sizeof(line), "v %d %d %g\nvt %g %g\n", x, y, sinf(x * 0.1f) * cosf(y * 0.1f), x / (float)size, y / (float)size);
+			positive += line;
+		}
+	mixed = positive;
+	int total = (size + 1) * (size + 1);
+	for (int y = 0; y < size; y++)
+		for (int x = 0; x < size; x++)
+		{
+			int a = y * (size + 1) + x + 1, b = a + 1, c = a + size + 2, d = a + size + 1;
+			snprintf(line, sizeof(line), "f %d/%d %d/%d %d/%d %d/%d\n", a, a, b, b, c, c, d, d);
+			positive += line;
+			if ((x + y) % 2)
+				snprintf(line, sizeof(line), "f %d/%d %d/%d %d/%d %d/%d\n", a - total - 1, a - total - 1, b - total - 1, b - total - 1, c - total - 1, c - total - 1, d - total - 1, d - total - 1);
+			mixed += line;
+		}
+	ObjMeshData single;
+	Check(ParseText(positive, single, 1), "grid: didn't parse");
+	Check(single.indices.size() == (size_t)size * size * 6, "grid: %zu indices, expected %d", single.indices.size(), size * size * 6);
+	Check(ParseText(mixed, mesh, 1) && SameMesh(mesh, single), "grid: negative indices changed the mesh");
+	static const unsigned int threadCounts[] = { 2, 3, 8 };
+	for (unsigned int threads : threadCounts)
+		Check(ParseText(mixed, mesh, threads) && SameMesh(mesh, single), "grid: %u threads gave a different mesh", threads);
+
+	// The streaming reader resolves negative indices as it goes
+	const std::string streamed = "v 0 0 0\nv 1 0 0\nv 0 1 0\nf -3 -2 -1\n";
+	ObjStreamReader reader(streamed.c_str(), streamed.size());
+	float values[3];
+	std::vector<ObjVertexKey> triangles;
+	ObjRecord record;
+	while ((record = reader.Next(values, triangles)) != ObjRecord::End && record != ObjRecord::Face)
+		;
+	bool resolved = record == ObjRecord::Face && triangles.size() == 3;
+	if (resolved)
+	{
+		unsigned int seen = 0;
+		for (const ObjVertexKey& corner : triangles)
+			seen |= corner.position >= 1 && corner.position <= 3 ? 1u << corner.position : 0;
+		resolved = seen == 0xE;
+	}
+	Check(resolved, "stream: f -3 -2 -1 didn't resolve to vertices 1, 2 and 3");
+}
+
+// --------------------------------------------------------
+// OBJ materials (ObjParser)
+// - Each usemtl name gets one material and one submesh, in the
+//    order names first appear, holding all of its triangles;
+//    submeshes tile the index buffer and submesh i uses
+//    material i (also when split between threads)
+// - Faces before any usemtl, or files without one, use a
+//    material named ""
+// - .mtl files fill in the materials they name (and no others),
+//    with defaults for whatever they leave out
+// - mtllib files are found next to the OBJ file
+// --------------------------------------------------------
+static std::vector<TriangleKey> GetPositionKeys(const ObjMeshData& mesh, unsigned int submesh)
+{
+	// Triangles by position index, welded vertices aside
+	std::vector<unsigned int> positions;
+	const ObjSubmesh& range = mesh.submeshes[submesh];
+	for (unsigned int i = range.startIndex; i < range.startIndex + range.indexCount; i++)
+		positions.push_back((unsigned int)mesh.vertices[mesh.indices[i]].Position.x * 100 + (unsigned int)mesh.vertices[mesh.indices[i]].Position.y);
+	return GetTriangleKeys(positions);
+}
+
+static bool SubmeshesTile(const ObjMeshData& mesh)
+{
+	unsigned int end = 0;
+	for (size_t s = 0; s < mesh.submeshes.size(); s++)
+	{
+		if (mesh.submeshes[s].startIndex != end || mesh.submeshes[s].material != s)
+			return false;
+		end += mesh.submeshes[s].indexCount;
+	}
+	return end == mesh.indices.size() && mesh.materials.size() == mesh.submeshes.size();
+}
+
+static void TestObjMaterials()
+{
+	const std::string positions = "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n";
+	ObjMeshData mesh, expected;
+	bool parsed = ParseText("mtllib first.mtl\nmtllib second.mtl\n" + positions + "usemtl red\nf 1 2 3\nusemtl blue\nf 1 3 4\nusemtl red\nf 2 3 4\n", mesh);
+	if (Check(parsed && mesh.submeshes.size() == 2 && SubmeshesTile(mesh), "materials: red/blue/red didn't give 2 submeshes tiling the indices"))
+	{
+		Check(strcmp(mesh.materials[0].name, "red") == 0 && strcmp(mesh.materials[1].name, "blue") == 0, "materials: names aren't red, blue");
+		Check(mesh.submeshes[0].indexCount == 6 && mesh.submeshes[1].indexCount == 3, "materials: red has %u indices, blue %u", mesh.submeshes[0].indexCount, mesh.submeshes[1].indexCount);
+		Check(mesh.materialLibraries.size() == 2 && mesh.materialLibraries[0] == "first.mtl" && mesh.materialLibraries[1] == "second.mtl", "materials: mtllib names weren't kept");
+		Check(mesh.materials[0].diffuseColor.x == 1.0f && mesh.materials[0].opacity == 1.0f && mesh.materials[0].diffuseMap[0] == 0, "materials: unloaded material isn't the default");
+
+		ParseText(positions + "f 1 2 3\nf 2 3 4\n", expected);
+		Check(GetPositionKeys(mesh, 0) == GetPositionKeys(expected, 0), "materials: red doesn't have the first and third faces");
+	}
+
+	parsed = ParseText(positions + "f 1 2 3\nusemtl red\nf 1 3 4\n", mesh);
+	Check(parsed && mesh.submeshes.size() == 2 && SubmeshesTile(mesh) && mesh.materials[0].name[0] == 0 && strcmp(mesh.materials[1].name, "red") == 0,
+		"materials: faces before usemtl don't get a \"\" material first");
+	parsed = ParseText(positions + "f 1 2 3 4\n", mesh);
+	Check(parsed && mesh.submeshes.size() == 1 && SubmeshesTile(mesh) && mesh.materials[0].name[0] == 0, "materials: a file without usemtl isn't one submesh");
+
+	// Names longer than the field are cut short, the same way for
+	// usemtl and newmtl
+	std::string longName(100, 'm');
+	parsed = ParseText(positions + "usemtl " + longName + "\nf 1 2 3\n", mesh);
+	Check(parsed && strlen(mesh.materials[0].name) == sizeof(ObjMaterial::name) - 1, "materials: long name wasn't cut to fit");
+
+	// Many switches, split between threads - each face on its own
+	// cell of a grid
+	const int cells = 150;
+	std::string switching;
+	char line[64];
+	for (int y = 0; y <= cells; y++)
+		for (int x = 0; x <= cells; x++)
+		{
+			snprintf(line, sizeof(line), "v %d %d 0\n", x, y);
+			switching += line;
+		}
+	static const char* names[] = { "a", "b", "c" };
+	unsigned int seed = 3;
+	for (int i = 0; i < 20000; i++)
+	{
+		int a = (i % cells) + (i / cells) * (cells + 1) + 1;
+		snprintf(line, sizeof(line), "usemtl %s\nf %d %d %d\n", names[(int)(NextRandom(seed) * 3) % 3], a, a + 1, a + cells + 2);
+		switching += line;
+	}
+	ObjMeshData single;
+	ParseText(switching, single, 1);
+	Check(single.submeshes.size() == 3 && SubmeshesTile(single), "materials: switching file didn't give 3 submeshes");
+	static const unsigned int threadCounts[] = { 2, 4, 7 };
+	for (unsigned int threads : threadCounts)
+	{
+		parsed = ParseText(switching, mesh, threads);
+		bool same = parsed && SameMesh(mesh, single) && mesh.submeshes.size() == single.submeshes.size();
+		for (size_t s = 0; same && s < mesh.submeshes.size(); s++)
+			same = mesh.submeshes[s].indexCount == single.submeshes[s].indexCount && strcmp(mesh.materials[s].name, single.materials[s].name) == 0;
+		Check(same, "materials: %u threads gave different submeshes", threads);
+	}
+
+	// .mtl parsing
+	std::vector<ObjMaterial> materials(3);
+	InitObjMaterial(materials[0], "red");
+	InitObjMaterial(materials[1], "blue");
+	InitObjMaterial(materials[2], longName.c_str());
+	const std::string mtl =
+		"# comment\n"
+		"newmtl red\r\n"
+		"Kd 1 0 0\r\n"
+		"Ks 0.5 0.5 0.5\n"
+		"Ns 32\n"
+		"d 0.5\n"
+		"illum 2\n"
+		"map_Kd -s 1 1 1 textures/red.png\n"
+		"newmtl unused\n"
+		"Kd 0 1 0\n"
+		"newmtl blue\n"
+		"  Tr 0.25\n"
+		"newmtl " + longName + "\n"
+		"Ns 8\n";
+	ParseMtl(mtl.c_str(), mtl.size(), materials);
+	const ObjMaterial& red = materials[0];
+	Check(materials.size() == 3, "mtl: materials the mesh doesn't use were added");
+	Check(red.diffuseColor.x == 1.0f && red.diffuseColor.y == 0.0f && red.diffuseColor.z == 0.0f, "mtl: red's Kd is wrong");
+	Check(red.specularColor.x == 0.5f && red.specularPower == 32.0f && red.opacity == 0.5f, "mtl: red's Ks, Ns or d is wrong");
+	Check(strcmp(red.diffuseMap, "textures/red.png") == 0, "mtl: red's map_Kd is \"%s\"", red.diffuseMap);
+	Check(materials[1].opacity == 0.75f && materials[1].diffuseColor.y == 1.0f && materials[1].specularPower == 1.0f, "mtl: blue isn't Tr 0.25 with defaults");
+	Check(materials[2].specularPower == 8.0f, "mtl: long material name didn't match");
+
+	Check(GetObjRelativePath("models/a.obj", "b.mtl") == "models/b.mtl", "paths: relative to a / folder");
+	Check(GetObjRelativePath("models\\a.obj", "sub/b.mtl") == "models\\sub/b.mtl", "paths: relative to a \\ folder");
+	Check(GetObjRelativePath("a.obj", "b.mtl") == "b.mtl", "paths: relative to the working folder");
+	Check(GetObjRelativePath("models/a.obj", "C:\\b.mtl") == "C:\\b.mtl" && GetObjRelativePath("models/a.obj", "/b.mtl") == "/b.mtl", "paths: absolute paths changed");
+}
+
+// --------------------------------------------------------
+// Compact vertices (VertexCompression) - round trips through
+// CompressVertices and DecompressVertex stay within:
+// - Position: bounds extent / 65535 per axis (exact on flat axes)
+// - Normal:   0.001 radians
+// - UV:       half float rounding - half a step, 2^-11 of the
+//              value (2^-25 below the smallest normal half)
+// --------------------------------------------------------
+static const float MaxNormalError = 0.001f;
+
+static float HalfError(float value)
+{
+	return std::max(fabsf(value) * (1.0f / 2048.0f), 1.0f / 33554432.0f);
+}
+
+static float AngleBetween(XMFLOAT3 a, XMFLOAT3 b)
+{
+	float cosine = Dot(a, b) / sqrtf(Dot(a, a) * Dot(b, b));
+	return acosf(std::max(-1.0f, std::min(1.0f, cosine)));
+}
+
+static void TestCompactRoundTrip(const char* name, const std::vector<Vertex>& vertices, XMFLOAT3 boundsMin, XMFLOAT3 boundsMax)
+{
+	std::vector<CompactVertex> compact(vertices.size());
+	CompressVertices(&vertices[0], vertices.size(), boundsMin, boundsMax, &compact[0]);
+
+	const float* lows = &boundsMin.x;
+	const float* highs = &boundsMax.x;
+	float positionTolerance[3];
+	for (int axis = 0; axis < 3; axis++)
+	{
+		// Plus float rounding in boundsMin + t * extent
+		float extent = highs[axis] - lows[axis];
+		float magnitude = std::max(fabsf(lows[axis]), fabsf(highs[axis]));
+		positionTolerance[axis] = extent > 0.0f ? extent / 65535.0f + magnitude * 2.0f * FLT_EPSILON : 0.0f;
+	}
+
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		const Vertex& original = vertices[i];
+		Vertex decoded = DecompressVertex(compact[i], boundsMin, boundsMax);
+
+		const float* p = &original.Position.x;
+		const float* q = &decoded.Position.x;
+		bool positionOk = true;
+		for (int axis = 0; axis < 3; axis++)
+			positionOk &= fabsf(p[axis] - q[axis]) <= positionTolerance[axis];
+		if (!Check(positionOk, "%s: vertex %zu position (%g, %g, %g) came back as (%g, %g, %g)", name, i, p[0], p[1], p[2], q[0], q[1], q[2]))
+			return;
+
+		float angle = AngleBetween(original.Normal, decoded.Normal);
+		if (!Check(angle <= MaxNormalError, "%s: vertex %zu normal (%g, %g, %g) is off by %g radians", name, i,
+			original.Normal.x, original.Normal.y, original.Normal.z, angle))
+			return;
+
+		bool uvOk =
+			fabsf(original.UV.x - decoded.UV.x) <= HalfError(original.UV.x) &&
+			fabsf(original.UV.y - decoded.UV.y) <= HalfError(original.UV.y);
+		if (!Check(uvOk, "%s: vertex %zu uv (%g, %g) came back as (%g, %g)", name, i, original.UV.x, original.UV.y, decoded.UV.x, decoded.UV.y))
+			return;
+	}
+}
+
+static void TestVertexCompression(const std::vector<ObjMeshData>& models)
+{
+	for (size_t i = 0; i < models.size(); i++)
+	{
+		if (models[i].vertices.empty())
+			continue;
+		XMFLOAT3 boundsMin, boundsMax;
+		ComputeBounds(&models[i].vertices[0], models[i].vertices.size(), boundsMin, boundsMax);
+		TestCompactRoundTrip(ModelNames[i], models[i].vertices, boundsMin, boundsMax);
+	}
+
+	// Flat on every axis (one point), then flat on one axis only
+	std::vector<Vertex> point(3);
+	for (Vertex& v : point)
+	{
+		v.Position = XMFLOAT3(1.5f, -2.25f, 1000.0f);
+		v.Normal = XMFLOAT3(0, 1, 0);
+		v.UV = XMFLOAT2(0.5f, 0.5f);
+	}
+	TestCompactRoundTrip("zero extent", point, point[0].Position, point[0].Position);
+	point[1].Position.x = 3.0f;
+	point[2].Position.z = 999.0f;
+	XMFLOAT3 boundsMin, boundsMax;
+	ComputeBounds(&point[0], point.size(), boundsMin, boundsMax);
+	Check(boundsMin.y == boundsMax.y, "zero extent: bounds should be flat in y");
+	TestCompactRoundTrip("flat y", point, boundsMin, boundsMax);
+
+	// Normals: the axes (the octahedron's corners, including +-1
+	// on z where the lower half folds), points on the fold's
+	// edges and diagonals, and random directions on both halves
+	std::vector<XMFLOAT3> normals = {
+		XMFLOAT3(1, 0, 0), XMFLOAT3(-1, 0, 0), XMFLOAT3(0, 1, 0), XMFLOAT3(0, -1, 0), XMFLOAT3(0, 0, 1), XMFLOAT3(0, 0, -1),
+		XMFLOAT3(1, 0, -1), XMFLOAT3(-1, 0, -1), XMFLOAT3(0, 1, -1), XMFLOAT3(0, -1, -1),
+		XMFLOAT3(1, 1, -1e-6f), XMFLOAT3(-1, 1, -1e-6f), XMFLOAT3(1, -1, -1e-6f), XMFLOAT3(-1, -1, -1e-6f),
+		XMFLOAT3(1, 1, 0), XMFLOAT3(-1, -1, 0), XMFLOAT3(1, 1, 1), XMFLOAT3(-1, -1, -1),
+		XMFLOAT3(1e-6f, 0, -1), XMFLOAT3(-1e-6f, 1e-6f, -1), XMFLOAT3(0, 0, -1e-6f),
+	};
+	unsigned int seed = 3;
+	while (normals.size() < 100000)
+	{
+		XMFLOAT3 n(NextRandom(seed) * 2 - 1, NextRandom(seed) * 2 - 1, NextRandom(seed) * 2 - 1);
+		if (Dot(n, n) > 1e-6f && Dot(n, n) <= 1.0f)
+			normals.push_back(n);
+	}
+	std::vector<Vertex> directions(normals.size());
+	for (size_t i = 0; i < normals.size(); i++)
+	{
+		float length = sqrtf(Dot(normals[i], normals[i]));
+		directions[i].Position = XMFLOAT3(0, 0, 0);
+		directions[i].Normal = XMFLOAT3(normals[i].x / length, normals[i].y / length, normals[i].z / length);
+		directions[i].UV = XMFLOAT2(0, 0);
+	}
+	TestCompactRoundTrip("normals", directions, XMFLOAT3(0, 0, 0), XMFLOAT3(0, 0, 0));
+
+	// UVs outside [0, 1] (tiling, negative offsets), tiny ones
+	// down in the half denormals, and the largest finite half
+	float uvs[] = { 0.0f, 1.0f, -0.0001f, -1.25f, 2.5f, -3.7f, 10.3f, -7.9f, 12.25f, 100.01f, 1000.5f, 1e-5f, -3e-7f, 65504.0f, -65504.0f };
+	std::vector<Vertex> tiled;
+	for (float u : uvs)
+	{
+		for (float v : uvs)
+		{
+			Vertex vertex = {};
+			vertex.Normal = XMFLOAT3(0, 0, 1);
+			vertex.UV = XMFLOAT2(u, v);
+			tiled.push_back(vertex);
+		}
+	}
+	TestCompactRoundTrip("uvs", tiled, XMFLOAT3(0, 0, 0), XMFLOAT3(0, 0, 0));
+
+	// Every half (but NaNs) converts to a float and back exactly
+	for (unsigned int bits = 0; bits < 0x10000; bits++)
+	{
+		if ((bits & 0x7C00) == 0x7C00 && (bits & 0x3FF) != 0)
+			continue;
+		unsigned short back = FloatToHalf(HalfToFloat((unsigned short)bits));
+		if (!Check(back == bits, "half 0x%04X came back as 0x%04X", bits, back))
+			break;
+	}
+}
+
+// --------------------------------------------------------
+// Mesh stream compression (MeshCodec) - streams decode to the
+// exact bytes they were encoded from, with both the plain C++
+// and the SSE2 decoder, and short or broken input is rejected
+// --------------------------------------------------------
+static const size_t GuardBytes = 64;
+
+// Encodes then decodes the first "count" elements, with each decoder
+static void TestStreamRoundTrip(const char* name, const void* elements, size_t count, size_t stride)
+{
+	std::vector<unsigned char> encoded;
+	EncodeMeshStream(elements, count, stride, encoded);
+	const unsigned char* data = encoded.empty() ? 0 : &encoded[0];
+
+	for (int simd = 0; simd < 2; simd++)
+	{
+		SetMeshCodecSimdEnabled(simd != 0);
+		if (simd && !IsMeshCodecSimdEnabled())
+			continue;
+		const char* decoder = simd ? "SSE2" : "scalar";
+
+		// Guard bytes past the end catch writes beyond count elements
+		std::vector<unsigned char> decoded(count * stride + GuardBytes, 0xCD);
+		bool ok = DecodeMeshStream(&decoded[0], count, stride, data, encoded.size());
+		if (!Check(ok, "%s: %zu x %zu bytes didn't decode (%s)", name, count, stride, decoder))
+			continue;
+		Check(count == 0 || memcmp(&decoded[0], elements, count * stride) == 0,
+			"%s: %zu x %zu bytes decoded differently (%s)", name, count, stride, decoder);
+		bool guardsIntact = true;
+		for (size_t i = count * stride; i < decoded.size(); i++)
+			guardsIntact &= decoded[i] == 0xCD;
+		Check(guardsIntact, "%s: %zu x %zu bytes wrote past the end (%s)", name, count, stride, decoder);
+
+		// Every byte is needed, so any truncation has to fail -
+		// all of them for small streams, a sample for big ones
+		for (size_t size = encoded.size(); size-- > 0;)
+		{
+			if (encoded.size() > 4096 && size + 64 < encoded.size() && size % 997 != 0)
+				continue;
+			if (!Check(!DecodeMeshStream(&decoded[0], count, stride, data, size),
+				"%s: %zu x %zu bytes decoded from %zu of %zu encoded bytes (%s)", name, count, stride, size, encoded.size(), decoder))
+				break;
+		}
+	}
+	SetMeshCodecSimdEnabled(true);
+}
+
+// The whole stream, plus prefixes that end part way into a block
+static void TestStream(const char* name, const void* elements, size_t count, size_t stride)
+{
+	static const size_t prefixes[] = { 0, 1, 2, 15, 16, 17, 31, 33, 100 };
+	for (size_t prefix : prefixes)
+		if (prefix < count)
+			TestStreamRoundTrip(name, elements, prefix, stride);
+	TestStreamRoundTrip(name, elements, count, stride);
+}
+
+static void TestIndexStream(const char* name, const std::vector<unsigned int>& indices)
+{
+	std::vector<unsigned char> encoded;
+	EncodeIndexStream(indices.empty() ? 0 : &indices[0], indices.size(), encoded);
+
+	for (int simd = 0; simd < 2; simd++)
+	{
+		SetMeshCodecSimdEnabled(simd != 0);
+		if (simd && !IsMeshCodecSimdEnabled())
+			continue;
+
+		std::vector<unsigned int> decoded(indices.size() + 1, 0xCDCDCDCD);
+		bool ok = DecodeIndexStream(&decoded[0], indices.size(), &encoded[0], encoded.size());
+		Check(ok && std::equal(indices.begin(), indices.end(), decoded.begin()) && decoded.back() == 0xCDCDCDCD,
+			"%s: index stream of %zu didn't come back (%s)", name, indices.size(), simd ? "SSE2" : "scalar");
+		Check(!DecodeIndexStream(&decoded[0], indices.size(), &encoded[0], encoded.size() - 1) || indices.empty(),
+			"%s: truncated index stream of %zu decoded", name, indices.size());
+	}
+	SetMeshCodecSimdEnabled(true);
+}
+
+static void TestMeshCodec(const std::vector<ObjMeshData>& models)
+{
+	for (size_t m = 0; m < models.size(); m++)
+	{
+		const ObjMeshData& model = models[m];
+		if (model.vertices.empty())
+			continue;
+		const char* name = ModelNames[m];
+		size_t count = model.vertices.size();
+
+		// The vertex layouts the cache stores, and bare positions
+		std::vector<XMFLOAT3> positions(count);
+		for (size_t i = 0; i < count; i++)
+			positions[i] = model.vertices[i].Position;
+
+		XMFLOAT3 boundsMin, boundsMax;
+		ComputeBounds(&model.vertices[0], count, boundsMin, boundsMax);
+		std::vector<CompactVertex> compact(count);
+		CompressVertices(&model.vertices[0], count, boundsMin, boundsMax, &compact[0]);
+
+		std::vector<Vertex> splitVertices = model.vertices;
+		std::vector<unsigned int> splitIndices = model.indices;
+		std::vector<XMFLOAT4> tangents;
+		GenerateTangents(splitVertices, splitIndices, splitIndices.size(), tangents, 1);
+		std::vector<TangentVertex> tangentVertices(splitVertices.size());
+		for (size_t i = 0; i < splitVertices.size(); i++)
+		{
+			tangentVertices[i].Position = splitVertices[i].Position;
+			tangentVertices[i].Normal = splitVertices[i].Normal;
+			tangentVertices[i].UV = splitVertices[i].UV;
+			tangentVertices[i].Tangent = tangents[i];
+		}
+
+		std::vector<unsigned short> shortIndices(model.indices.begin(), model.indices.end());
+		TestStream(name, &shortIndices[0], shortIndices.size(), 2);
+		TestStream(name, &model.indices[0], model.indices.size(), 4);
+		TestStream(name, &positions[0], count, sizeof(XMFLOAT3));
+		TestStream(name, &compact[0], count, sizeof(CompactVertex));
+		TestStream(name, &model.vertices[0], count, sizeof(Vertex));
+		TestStream(name, &tangentVertices[0], tangentVertices.size(), sizeof(TangentVertex));
+		TestIndexStream(name, model.indices);
+	}
+
+	// Random bytes (every plane needs all 8 bits), odd strides
+	// and the largest one
+	unsigned int seed = 5;
+	std::vector<unsigned char> noise(256 * 70);
+	for (unsigned char& byte : noise)
+		byte = (unsigned char)(NextRandom(seed) * 256);
+	static const size_t strides[] = { 1, 3, 5, 7, 17, 33, 64, 255, 256 };
+	for (size_t stride : strides)
+		TestStream("noise", &noise[0], noise.size() / stride, stride);
+
+	// Indices too big for 16 bits take the 32-bit path
+	std::vector<unsigned int> wide = { 0, 70000, 1, 65535, 65536, 0xFFFFFFFF, 3, 2, 1 };
+	TestIndexStream("wide indices", wide);
+	TestIndexStream("no indices", std::vector<unsigned int>());
+
+	// Malformed input
+	unsigned char buffer[256 * 16];
+	unsigned char zeros[64] = {};
+	std::vector<unsigned char> encoded;
+	EncodeMeshStream(zeros, 16, 4, encoded);
+	Check(encoded.size() == 1, "codec: 16 zero elements should be just a header, not %zu bytes", encoded.size());
+	Check(!DecodeMeshStream(buffer, 16, 0, &encoded[0], encoded.size()), "codec: stride 0 decoded");
+	Check(!DecodeMeshStream(buffer, 16, 257, &encoded[0], encoded.size()), "codec: stride 257 decoded");
+	encoded[0] = 0xFF;	// Every plane 8 bits - 64 payload bytes that aren't there
+	Check(!DecodeMeshStream(buffer, 16, 4, &encoded[0], encoded.size()), "codec: header asking for missing payload decoded");
+	Check(DecodeMeshStream(buffer, 0, 4, 0, 0), "codec: zero elements from no data should decode");
+
+	unsigned int indices[4];
+	unsigned char badWidth[] = { 3, 0 };
+	Check(!DecodeIndexStream(indices, 4, badWidth, sizeof(badWidth)), "codec: index stream with width 3 decoded");
+	Check(!DecodeIndexStream(indices, 4, badWidth, 0), "codec: empty index stream decoded");
+}
+
+// --------------------------------------------------------
+// Tangent frames (TangentGenerator)
+// - Every corner keeps its position, normal and UV (splitting
+//    only appends copies and remaps indices)
+// - Every vertex's w is the handedness of each triangle with
+//    UV area around it - vertices on mirror seams were split
+// - Tangents are unit length and perpendicular to the normal
+// --------------------------------------------------------
+static float Handedness(const std::vector<Vertex>& vertices, const unsigned int* triangle)
+{
+	const Vertex& v0 = vertices[triangle[0]];
+	const Vertex& v1 = vertices[triangle[1]];
+	const Vertex& v2 = vertices[triangle[2]];
+	XMFLOAT3 e1 = Subtract(v1.Position, v0.Position);
+	XMFLOAT3 e2 = Subtract(v2.Position, v0.Position);
+	XMFLOAT3 cross(e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x);
+	XMFLOAT3 normals(v0.Normal.x + v1.Normal.x + v2.Normal.x, v0.Normal.y + v1.Normal.y + v2.Normal.y, v0.Normal.z + v1.Normal.z + v2.Normal.z);
+	float area = (v1.UV.x - v0.UV.x) * (v2.UV.y - v0.UV.y) - (v2.UV.x - v0.UV.x) * (v1.UV.y - v0.UV.y);
+	if (fabsf(area) <= 1e-12f)
+		return 0.0f;
+	float facing = Dot(normals, cross) * area;
+	return facing > 0.0f ? 1.0f : facing < 0.0f ? -1.0f : 0.0f;
+}
+
+static void TestTangentFrames(const char* name, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, size_t expectedSplits)
+{
+	std::vector<Vertex> split = vertices;
+	std::vector<unsigned int> splitIndices = indices;
+	std::vector<XMFLOAT4> tangents;
+	GenerateTangents(split, splitIndices, splitIndices.size(), tangents, 2);
+
+	if (!Check(tangents.size() == split.size() && splitIndices.size() == indices.size(), "%s: tangent output sizes don't match", name))
+		return;
+	if (expectedSplits != (size_t)-1)
+		Check(split.size() == vertices.size() + expectedSplits, "%s: %zu vertices split, expected %zu", name, split.size() - vertices.size(), expectedSplits);
+
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		const Vertex& before = vertices[indices[i]];
+		const Vertex& after = split[splitIndices[i]];
+		if (!Check(memcmp(&before, &after, sizeof(Vertex)) == 0, "%s: corner %zu changed when its vertex was split", name, i))
+			return;
+	}
+
+	for (size_t t = 0; t < splitIndices.size() / 3; t++)
+	{
+		float sign = Handedness(split, &splitIndices[t * 3]);
+		if (sign == 0.0f)
+			continue;
+		for (int k = 0; k < 3; k++)
+		{
+			unsigned int v = splitIndices[t * 3 + k];
+			if (!Check(tangents[v].w == sign, "%s: vertex %u has w %g, but triangle %zu's handedness is %g", name, v, tangents[v].w, t, sign))
+				return;
+		}
+	}
+
+	for (size_t v = 0; v < split.size(); v++)
+	{
+		XMFLOAT3 tangent(tangents[v].x, tangents[v].y, tangents[v].z);
+		XMFLOAT3 normal = split[v].Normal;
+		float normalLength = sqrtf(Dot(normal, normal));
+		bool ok = fabsf(Dot(tangent, tangent) - 1.0f) < 1e-3f && (tangents[v].w == 1.0f || tangents[v].w == -1.0f);
+		ok &= normalLength <= 0.0f || fabsf(Dot(tangent, normal)) < 1e-3f * normalLength;
+		if (!Check(ok, "%s: vertex %zu has a bad tangent frame", name, v))
+			return;
+	}
+}
+
+static void TestTangents(const std::vector<ObjMeshData>& models)
+{
+	for (size_t m = 0; m < models.size(); m++)
+		if (!models[m].vertices.empty())
+			TestTangentFrames(ModelNames[m], models[m].vertices, models[m].indices, (size_t)-1);
+
+	// A quad whose second triangle has its UVs mirrored across the
+	// shared edge - both shared vertices get split
+	std::vector<Vertex> quad(4);
+	XMFLOAT3 positions[4] = { XMFLOAT3(0, 0, 0), XMFLOAT3(1, 0, 0), XMFLOAT3(1, 1, 0), XMFLOAT3(0, 1, 0) };
+	XMFLOAT2 uvs[4] = { XMFLOAT2(0, 0), XMFLOAT2(1, 0), XMFLOAT2(1, 1), XMFLOAT2(1, 0) };
+	for (int i = 0; i < 4; i++)
+	{
+		quad[i].Position = positions[i];
+		quad[i].Normal = XMFLOAT3(0, 0, -1);
+		quad[i].UV = uvs[i];
+	}
+	std::vector<unsigned int> quadIndices = { 0, 2, 1, 0, 3, 2 };
+	Check(Handedness(quad, &quadIndices[0]) == -Handedness(quad, &quadIndices[3]), "mirrored quad: test triangles aren't mirrored");
+	TestTangentFrames("mirrored quad", quad, quadIndices, 2);
+
+	// Unmirrored, nothing is split
+	quad[3].UV = XMFLOAT2(0, 1);
+	TestTangentFrames("quad", quad, quadIndices, 0);
+
+	// Only the leading indices make frames, but every index is
+	// remapped - a triangle past them (a simplified level) that's
+	// mirrored against LOD 0 still gets its own copies
+	std::vector<Vertex> lodVertices = quad;
+	std::vector<unsigned int> lodIndices = quadIndices;
+	lodVertices[3].UV = XMFLOAT2(1, 0);
+	std::vector<XMFLOAT4> lodTangents;
+	GenerateTangents(lodVertices, lodIndices, 3, lodTangents, 1);
+	Check(lodVertices.size() == 6 && lodIndices[0] == 0 && lodIndices[1] == 2 && lodIndices[2] == 1,
+		"lod: LOD 0 should keep its vertices, and the other triangle get 2 copies (%zu vertices)", lodVertices.size());
+	Check(lodTangents[lodIndices[3]].w == -lodTangents[0].w, "lod: mirrored triangle past LOD 0 took LOD 0's sign");
+}
+
+// --------------------------------------------------------
+// Range allocation (RangeAllocator) - random allocations,
+// frees and defragments, checked against a plain map of the
+// live ranges:
+// - Ranges fit in the space and never overlap
+// - Allocations take the start of the smallest free range that
+//    fits, and only fail when no free range is big enough
+// - Free size, largest free range and allocation count match
+//    (the largest range is only right if freed neighbours merge)
+// - Defragment moves ranges down, lowest first, to packed offsets
+// --------------------------------------------------------
+
+// Free ranges between the live ones (offset -> size), merged
+static std::map<unsigned int, unsigned int> GetFreeRanges(const std::map<unsigned int, unsigned int>& live, unsigned int capacity)
+{
+	std::map<unsigned int, unsigned int> free;
+	unsigned int end = 0;
+	for (auto it = live.begin(); it != live.end(); ++it)
+	{
+		if (it->first > end)
+			free[end] = it->first - end;
+		end = it->first + it->second;
+	}
+	if (end < capacity)
+		free[end] = capacity - end;
+	return free;
+}
+
+static void TestRangeAllocator(unsigned int capacity, unsigned int maxSize, unsigned int seed)
+{
+	RangeAllocator allocator(capacity);
+	std::map<unsigned int, unsigned int> live;
+	unsigned int used = 0;
+
+	for (int step = 0; step < 20000; step++)
+	{
+		float action = NextRandom(seed);
+		if (action < 0.6f)
+		{
+			unsigned int size = 1 + (unsigned int)(NextRandom(seed) * maxSize);
+			std::map<unsigned int, unsigned int> free = GetFreeRanges(live, capacity);
+			unsigned int bestSize = 0;
+			for (auto it = free.begin(); it != free.end(); ++it)
+				if (it->second >= size && (bestSize == 0 || it->second < bestSize))
+					bestSize = it->second;
+
+			unsigned int offset = allocator.Allocate(size);
+			if (offset == RangeAllocator::InvalidOffset)
+			{
+				if (!Check(bestSize == 0, "ranges %u: allocating %u failed with a free range of %u", capacity, size, bestSize))
+					return;
+				continue;
+			}
+			auto range = free.find(offset);
+			if (!Check(range != free.end() && range->second == bestSize,
+				"ranges %u: allocating %u took offset %u, not the start of the smallest free range that fits (%u)", capacity, size, offset, bestSize))
+				return;
+			live[offset] = size;
+			used += size;
+		}
+		else if (action < 0.97f)
+		{
+			if (live.empty())
+				continue;
+
+			// Offsets that aren't the start of a range can't be freed
+			auto it = live.begin();
+			std::advance(it, (size_t)(NextRandom(seed) * live.size()) % live.size());
+			if (it->second > 1)
+				Check(!allocator.Free(it->first + 1), "ranges %u: freed offset %u, inside a range", capacity, it->first + 1);
+			if (!Check(allocator.Free(it->first), "ranges %u: couldn't free offset %u", capacity, it->first))
+				return;
+			used -= it->second;
+			live.erase(it);
+		}
+		else
+		{
+			std::vector<RangeAllocator::Move> moves = allocator.Defragment();
+			std::map<unsigned int, unsigned int> packed;
+			unsigned int end = 0;
+			size_t move = 0;
+			bool ok = true;
+			for (auto it = live.begin(); it != live.end(); ++it)
+			{
+				if (it->first != end)
+				{
+					ok &= move < moves.size() && moves[move].from == it->first && moves[move].to == end && moves[move].size == it->second;
+					move++;
+				}
+				packed[end] = it->second;
+				end += it->second;
+			}
+			if (!Check(ok && move == moves.size(), "ranges %u: defragment moved the wrong ranges, or out of order", capacity))
+				return;
+			live.swap(packed);
+		}
+
+		std::map<unsigned int, unsigned int> free = GetFreeRanges(live, capacity);
+		unsigned int largest = 0;
+		for (auto it = free.begin(); it != free.end(); ++it)
+			largest = std::max(largest, it->second);
+		bool ok = allocator.GetFreeSize() == capacity - used;
+		ok &= allocator.GetLargestFreeRange() == largest;
+		ok &= allocator.GetAllocationCount() == live.size();
+		if (!Check(ok, "ranges %u: step %d has free size %u (want %u), largest %u (want %u), %u allocations (want %zu)", capacity, step,
+			allocator.GetFreeSize(), capacity - used, allocator.GetLargestFreeRange(), largest, allocator.GetAllocationCount(), live.size()))
+			return;
+	}
+
+	// Freeing everything leaves one range the size of the space
+	for (auto it = live.begin(); it != live.end(); ++it)
+		allocator.Free(it->first);
+	Check(allocator.GetLargestFreeRange() == capacity && allocator.GetAllocationCount() == 0, "ranges %u: freeing everything didn't merge back into one range", capacity);
+}
+
+static void TestRangeAllocators()
+{
+	TestRangeAllocator(4096, 64, 1);
+	TestRangeAllocator(4096, 1024, 2);
+	TestRangeAllocator(100, 7, 3);
+
+	RangeAllocator empty(0);
+	Check(empty.Allocate(1) == RangeAllocator::InvalidOffset && empty.GetLargestFreeRange() == 0, "ranges 0: allocated from an empty space");
+	RangeAllocator one(16);
+	Check(one.Allocate(0) == RangeAllocator::InvalidOffset, "ranges 16: allocated 0");
+	Check(one.Allocate(16) == 0 && one.Allocate(1) == RangeAllocator::InvalidOffset, "ranges 16: allocating the whole space");
+}
+
+// --------------------------------------------------------
+// Transform hierarchies (TransformSystem) - after random edits,
+// every world matrix matches one built recursively from the
+// transform's own position, rotation and scale and its
+// parent's world matrix
+// - Frames that only move transforms (no SetParent) are what
+//    make UpdateWorlds() rely on spotting changed parents
+// - With and without AVX2, on one thread and split up (the
+//    wide hierarchy has levels big enough to be shared out)
+// --------------------------------------------------------
+static XMMATRIX ReferenceWorld(TransformSystem& transforms, TransformHandle handle, std::vector<XMFLOAT4X4>& worlds, std::vector<bool>& known)
+{
+	if (known[handle])
+		return XMLoadFloat4x4(&worlds[handle]);
+
+	XMFLOAT3 position = transforms.GetPosition(handle);
+	XMFLOAT4 rotation = transforms.GetRotation(handle);
+	XMFLOAT3 scale = transforms.GetScale(handle);
+	XMMATRIX world =
+		XMMatrixScaling(scale.x, scale.y, scale.z) *
+		XMMatrixRotationQuaternion(XMLoadFloat4(&rotation)) *
+		XMMatrixTranslation(position.x, position.y, position.z);
+	TransformHandle parent = transforms.GetParent(handle);
+	if (parent != NoTransform)
+		world = world * ReferenceWorld(transforms, parent, worlds, known);
+
+	XMStoreFloat4x4(&worlds[handle], world);
+	known[handle] = true;
+	return world;
+}
+
+// Largest difference between any world matrix and the reference,
+// relative to the reference's size
+static float CompareWorlds(TransformSystem& transforms, const std::vector<bool>& alive)
+{
+	std::vector<XMFLOAT4X4> worlds(transforms.GetCapacity());
+	std::vector<bool> known(worlds.size(), false);
+	float worst = 0.0f;
+	for (size_t h = 0; h < worlds.size(); h++)
+	{
+		if (!alive[h])
+			continue;
+		XMFLOAT4X4 expected;
+		XMStoreFloat4x4(&expected, XMMatrixTranspose(ReferenceWorld(transforms, (TransformHandle)h, worlds, known)));
+		const float* a = &expected._11;
+		const float* b = &transforms.GetWorld((TransformHandle)h)._11;
+		for (int k = 0; k < 16; k++)
+			worst = std::max(worst, fabsf(a[k] - b[k]) / (1.0f + fabsf(a[k])));
+	}
+	return worst;
+}
+
+static XMFLOAT3 RandomFloat3(unsigned int& seed, float base, float range)
+{
+	return XMFLOAT3(base + (NextRandom(seed) * 2 - 1) * range, base + (NextRandom(seed) * 2 - 1) * range, base + (NextRandom(seed) * 2 - 1) * range);
+}
+
+static XMFLOAT4 RandomRotation(unsigned int& seed)
+{
+	return XMFLOAT4(NextRandom(seed) * 2 - 1, NextRandom(seed) * 2 - 1, NextRandom(seed) * 2 - 1, NextRandom(seed) * 2 - 1 + 0.01f);
+}
+
+static void TestTransformHierarchy(const char* name, unsigned int count, unsigned int fanOut, bool simd, unsigned int threadCount, unsigned int seed)
+{
+	TransformSystem transforms;
+	transforms.SetSimdEnabled(simd);
+	transforms.SetThreadCount(threadCount);
+
+	// Each transform's parent is one of the "fanOut" before it, or
+	// (sometimes) any earlier one - 0 means a single deep chain
+	std::vector<TransformHandle> handles;
+	std::vector<bool> alive;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		TransformHandle handle = transforms.Create();
+		handles.push_back(handle);
+		alive.push_back(true);
+		transforms.SetPosition(handle, RandomFloat3(seed, 0.0f, 1.0f));
+		transforms.SetRotation(handle, RandomRotation(seed));
+		transforms.SetScale(handle, RandomFloat3(seed, 1.0f, 0.1f));
+		if (i == 0)
+			continue;
+		TransformHandle parent = fanOut == 0 ? i - 1 : NextRandom(seed) < 0.9f ? (i - 1) / fanOut : (unsigned int)(NextRandom(seed) * i) % i;
+		Check(transforms.SetParent(handle, parent), "%s: couldn't parent %u under %u", name, handle, parent);
+	}
+	Check(count < 2 || !transforms.SetParent(handles[0], handles[count - 1]), "%s: made a loop", name);
+
+	for (int frame = 0; frame < 8; frame++)
+	{
+		// Even frames only move, turn and scale things - odd ones
+		// also reparent, destroy and create
+		unsigned int edits = frame == 0 ? 1 : count / 100 + 1;
+		for (unsigned int e = 0; e < edits; e++)
+		{
+			TransformHandle handle = (TransformHandle)(NextRandom(seed) * count) % count;
+			if (frame == 0)
+				handle = 0;
+			if (!alive[handle])
+				continue;
+			float action = NextRandom(seed);
+			if (action < 0.3f)
+				transforms.SetPosition(handle, RandomFloat3(seed, 0.0f, 1.0f));
+			else if (action < 0.5f)
+				transforms.SetRotation(handle, RandomRotation(seed));
+			else if (action < 0.6f)
+				transforms.Rotate(handle, RandomRotation(seed));
+			else if (action < 0.7f || frame % 2 == 0)
+				transforms.SetScale(handle, RandomFloat3(seed, 1.0f, 0.1f));
+			else if (action < 0.9f)
+				transforms.SetParent(handle, NextRandom(seed) < 0.2f ? NoTransform : (TransformHandle)(NextRandom(seed) * count) % count);
+			else
+			{
+				transforms.Destroy(handle);
+				alive[handle] = false;
+				TransformHandle reused = transforms.Create();
+				alive[reused] = true;
+				transforms.SetPosition(reused, RandomFloat3(seed, 0.0f, 1.0f));
+			}
+		}
+
+		// Every third frame leaves it to GetWorld() to notice
+		if (frame % 3 != 2)
+			transforms.UpdateWorlds();
+		float worst = CompareWorlds(transforms, alive);
+		if (!Check(worst < 1e-4f, "%s: frame %d's world matrices are off by %g", name, frame, worst))
+			return;
+	}
+}
+
+static void TestTransforms()
+{
+	for (int simd = 0; simd < 2; simd++)
+	{
+		static const unsigned int threadCounts[] = { 1, 4 };
+		for (unsigned int threads : threadCounts)
+		{
+			char name[64];
+			snprintf(name, sizeof(name), "transforms (%s, %u thread%s)", simd ? "AVX2" : "scalar", threads, threads > 1 ? "s" : "");
+			TestTransformHierarchy(name, 20000, 8, simd != 0, threads, 7);
+			TestTransformHierarchy(name, 300, 0, simd != 0, threads, 8);
+			TestTransformHierarchy(name, 1000, 3, simd != 0, threads, 9);
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::string directory = argc > 1 ? argv[1] : "..\\x64\\Debug\\";
+	if (!directory.empty() && directory.back() != '\\' && directory.back() != '/')
+		directory += '/';
+
+	std::vector<ObjMeshData> models(sizeof(ModelNames) / sizeof(ModelNames[0]));
+	for (size_t i = 0; i < models.size(); i++)
+	{
+		if (!LoadModel(directory, ModelNames[i], models[i]))
+			continue;
+		TestMeshlets(ModelNames[i], models[i].vertices, models[i].indices);
+		TestLodChain(ModelNames[i], models[i].vertices, models[i].indices);
+	}
+
+	// The shipped models are mostly too coarse to simplify, so
+	// dense generated shapes make sure real levels get checked
+	PrimitiveMesh sphere, torus;
+	GenerateSphere(sphere, 0.5f, 64, 64);
+	GenerateTorus(torus, 0.5f, 0.2f, 48, 32);
+	TestLodChain("dense sphere", sphere.vertices, sphere.indices, true);
+	TestLodChain("dense torus", torus.vertices, torus.indices, true);
+	TestMeshletEdgeCases();
+	TestObjFaces();
+	TestObjMaterials();
+	TestMeshOptimizer(models);
+	TestVertexCompression(models);
+	TestMeshCodec(models);
+	TestTangents(models);
+	TestRangeAllocators();
+	TestTransforms();
+
+	printf("%d of %d checks failed\n", failures, checks);
+	return failures;
+}
@@ -0,0 +1,508 @@
+// --------------------------------------------------------
+// ObjCorpusGen - writes synthetic OBJ files for benchmarking
+// the loader (see MeshLoaderBench)
+//
+// Usage:
+//   ObjCorpusGen <out.obj> [options]
+//   ObjCorpusGen -corpus <folder> [-max <triangles>] [-seed <n>]
+//
+// Options:
+//   -triangles <n>    Triangles to write, e.g. 5000, 250K, 50M
+//                     (default 1M - rounded up to whole faces)
+//   -seed <n>         Seed for every random choice (default 1)
+//   -attributes <a>   p, pt, pn or ptn: which of v (p), vt (t)
+//                     and vn (n) the faces use (default ptn)
+//   -faces <f>        triangles, quads, polygons (5 to 7 sided)
+//                     or mixed (default triangles)
+//   -relative         Write negative (relative) indices
+//
+// -corpus writes a standard set into the folder: ptn triangles
+// from 1K to 50M triangles, plus every attribute and face mix
+// at 1M (sizes above -max are skipped).
+//
+// The surface is a bumpy heightfield, written a row at a time
+// (each row's vertices, then its faces), so files of any size
+// are streamed out in constant memory.  The same options and
+// seed give byte-for-byte the same file from the same build
+// (compiler, settings and C runtime).  The random numbers and
+// number formatting are the same everywhere, but the heights
+// and normals go through the C runtime's sin() and cos(), so
+// another compiler may write a few last digits differently.
+// --------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <string>
+
+enum class FaceMix { Triangles, Quads, Polygons, Mixed };
+
+struct CorpusOptions
+{
+	uint64_t triangles;
+	uint64_t seed;
+	bool uvs;
+	bool normals;
+	FaceMix faces;
+	bool relative;
+};
+
+// --------------------------------------------------------
+// SplitMix64 - tiny, and (unlike the std distributions) gives
+// the same numbers with every compiler
+// --------------------------------------------------------
+static uint64_t NextRandom(uint64_t& state)
+{
+	uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+// Uniform in [0, 1)
+static double RandomUnit(uint64_t& state)
+{
+	return (NextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// --------------------------------------------------------
+// Buffered output with hand-rolled number formatting (printf
+// is most of the run time otherwise)
+// --------------------------------------------------------
+class ObjWriter
+{
+	FILE* file;
+	char buffer[1 << 20];
+	size_t used;
+	uint64_t written;
+	bool failed;
+public:
+	ObjWriter(FILE* file) : file(file), used(0), written(0), failed(false) {}
+
+	void Flush()
+	{
+		if (used && fwrite(buffer, 1, used, file) != used)
+			failed = true;
+		written += used;
+		used = 0;
+	}
+
+	// Room for at least one full line
+	void Reserve()
+	{
+		if (used > sizeof(buffer) - 512)
+			Flush();
+	}
+
+	void Text(const char* text)
+	{
+		size_t length = strlen(text);
+		memcpy(buffer + used, text, length);
+		used += length;
+	}
+
+	void Char(char c)
+	{
+		buffer[used++] = c;
+	}
+
+	void Integer(int64_t value)
+	{
+		if (value < 0)
+		{
+			Char('-');
+			value = -value;
+		}
+		char digits[20];
+		int count = 0;
+		do
+		{
+			digits[count++] = (char)('0' + value % 10);
+			value /= 10;
+		} while (value);
+		while (count)
+			Char(digits[--count]);
+	}
+
+	// Fixed point with 6 decimals
+	void Float(double value)
+	{
+		int64_t scaled = (int64_t)llround(value * 1000000.0);
+		if (scaled < 0)
+		{
+			Char('-');
+			scaled = -scaled;
+		}
+		Integer(scaled / 1000000);
+		Char('.');
+		int64_t fraction = scaled % 1000000;
+		for (int64_t digit = 100000; digit; digit /= 10)
+			Char((char)('0' + (fraction / digit) % 10));
+	}
+
+	uint64_t GetBytesWritten() { return written + used; }
+	bool Failed() { return failed; }
+};
+
+// --------------------------------------------------------
+// The heightfield: a few sine waves (phases and frequencies
+// from the seed) plus per-vertex jitter
+// - sin() and cos() are only as exact as the C runtime makes
+//    them, so these can differ in the last bits between builds
+// --------------------------------------------------------
+struct Heightfield
+{
+	double frequency[2];
+	double phase[2];
+	uint64_t seed;
+
+	double Height(double x, double z, uint64_t vertex) const
+	{
+		uint64_t state = seed ^ (vertex * 0xD1B54A32D192ED03ull);
+		double jitter = RandomUnit(state) - 0.5;
+		return 0.05 * (sin(x * frequency[0] + phase[0]) + sin(z * frequency[1] + phase[1])) + 0.002 * jitter;
+	}
+
+	// Normal of the waves (the jitter is too small to matter)
+	void Normal(double x, double z, double normal[3]) const
+	{
+		double dx = 0.05 * frequency[0] * cos(x * frequency[0] + phase[0]);
+		double dz = 0.05 * frequency[1] * cos(z * frequency[1] + phase[1]);
+		double length = sqrt(dx * dx + 1.0 + dz * dz);
+		normal[0] = -dx / length;
+		normal[1] = 1.0 / length;
+		normal[2] = -dz / length;
+	}
+};
+
+// --------------------------------------------------------
+// Writes one face corner, using the same number for each
+// attribute (every vertex has its own vt and vn)
+// --------------------------------------------------------
+static void WriteCorner(ObjWriter& out, const CorpusOptions& options, uint64_t index, uint64_t vertexCount)
+{
+	// Relative indices count back from the last vertex (-1)
+	int64_t value = options.relative ? (int64_t)index - (int64_t)vertexCount - 1 : (int64_t)index;
+
+	out.Char(' ');
+	out.Integer(value);
+	if (options.uvs || options.normals)
+	{
+		out.Char('/');
+		if (options.uvs)
+			out.Integer(value);
+		if (options.normals)
+		{
+			out.Char('/');
+			out.Integer(value);
+		}
+	}
+}
+
+// --------------------------------------------------------
+// Writes a whole file - returns false if it couldn't be written
+// --------------------------------------------------------
+static bool WriteCorpusFile(const char* path, const CorpusOptions& options)
+{
+	FILE* file = 0;
+#ifdef _WIN32
+	if (fopen_s(&file, path, "wb") != 0)
+		file = 0;
+#else
+	file = fopen(path, "wb");
+#endif
+	if (!file)
+	{
+		fprintf(stderr, "Can't create %s\n", path);
+		return false;
+	}
+
+	ObjWriter* out = new ObjWriter(file);
+	uint64_t random = options.seed;
+
+	Heightfield field;
+	field.seed = NextRandom(random);
+	for (int i = 0; i < 2; i++)
+	{
+		field.frequency[i] = 4.0 + 20.0 * RandomUnit(random);
+		field.phase[i] = 6.28318530718 * RandomUnit(random);
+	}
+
+	// Roughly square, in a 1 x 1 area (rows continue past it if
+	// the faces use fewer triangles per cell than planned)
+	uint64_t columns = (uint64_t)sqrt((double)options.triangles / 2.0);
+	if (columns < 1) columns = 1;
+	double spacing = 1.0 / columns;
+
+	static const char* faceNames[] = { "triangles", "quads", "polygons", "mixed" };
+	out->Text("# ObjCorpusGen -triangles ");
+	out->Integer((int64_t)options.triangles);
+	out->Text(" -seed ");
+	out->Integer((int64_t)options.seed);
+	out->Text(" -attributes p");
+	if (options.uvs) out->Char('t');
+	if (options.normals) out->Char('n');
+	out->Text(" -faces ");
+	out->Text(faceNames[(int)options.faces]);
+	if (options.relative) out->Text(" -relative");
+	out->Char('\n');
+
+	uint64_t vertexCount = 0;
+	uint64_t triangles = 0;
+	for (uint64_t row = 0; triangles < options.triangles; row++)
+	{
+		// This row's vertices (and the first row's neighbours)
+		for (uint64_t z = (row == 0 ? 0 : row + 1); z <= row + 1; z++)
+		{
+			for (uint64_t x = 0; x <= columns; x++)
+			{
+				double px = x * spacing - 0.5;
+				double pz = z * spacing - 0.5;
+				out->Reserve();
+				out->Text("v ");
+				out->Float(px);
+				out->Char(' ');
+				out->Float(field.Height(px, pz, vertexCount));
+				out->Char(' ');
+				out->Float(pz);
+				out->Char('\n');
+				if (options.uvs)
+				{
+					out->Text("vt ");
+					out->Float((double)x / columns);
+					out->Char(' ');
+					out->Float((double)z / columns);
+					out->Char('\n');
+				}
+				if (options.normals)
+				{
+					double normal[3];
+					field.Normal(px, pz, normal);
+					out->Text("vn ");
+					out->Float(normal[0]);
+					out->Char(' ');
+					out->Float(normal[1]);
+					out->Char(' ');
+					out->Float(normal[2]);
+					out->Char('\n');
+				}
+				vertexCount++;
+			}
+		}
+
+		// 1-based index of vertex (x, z) in the two rows of this cell row
+		uint64_t nearRow = vertexCount - 2 * (columns + 1) + 1;
+		uint64_t farRow = nearRow + columns + 1;
+
+		// Corners go clockwise seen from above, so the faces point up
+		uint64_t x = 0;
+		while (x < columns && triangles < options.triangles)
+		{
+			FaceMix kind = options.faces;
+			if (kind == FaceMix::Mixed)
+				kind = (FaceMix)(NextRandom(random) % 3);
+
+			out->Reserve();
+			if (kind == FaceMix::Triangles)
+			{
+				uint64_t a = nearRow + x, b = farRow + x, c = farRow + x + 1, d = nearRow + x + 1;
+				out->Char('f');
+				WriteCorner(*out, options, a, vertexCount);
+				WriteCorner(*out, options, b, vertexCount);
+				WriteCorner(*out, options, c, vertexCount);
+				out->Text("\nf");
+				WriteCorner(*out, options, a, vertexCount);
+				WriteCorner(*out, options, c, vertexCount);
+				WriteCorner(*out, options, d, vertexCount);
+				out->Char('\n');
+				triangles += 2;
+				x++;
+			}
+			else if (kind == FaceMix::Quads)
+			{
+				out->Char('f');
+				WriteCorner(*out, options, nearRow + x, vertexCount);
+				WriteCorner(*out, options, farRow + x, vertexCount);
+				WriteCorner(*out, options, farRow + x + 1, vertexCount);
+				WriteCorner(*out, options, nearRow + x + 1, vertexCount);
+				out->Char('\n');
+				triangles += 2;
+				x++;
+			}
+			else
+			{
+				// A strip of 2 to 4 cells: its near corner, every far
+				// vertex, then the other near corner - convex, and
+				// fanned from the first corner without slivers (the
+				// near edge gets T-junctions, which don't matter here)
+				uint64_t cells = 2 + NextRandom(random) % 3;
+				if (cells > columns - x)
+					cells = columns - x;
+				out->Char('f');
+				WriteCorner(*out, options, nearRow + x, vertexCount);
+				for (uint64_t i = 0; i <= cells; i++)
+					WriteCorner(*out, options, farRow + x + i, vertexCount);
+				WriteCorner(*out, options, nearRow + x + cells, vertexCount);
+				out->Char('\n');
+				triangles += cells + 1;
+				x += cells;
+			}
+		}
+	}
+
+	out->Flush();
+	bool ok = !out->Failed();
+	uint64_t bytes = out->GetBytesWritten();
+	delete out;
+	if (fclose(file) != 0)
+		ok = false;
+
+	if (ok)
+		printf("%s: %llu triangles, %llu vertices, %.1f MB\n", path, (unsigned long long)triangles, (unsigned long long)vertexCount, bytes / (1024.0 * 1024.0));
+	else
+		fprintf(stderr, "Failed writing %s\n", path);
+	return ok;
+}
+
+// Reads counts like 5000, 250K or 50M
+static bool ParseCount(const char* text, uint64_t& count)
+{
+	char* end;
+	double value = strtod(text, &end);
+	if (end == text || value < 0)
+		return false;
+	if (*end == 'K' || *end == 'k') { value *= 1000; end++; }
+	else if (*end == 'M' || *end == 'm') { value *= 1000000; end++; }
+	if (*end)
+		return false;
+	count = (uint64_t)value;
+	return true;
+}
+
+static bool ParseAttributes(const char* text, CorpusOptions& options)
+{
+	if (text[0] != 'p')
+		return false;
+	options.uvs = strchr(text, 't') != 0;
+	options.normals = strchr(text, 'n') != 0;
+	return strspn(text, "ptn") == strlen(text);
+}
+
+static bool ParseFaces(const char* text, FaceMix& faces)
+{
+	static const char* names[] = { "triangles", "quads", "polygons", "mixed" };
+	for (int i = 0; i < 4; i++)
+	{
+		if (strcmp(text, names[i]) == 0)
+		{
+			faces = (FaceMix)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+// --------------------------------------------------------
+// Writes the standard corpus into "folder"
+// --------------------------------------------------------
+static bool WriteCorpus(std::string folder, uint64_t maxTriangles, uint64_t seed)
+{
+	if (!folder.empty() && folder.back() != '/' && folder.back() != '\\')
+		folder += '/';
+
+	struct Entry { const char* name; uint64_t triangles; const char* attributes; FaceMix faces; };
+	static const Entry entries[] =
+	{
+		{ "triangles_ptn_1K.obj", 1000, "ptn", FaceMix::Triangles },
+		{ "triangles_ptn_10K.obj", 10000, "ptn", FaceMix::Triangles },
+		{ "triangles_ptn_100K.obj", 100000, "ptn", FaceMix::Triangles },
+		{ "triangles_ptn_1M.obj", 1000000, "ptn", FaceMix::Triangles },
+		{ "triangles_ptn_10M.obj", 10000000, "ptn", FaceMix::Triangles },
+		{ "triangles_ptn_50M.obj", 50000000, "ptn", FaceMix::Triangles },
+		{ "triangles_p_1M.obj", 1000000, "p", FaceMix::Triangles },
+		{ "triangles_pt_1M.obj", 1000000, "pt", FaceMix::Triangles },
+		{ "triangles_pn_1M.obj", 1000000, "pn", FaceMix::Triangles },
+		{ "quads_ptn_1M.obj", 1000000, "ptn", FaceMix::Quads },
+		{ "polygons_ptn_1M.obj", 1000000, "ptn", FaceMix::Polygons },
+		{ "mixed_ptn_1M.obj", 1000000, "ptn", FaceMix::Mixed },
+	};
+
+	bool ok = true;
+	for (const Entry& entry : entries)
+	{
+		if (entry.triangles > maxTriangles)
+			continue;
+
+		CorpusOptions options = {};
+		options.triangles = entry.triangles;
+		options.seed = seed;
+		options.faces = entry.faces;
+		ParseAttributes(entry.attributes, options);
+		ok &= WriteCorpusFile((folder + entry.name).c_str(), options);
+	}
+	return ok;
+}
+
+static int Usage()
+{
+	fprintf(stderr,
+		"Usage: ObjCorpusGen <out.obj> [-triangles n] [-seed n] [-attributes p|pt|pn|ptn]\n"
+		"                    [-faces triangles|quads|polygons|mixed] [-relative]\n"
+		"       ObjCorpusGen -corpus <folder> [-max triangles] [-seed n]\n");
+	return 1;
+}
+
+int main(int argc, char* argv[])
+{
+	CorpusOptions options = {};
+	options.triangles = 1000000;
+	options.seed = 1;
+	options.uvs = true;
+	options.normals = true;
+	options.faces = FaceMix::Triangles;
+
+	const char* output = 0;
+	const char* corpus = 0;
+	uint64_t maxTriangles = 50000000;
+	for (int i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (strcmp(arg, "-triangles") == 0 && hasValue)
+		{
+			if (!ParseCount(argv[++i], options.triangles) || options.triangles == 0) return Usage();
+		}
+		else if (strcmp(arg, "-seed") == 0 && hasValue)
+		{
+			if (!ParseCount(argv[++i], options.seed)) return Usage();
+		}
+		else if (strcmp(arg, "-attributes") == 0 && hasValue)
+		{
+			if (!ParseAttributes(argv[++i], options)) return Usage();
+		}
+		else if (strcmp(arg, "-faces") == 0 && hasValue)
+		{
+			if (!ParseFaces(argv[++i], options.faces)) return Usage();
+		}
+		else if (strcmp(arg, "-relative") == 0)
+			options.relative = true;
+		else if (strcmp(arg, "-corpus") == 0 && hasValue)
+			corpus = argv[++i];
+		else if (strcmp(arg, "-max") == 0 && hasValue)
+		{
+			if (!ParseCount(argv[++i], maxTriangles)) return Usage();
+		}
+		else if (arg[0] != '-' && !output)
+			output = arg;
+		else
+			return Usage();
+	}
+
+	if (corpus)
+		return WriteCorpus(corpus, maxTriangles, options.seed) ? 0 : 1;
+	if (!output)
+		return Usage();
+	return WriteCorpusFile(output, options) ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+// --------------------------------------------------------
+// TransformBench - times world matrix updates for many moving
+// entities, with no window or device
+//
+// Usage:
+//   TransformBench [options] [entity counts...]
+//
+// Options:
+//   -frames <n>       Frames to time for each count (default 100)
+//   -moving <p>       Percentage of entities moved each frame
+//                     (default 100)
+//
+// Counts default to 1000, 100000 and 1000000.  Each frame
+// moves some of the entities and then brings every world
+// matrix up to date, three ways:
+//   objects - one heap object per entity holding its own
+//             position, Euler angles, scale and matrix (the way
+//             GameEntity used to), each rebuilt as it moves
+//   scalar  - TransformSystem, one matrix at a time
+//   avx2    - TransformSystem, eight matrices at a time (skipped
+//             if the CPU has no AVX2)
+// --------------------------------------------------------
+
+#include <DirectXMath.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "../TransformSystem.h"
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// An entity laid out like GameEntity was before it moved its
+// transform into a TransformSystem
+// --------------------------------------------------------
+struct ObjectEntity
+{
+	XMMATRIX worldTemp;
+	XMFLOAT3 pos;
+	XMFLOAT3 scale;
+	XMFLOAT3 rot;
+	XMFLOAT4X4 world;
+
+	void Move(XMFLOAT3 move)
+	{
+		pos = XMFLOAT3(pos.x + move.x, pos.y + move.y, pos.z + move.z);
+		worldTemp =
+			XMMatrixScaling(scale.x, scale.y, scale.z) *
+			XMMatrixRotationRollPitchYaw(rot.x, rot.y, rot.z) *
+			XMMatrixTranslation(pos.x, pos.y, pos.z);
+		XMStoreFloat4x4(&world, XMMatrixTranspose(worldTemp));
+	}
+};
+
+// Repeatable pseudo-random numbers in [0, 1)
+static float NextRandom(unsigned int& state)
+{
+	state = state * 1664525u + 1013904223u;
+	return (state >> 8) * (1.0f / 16777216.0f);
+}
+
+// Sum of every matrix's translation, so nothing gets optimized away
+static double Checksum(const XMFLOAT4X4& m)
+{
+	return (double)m._14 + m._24 + m._34;
+}
+
+static double Milliseconds(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+static void PrintRow(size_t count, const char* method, double milliseconds, int frames, double checksum)
+{
+	double perFrame = milliseconds / frames;
+	printf("%10zu %-8s %12.3f %12.2f %16.6g\n", count, method, perFrame, perFrame * 1e6 / count, checksum);
+	fflush(stdout);
+}
+
+static void RunObjects(size_t count, const std::vector<unsigned int>& moving, int frames)
+{
+	// One allocation per entity, like "new GameEntity" - shuffled,
+	// since entities spawned over time don't end up in order
+	std::vector<ObjectEntity*> entities(count);
+	unsigned int seed = 1;
+	for (size_t i = 0; i < count; i++)
+	{
+		entities[i] = new ObjectEntity();
+		entities[i]->pos = XMFLOAT3(NextRandom(seed) * 100, NextRandom(seed) * 100, NextRandom(seed) * 100);
+		entities[i]->rot = XMFLOAT3(NextRandom(seed) * 6, NextRandom(seed) * 6, NextRandom(seed) * 6);
+		entities[i]->scale = XMFLOAT3(1, 1, 1);
+	}
+	for (size_t i = count - 1; i > 0; i--)
+		std::swap(entities[i], entities[(size_t)(NextRandom(seed) * (i + 1))]);
+
+	auto start = std::chrono::high_resolution_clock::now();
+	double checksum = 0;
+	for (int frame = 0; frame < frames; frame++)
+	{
+		for (size_t k = 0; k < moving.size(); k++)
+			entities[moving[k]]->Move(XMFLOAT3(0.01f, 0, 0));
+		checksum += Checksum(entities[frame % count]->world);
+	}
+	PrintRow(count, "objects", Milliseconds(start), frames, checksum);
+
+	for (size_t i = 0; i < count; i++)
+		delete entities[i];
+}
+
+static void RunSystem(size_t count, const std::vector<unsigned int>& moving, int frames, bool simd)
+{
+	TransformSystem transforms;
+	transforms.SetSimdEnabled(simd);
+	if (simd && !transforms.IsSimdEnabled())
+	{
+		printf("%10zu %-8s (no AVX2 on this CPU)\n", count, "avx2");
+		return;
+	}
+
+	unsigned int seed = 1;
+	for (size_t i = 0; i < count; i++)
+	{
+		TransformHandle handle = transforms.Create();
+		transforms.SetPosition(handle, XMFLOAT3(NextRandom(seed) * 100, NextRandom(seed) * 100, NextRandom(seed) * 100));
+		XMFLOAT4 rotation;
+		XMStoreFloat4(&rotation, XMQuaternionRotationRollPitchYaw(NextRandom(seed) * 6, NextRandom(seed) * 6, NextRandom(seed) * 6));
+		transforms.SetRotation(handle, rotation);
+	}
+	transforms.UpdateWorlds();
+
+	auto start = std::chrono::high_resolution_clock::now();
+	double checksum = 0;
+	for (int frame = 0; frame < frames; frame++)
+	{
+		for (size_t k = 0; k < moving.size(); k++)
+		{
+			XMFLOAT3 pos = transforms.GetPosition(moving[k]);
+			transforms.SetPosition(moving[k], XMFLOAT3(pos.x + 0.01f, pos.y, pos.z));
+		}
+		transforms.UpdateWorlds();
+		checksum += Checksum(transforms.GetWorld((TransformHandle)(frame % count)));
+	}
+	PrintRow(count, simd ? "avx2" : "scalar", Milliseconds(start), frames, checksum);
+}
+
+// --------------------------------------------------------
+// Both TransformSystem paths have to build the same matrices
+// --------------------------------------------------------
+static bool CheckPathsMatch()
+{
+	TransformSystem scalar, simd;
+	scalar.SetSimdEnabled(false);
+	simd.SetSimdEnabled(true);
+	if (!simd.IsSimdEnabled())
+		return true;
+
+	unsigned int seed = 7;
+	for (int i = 0; i < 1001; i++)
+	{
+		XMFLOAT3 pos(NextRandom(seed) * 10 - 5, NextRandom(seed) * 10 - 5, NextRandom(seed) * 10 - 5);
+		XMFLOAT4 rotation(NextRandom(seed) - 0.5f, NextRandom(seed) - 0.5f, NextRandom(seed) - 0.5f, NextRandom(seed) - 0.5f);
+		XMFLOAT3 scale(NextRandom(seed) * 3, NextRandom(seed) * 3, NextRandom(seed) * 3);
+		TransformSystem* systems[] = { &scalar, &simd };
+		for (TransformSystem* system : systems)
+		{
+			TransformHandle handle = system->Create();
+			system->SetPosition(handle, pos);
+			system->SetRotation(handle, rotation);
+			system->SetScale(handle, scale);
+		}
+	}
+	scalar.UpdateWorlds();
+	simd.UpdateWorlds();
+
+	for (TransformHandle i = 0; i < (TransformHandle)scalar.GetCapacity(); i++)
+	{
+		if (memcmp(&scalar.GetWorld(i), &simd.GetWorld(i), sizeof(XMFLOAT4X4)) != 0)
+		{
+			fprintf(stderr, "AVX2 and scalar matrices differ at %u\n", i);
+			return false;
+		}
+	}
+	return true;
+}
+
+static int Usage()
+{
+	fprintf(stderr, "Usage: TransformBench [-frames n] [-moving percent] [entity counts...]\n");
+	return 1;
+}
+
+int main(int argc, char* argv[])
+{
+	int frames = 100;
+	double movingPercent = 100;
+	std::vector<size_t> counts;
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = i + 1 < argc;
+		if (strcmp(argv[i], "-frames") == 0 && hasValue)
+			frames = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-moving") == 0 && hasValue)
+			movingPercent = atof(argv[++i]);
+		else if (argv[i][0] != '-' && atoll(argv[i]) > 0)
+			counts.push_back((size_t)atoll(argv[i]));
+		else
+			return Usage();
+	}
+	if (frames < 1 || movingPercent < 0 || movingPercent > 100)
+		return Usage();
+	if (counts.empty())
+		counts = { 1000, 100000, 1000000 };
+
+	if (!CheckPathsMatch())
+		return 1;
+
+	printf("%10s %-8s %12s %12s %16s\n", "entities", "method", "ms/frame", "ns/entity", "checksum");
+	for (size_t count : counts)
+	{
+		// The same entities move in every method, spread evenly
+		std::vector<unsigned int> moving;
+		size_t movingCount = (size_t)(count * movingPercent / 100.0 + 0.5);
+		for (size_t k = 0; k < movingCount; k++)
+			moving.push_back((unsigned int)(k * count / movingCount));
+
+		RunObjects(count, moving, frames);
+		RunSystem(count, moving, frames, false);
+		RunSystem(count, moving, frames, true);
+	}
+	return 0;
+}
@@ -0,0 +1,600 @@
+#include "TransformSystem.h"
+#include "Parallel.h"
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define TRANSFORM_AVX2
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+using namespace DirectX;
+
+#ifdef TRANSFORM_AVX2
+// MSVC takes AVX intrinsics anywhere - GCC and Clang need the
+// functions using them marked
+#if defined(__GNUC__)
+#define AVX2_FUNCTION __attribute__((target("avx2")))
+#else
+#define AVX2_FUNCTION
+#endif
+
+// --------------------------------------------------------
+// Whether the CPU (and the OS, which has to save the wider
+// registers) supports AVX2
+// --------------------------------------------------------
+static bool CpuHasAvx2()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+
+	__cpuid(info, 1);
+	bool osSavesAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+	if (!osSavesAvx)
+		return false;
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+// --------------------------------------------------------
+// Transposes eight rows of eight floats - row i of the result
+// is column i of the input
+// --------------------------------------------------------
+AVX2_FUNCTION static inline void Transpose8x8(__m256 r[8])
+{
+	__m256 t0 = _mm256_unpacklo_ps(r[0], r[1]);
+	__m256 t1 = _mm256_unpackhi_ps(r[0], r[1]);
+	__m256 t2 = _mm256_unpacklo_ps(r[2], r[3]);
+	__m256 t3 = _mm256_unpackhi_ps(r[2], r[3]);
+	__m256 t4 = _mm256_unpacklo_ps(r[4], r[5]);
+	__m256 t5 = _mm256_unpackhi_ps(r[4], r[5]);
+	__m256 t6 = _mm256_unpacklo_ps(r[6], r[7]);
+	__m256 t7 = _mm256_unpackhi_ps(r[6], r[7]);
+
+	__m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+	__m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+	__m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+	__m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+	__m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+	__m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+	__m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+	__m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+	r[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+	r[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+	r[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+	r[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+	r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+	r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+	r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+	r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+// --------------------------------------------------------
+// Builds the local matrices of eight transforms at once: each
+// register holds one matrix element for all eight, which are
+// then transposed into eight matrices' worth of rows
+// - Same arithmetic as ComposeLocal(), in the same order
+// --------------------------------------------------------
+AVX2_FUNCTION static void ComposeLocals8(
+	const float* px, const float* py, const float* pz,
+	const float* qx, const float* qy, const float* qz, const float* qw,
+	const float* sx, const float* sy, const float* sz,
+	XMFLOAT4X4* locals)
+{
+	__m256 x = _mm256_loadu_ps(qx);
+	__m256 y = _mm256_loadu_ps(qy);
+	__m256 z = _mm256_loadu_ps(qz);
+	__m256 w = _mm256_loadu_ps(qw);
+	__m256 one = _mm256_set1_ps(1.0f);
+	__m256 two = _mm256_set1_ps(2.0f);
+
+	__m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+	__m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+	__m256 xw = _mm256_mul_ps(x, w), yw = _mm256_mul_ps(y, w), zw = _mm256_mul_ps(z, w);
+
+	__m256 scaleX = _mm256_loadu_ps(sx);
+	__m256 scaleY = _mm256_loadu_ps(sy);
+	__m256 scaleZ = _mm256_loadu_ps(sz);
+
+	// Top two rows: _11 .. _24
+	__m256 rows[8];
+	rows[0] = _mm256_mul_ps(scaleX, _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))));
+	rows[1] = _mm256_mul_ps(scaleY, _mm256_mul_ps(two, _mm256_sub_ps(xy, zw)));
+	rows[2] = _mm256_mul_ps(scaleZ, _mm256_mul_ps(two, _mm256_add_ps(xz, yw)));
+	rows[3] = _mm256_loadu_ps(px);
+	rows[4] = _mm256_mul_ps(scaleX, _mm256_mul_ps(two, _mm256_add_ps(xy, zw)));
+	rows[5] = _mm256_mul_ps(scaleY, _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))));
+	rows[6] = _mm256_mul_ps(scaleZ, _mm256_mul_ps(two, _mm256_sub_ps(yz, xw)));
+	rows[7] = _mm256_loadu_ps(py);
+	Transpose8x8(rows);
+	for (int i = 0; i < 8; i++)
+		_mm256_storeu_ps(&locals[i]._11, rows[i]);
+
+	// Bottom two rows: _31 .. _44
+	__m256 zero = _mm256_setzero_ps();
+	rows[0] = _mm256_mul_ps(scaleX, _mm256_mul_ps(two, _mm256_sub_ps(xz, yw)));
+	rows[1] = _mm256_mul_ps(scaleY, _mm256_mul_ps(two, _mm256_add_ps(yz, xw)));
+	rows[2] = _mm256_mul_ps(scaleZ, _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy))));
+	rows[3] = _mm256_loadu_ps(pz);
+	rows[4] = zero;
+	rows[5] = zero;
+	rows[6] = zero;
+	rows[7] = one;
+	Transpose8x8(rows);
+	for (int i = 0; i < 8; i++)
+		_mm256_storeu_ps(&locals[i]._31, rows[i]);
+}
+#endif
+
+// How far a rotation's squared length may drift from 1 before
+// Rotate() normalizes it again - about a thousandth of a percent
+// of scale error
+static const float RenormalizeTolerance = 2e-5f;
+
+// Levels smaller than this are quicker to do on one thread than
+// to hand out
+static const size_t ParallelLevelSize = 4096;
+
+TransformSystem::TransformSystem()
+{
+	updateNumber = 1;
+	changed = false;
+	hierarchyChanged = false;
+	threadCount = ResolveThreadCount(0);
+	workers = 0;
+#ifdef TRANSFORM_AVX2
+	simd = CpuHasAvx2();
+#else
+	simd = false;
+#endif
+}
+
+TransformSystem::~TransformSystem()
+{
+	delete workers;
+}
+
+TransformHandle TransformSystem::Create()
+{
+	TransformHandle handle;
+	if (!freeHandles.empty())
+	{
+		handle = freeHandles.back();
+		freeHandles.pop_back();
+	}
+	else
+	{
+		handle = (TransformHandle)locals.size();
+		positionX.push_back(0); positionY.push_back(0); positionZ.push_back(0);
+		rotationX.push_back(0); rotationY.push_back(0); rotationZ.push_back(0); rotationW.push_back(1);
+		scaleX.push_back(1); scaleY.push_back(1); scaleZ.push_back(1);
+		locals.push_back(XMFLOAT4X4());
+		dirty.push_back(1);
+		composedIn.push_back(0);
+		parents.push_back(NoTransform);
+		childCounts.push_back(0);
+		linkSlots.push_back(NoTransform);
+		linkLevels.push_back(0);
+		return handle;
+	}
+
+	SetPosition(handle, XMFLOAT3(0, 0, 0));
+	SetRotation(handle, XMFLOAT4(0, 0, 0, 1));
+	SetScale(handle, XMFLOAT3(1, 1, 1));
+	return handle;
+}
+
+void TransformSystem::Destroy(TransformHandle handle)
+{
+	SetParent(handle, NoTransform);
+	if (childCounts[handle] > 0)
+	{
+		for (size_t i = 0; i < parents.size(); i++)
+			if (parents[i] == handle)
+				SetParent((TransformHandle)i, NoTransform);
+	}
+
+	// Nothing needs its matrix anymore
+	dirty[handle] = 0;
+	freeHandles.push_back(handle);
+}
+
+XMFLOAT3 TransformSystem::GetPosition(TransformHandle handle)
+{
+	return XMFLOAT3(positionX[handle], positionY[handle], positionZ[handle]);
+}
+
+XMFLOAT4 TransformSystem::GetRotation(TransformHandle handle)
+{
+	return XMFLOAT4(rotationX[handle], rotationY[handle], rotationZ[handle], rotationW[handle]);
+}
+
+XMFLOAT3 TransformSystem::GetScale(TransformHandle handle)
+{
+	return XMFLOAT3(scaleX[handle], scaleY[handle], scaleZ[handle]);
+}
+
+void TransformSystem::SetPosition(TransformHandle handle, XMFLOAT3 position)
+{
+	positionX[handle] = position.x;
+	positionY[handle] = position.y;
+	positionZ[handle] = position.z;
+	MarkDirty(handle);
+}
+
+void TransformSystem::SetRotation(TransformHandle handle, XMFLOAT4 rotation)
+{
+	// The matrix formula only holds for unit quaternions
+	float length = sqrtf(rotation.x * rotation.x + rotation.y * rotation.y + rotation.z * rotation.z + rotation.w * rotation.w);
+	float scale = length > 0 ? 1.0f / length : 0.0f;
+	rotationX[handle] = rotation.x * scale;
+	rotationY[handle] = rotation.y * scale;
+	rotationZ[handle] = rotation.z * scale;
+	rotationW[handle] = length > 0 ? rotation.w * scale : 1.0f;
+	MarkDirty(handle);
+}
+
+// --------------------------------------------------------
+// Turns a transform further: the product is the same as
+// XMQuaternionMultiply(current, rotation), i.e. r * q.  Products
+// of unit quaternions only drift from unit length by rounding,
+// so the result is only normalized again once it has drifted
+// enough to matter - not on every call.
+// --------------------------------------------------------
+void TransformSystem::Rotate(TransformHandle handle, XMFLOAT4 r)
+{
+	float qx = rotationX[handle], qy = rotationY[handle], qz = rotationZ[handle], qw = rotationW[handle];
+	float x = r.w * qx + r.x * qw + r.y * qz - r.z * qy;
+	float y = r.w * qy - r.x * qz + r.y * qw + r.z * qx;
+	float z = r.w * qz + r.x * qy - r.y * qx + r.z * qw;
+	float w = r.w * qw - r.x * qx - r.y * qy - r.z * qz;
+
+	float lengthSq = x * x + y * y + z * z + w * w;
+	if (fabsf(lengthSq - 1.0f) > RenormalizeTolerance)
+	{
+		SetRotation(handle, XMFLOAT4(x, y, z, w));
+		return;
+	}
+
+	rotationX[handle] = x;
+	rotationY[handle] = y;
+	rotationZ[handle] = z;
+	rotationW[handle] = w;
+	MarkDirty(handle);
+}
+
+void TransformSystem::SetScale(TransformHandle handle, XMFLOAT3 scale)
+{
+	scaleX[handle] = scale.x;
+	scaleY[handle] = scale.y;
+	scaleZ[handle] = scale.z;
+	MarkDirty(handle);
+}
+
+// --------------------------------------------------------
+// Marks the local matrix out of date, and the level of the
+// hierarchy that has to look at it - its own, or the first for
+// a top level transform with children (while the hierarchy
+// needs sorting, every level is looked at anyway)
+// --------------------------------------------------------
+void TransformSystem::MarkDirty(TransformHandle handle)
+{
+	dirty[handle] = 1;
+	changed = true;
+	if (hierarchyChanged)
+		return;
+
+	if (linkSlots[handle] != NoTransform)
+		levelsTouched[linkLevels[handle]] = 1;
+	else if (childCounts[handle] > 0)
+		levelsTouched[0] = 1;
+}
+
+// --------------------------------------------------------
+// Builds one local matrix - the rotation part is the
+// quaternion's matrix (as XMMatrixRotationQuaternion makes it)
+// with its rows scaled, all stored transposed
+// --------------------------------------------------------
+void TransformSystem::ComposeLocal(size_t i)
+{
+	float x = rotationX[i], y = rotationY[i], z = rotationZ[i], w = rotationW[i];
+	float xx = x * x, yy = y * y, zz = z * z;
+	float xy = x * y, xz = x * z, yz = y * z;
+	float xw = x * w, yw = y * w, zw = z * w;
+
+	XMFLOAT4X4& m = locals[i];
+	m._11 = scaleX[i] * (1.0f - 2.0f * (yy + zz));
+	m._12 = scaleY[i] * (2.0f * (xy - zw));
+	m._13 = scaleZ[i] * (2.0f * (xz + yw));
+	m._14 = positionX[i];
+	m._21 = scaleX[i] * (2.0f * (xy + zw));
+	m._22 = scaleY[i] * (1.0f - 2.0f * (xx + zz));
+	m._23 = scaleZ[i] * (2.0f * (yz - xw));
+	m._24 = positionY[i];
+	m._31 = scaleX[i] * (2.0f * (xz - yw));
+	m._32 = scaleY[i] * (2.0f * (yz + xw));
+	m._33 = scaleZ[i] * (1.0f - 2.0f * (xx + yy));
+	m._34 = positionZ[i];
+	m._41 = 0.0f;
+	m._42 = 0.0f;
+	m._43 = 0.0f;
+	m._44 = 1.0f;
+	dirty[i] = 0;
+	composedIn[i] = updateNumber;
+}
+
+bool TransformSystem::SetParent(TransformHandle handle, TransformHandle parent)
+{
+	if (parent == parents[handle])
+		return true;
+
+	// No loops
+	for (TransformHandle ancestor = parent; ancestor != NoTransform; ancestor = parents[ancestor])
+		if (ancestor == handle)
+			return false;
+
+	if (parents[handle] != NoTransform)
+		childCounts[parents[handle]]--;
+	if (parent != NoTransform)
+		childCounts[parent]++;
+	parents[handle] = parent;
+
+	hierarchyChanged = true;
+	changed = true;
+	return true;
+}
+
+TransformHandle TransformSystem::GetParent(TransformHandle handle)
+{
+	return parents[handle];
+}
+
+const XMFLOAT4X4& TransformSystem::GetWorld(TransformHandle handle)
+{
+	if (parents[handle] == NoTransform)
+	{
+		if (dirty[handle])
+			ComposeLocal(handle);
+		return locals[handle];
+	}
+
+	if (changed)
+		UpdateWorlds();
+	return linkWorlds[linkSlots[handle]];
+}
+
+// --------------------------------------------------------
+// Lays out the transforms that have parents breadth first: a
+// transform's depth is one more than its parent's, and the
+// slots are sorted by depth (a counting sort, so it stays
+// linear however deep the hierarchy goes)
+// --------------------------------------------------------
+void TransformSystem::SortHierarchy()
+{
+	size_t count = parents.size();
+	std::vector<unsigned int> depths(count, 0);
+	std::vector<TransformHandle> chain;
+	unsigned int maxDepth = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		if (parents[i] == NoTransform || depths[i] != 0)
+			continue;
+
+		// Walk up to the top level, or to a transform whose depth
+		// is already known, then fill in depths on the way back
+		TransformHandle h = (TransformHandle)i;
+		while (parents[h] != NoTransform && depths[h] == 0)
+		{
+			chain.push_back(h);
+			h = parents[h];
+		}
+		unsigned int depth = depths[h];
+		while (!chain.empty())
+		{
+			depths[chain.back()] = ++depth;
+			chain.pop_back();
+		}
+		if (depth > maxDepth)
+			maxDepth = depth;
+	}
+
+	// Level d (depth d + 1) starts at levelStarts[d]
+	levelStarts.assign(maxDepth + 1, 0);
+	for (size_t i = 0; i < count; i++)
+		if (depths[i] > 0)
+			levelStarts[depths[i]]++;
+	for (size_t d = 1; d <= maxDepth; d++)
+		levelStarts[d] += levelStarts[d - 1];
+
+	size_t linkCount = levelStarts[maxDepth];
+	linkHandles.resize(linkCount);
+	std::vector<size_t> next(levelStarts.begin(), levelStarts.end() - 1);
+	for (size_t i = 0; i < count; i++)
+	{
+		linkSlots[i] = NoTransform;
+		if (depths[i] > 0)
+		{
+			size_t slot = next[depths[i] - 1]++;
+			linkHandles[slot] = (TransformHandle)i;
+			linkSlots[i] = (unsigned int)slot;
+			linkLevels[i] = depths[i] - 1;
+		}
+	}
+
+	linkParentSlots.resize(linkCount);
+	for (size_t slot = 0; slot < linkCount; slot++)
+		linkParentSlots[slot] = linkSlots[parents[linkHandles[slot]]];
+	linkWorlds.resize(linkCount);
+	linkRebuiltIn.assign(linkCount, 0);
+	levelsTouched.assign(maxDepth, 0);
+	hierarchyChanged = false;
+}
+
+// --------------------------------------------------------
+// Builds the world matrices of slots [begin, end) of one level
+// from their parents' (which are all in earlier levels) - those
+// whose local matrix changed, or whose parent's world matrix
+// did, or all of them
+// - Returns whether any were rebuilt
+// --------------------------------------------------------
+bool TransformSystem::PropagateLevel(size_t begin, size_t end, bool all)
+{
+	bool rebuiltAny = false;
+	for (size_t slot = begin; slot < end; slot++)
+	{
+		TransformHandle handle = linkHandles[slot];
+		unsigned int parentSlot = linkParentSlots[slot];
+		const XMFLOAT4X4* parentWorld;
+		bool parentChanged;
+		if (parentSlot == NoTransform)
+		{
+			TransformHandle parent = parents[handle];
+			parentWorld = &locals[parent];
+			parentChanged = composedIn[parent] == updateNumber;
+		}
+		else
+		{
+			parentWorld = &linkWorlds[parentSlot];
+			parentChanged = linkRebuiltIn[parentSlot] == updateNumber;
+		}
+
+		if (!all && !parentChanged && composedIn[handle] != updateNumber)
+			continue;
+
+		// Both are stored transposed, so the parent goes first
+		XMMATRIX world = XMMatrixMultiply(XMLoadFloat4x4(parentWorld), XMLoadFloat4x4(&locals[handle]));
+		XMStoreFloat4x4(&linkWorlds[slot], world);
+		linkRebuiltIn[slot] = updateNumber;
+		rebuiltAny = true;
+	}
+	return rebuiltAny;
+}
+
+void TransformSystem::UpdateWorlds()
+{
+	size_t count = locals.size();
+	size_t i = 0;
+
+#ifdef TRANSFORM_AVX2
+	// Whole groups of eight at a time - a group with enough dirty
+	// in it is rebuilt entirely (rebuilding a clean matrix just
+	// gives the same one again), one with only a few dirty is
+	// cheaper a matrix at a time
+	if (simd)
+	{
+		for (; i + 8 <= count; i += 8)
+		{
+			unsigned long long flags;
+			memcpy(&flags, &dirty[i], sizeof(flags));
+			if (flags == 0)
+				continue;
+
+			// Flags are 0 or 1, so this adds up all eight bytes
+			unsigned int dirtyCount = (unsigned int)((flags * 0x0101010101010101ull) >> 56);
+			if (dirtyCount < 4)
+			{
+				for (size_t j = i; j < i + 8; j++)
+					if (dirty[j])
+						ComposeLocal(j);
+				continue;
+			}
+
+			ComposeLocals8(
+				&positionX[i], &positionY[i], &positionZ[i],
+				&rotationX[i], &rotationY[i], &rotationZ[i], &rotationW[i],
+				&scaleX[i], &scaleY[i], &scaleZ[i],
+				&locals[i]);
+			for (size_t j = i; j < i + 8; j++)
+				if (dirty[j])
+					composedIn[j] = updateNumber;
+			memset(&dirty[i], 0, 8);
+		}
+	}
+#endif
+
+	for (; i < count; i++)
+		if (dirty[i])
+			ComposeLocal(i);
+
+	// Then down the hierarchy a level at a time - every slot
+	// moves when it's sorted again, so they're all rebuilt then.
+	// A level can only need anything if something in it was set,
+	// or something in the level above was rebuilt.
+	bool all = hierarchyChanged;
+	if (hierarchyChanged)
+		SortHierarchy();
+	bool aboveRebuilt = false;
+	for (size_t level = 0; level + 1 < levelStarts.size(); level++)
+	{
+		if (!all && !aboveRebuilt && !levelsTouched[level])
+			continue;
+		levelsTouched[level] = 0;
+
+		size_t begin = levelStarts[level];
+		size_t size = levelStarts[level + 1] - begin;
+		if (size < ParallelLevelSize || threadCount == 1)
+		{
+			aboveRebuilt = PropagateLevel(begin, begin + size, all);
+			continue;
+		}
+
+		if (!workers)
+		{
+			workers = new WorkerPool(threadCount);
+			rangesRebuilt.resize(threadCount);
+		}
+		workers->For(size, [this, begin, all](size_t rangeBegin, size_t rangeEnd, size_t range)
+		{
+			rangesRebuilt[range] = PropagateLevel(begin + rangeBegin, begin + rangeEnd, all);
+		});
+
+		aboveRebuilt = false;
+		for (size_t r = 0; r < rangesRebuilt.size(); r++)
+		{
+			aboveRebuilt |= rangesRebuilt[r] != 0;
+			rangesRebuilt[r] = 0;
+		}
+	}
+
+	updateNumber++;
+	changed = false;
+}
+
+size_t TransformSystem::GetCapacity()
+{
+	return locals.size();
+}
+
+void TransformSystem::SetSimdEnabled(bool enabled)
+{
+#ifdef TRANSFORM_AVX2
+	simd = enabled && CpuHasAvx2();
+#else
+	simd = false;
+#endif
+}
+
+bool TransformSystem::IsSimdEnabled()
+{
+	return simd;
+}
+
+void TransformSystem::SetThreadCount(unsigned int count)
+{
+	threadCount = ResolveThreadCount(count);
+
+	// The pool is made again, with the new count, when it's next needed
+	delete workers;
+	workers = 0;
+}
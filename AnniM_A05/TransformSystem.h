@@ -0,0 +1,136 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+
+class WorkerPool;
+
+// Index of a transform in a TransformSystem
+typedef unsigned int TransformHandle;
+
+// "No transform" - the parent of a transform at the top level
+const TransformHandle NoTransform = 0xFFFFFFFF;
+
+// --------------------------------------------------------
+// Positions, rotations and scales of many objects, and the
+// world matrices built from them
+//
+// Every component has an array of its own (structure of
+// arrays), indexed by handle, so a pass over all transforms
+// reads memory front to back.  Changing a transform only marks
+// it dirty - UpdateWorlds() then rebuilds every dirty local
+// matrix in one pass, eight at a time with AVX2 when the CPU
+// has it.
+//
+// A transform can have a parent, which makes its position,
+// rotation and scale relative to the parent's world matrix.
+// Transforms with parents are also kept in breadth-first order
+// (every parent before its children, level by level), so
+// UpdateWorlds() passes world matrices down one whole level at
+// a time - split across a pool of threads when a level is big,
+// with no locking since each transform only reads its parent,
+// from the level before.  Only transforms that changed, or whose
+// ancestors did, are multiplied again.  A level with nothing
+// changed in it or above it is skipped outright; any other level
+// still checks every one of its transforms, so a single change
+// near the top costs a pass over everything below.
+//
+// GetWorld() is never stale: a top level transform rebuilds its
+// matrix on the spot, one with a parent runs UpdateWorlds()
+// first if anything has changed.
+//
+// World matrices are scale, then rotation, then translation
+// (then the parent's world matrix), transposed for HLSL like
+// every other matrix handed to the shaders.  Rotations are unit
+// quaternions.
+// --------------------------------------------------------
+class TransformSystem
+{
+	std::vector<float> positionX, positionY, positionZ;
+	std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+	std::vector<float> scaleX, scaleY, scaleZ;
+	std::vector<DirectX::XMFLOAT4X4> locals;	// Relative to the parent - also the world matrix at the top level
+	std::vector<unsigned char> dirty;		// 1 while locals[i] is out of date
+	std::vector<unsigned int> composedIn;	// Number of the UpdateWorlds() that first sees locals[i]'s latest change
+	std::vector<TransformHandle> freeHandles;
+	unsigned int updateNumber;				// Number of the next UpdateWorlds()
+	bool changed;							// Anything set since the last UpdateWorlds()
+	bool simd;								// AVX2 batches allowed (and supported)
+
+	// Hierarchy, by handle
+	std::vector<TransformHandle> parents;
+	std::vector<unsigned int> childCounts;
+	std::vector<unsigned int> linkSlots;	// Position in the breadth-first arrays, if the transform has a parent
+
+	// Transforms with parents, in breadth-first order
+	std::vector<TransformHandle> linkHandles;
+	std::vector<unsigned int> linkParentSlots;	// Parent's slot, or NoTransform for a top level parent
+	std::vector<DirectX::XMFLOAT4X4> linkWorlds;
+	std::vector<unsigned int> linkRebuiltIn;	// Number of the UpdateWorlds() that last rebuilt the world matrix
+	std::vector<size_t> levelStarts;			// Slots where each level begins, and one past the end
+	std::vector<unsigned int> linkLevels;		// Level of each transform with a parent, by handle
+	std::vector<unsigned char> levelsTouched;	// Something in the level (or, for level 0, a top level parent) was set
+	bool hierarchyChanged;					// The breadth-first arrays need sorting again
+
+	unsigned int threadCount;
+	WorkerPool* workers;	// Made the first time a level is big enough
+	std::vector<unsigned char> rangesRebuilt;	// Per worker range, while a level is split up
+
+	void MarkDirty(TransformHandle handle);
+	void ComposeLocal(size_t index);
+	void SortHierarchy();
+	bool PropagateLevel(size_t begin, size_t end, bool all);
+public:
+	TransformSystem();
+	~TransformSystem();
+
+	// A transform at the origin, unrotated and unscaled, at the
+	// top level
+	TransformHandle Create();
+
+	// The handle may be reused by a later Create() - any children
+	// move to the top level, keeping their (now unparented)
+	// local position, rotation and scale
+	void Destroy(TransformHandle handle);
+
+	DirectX::XMFLOAT3 GetPosition(TransformHandle handle);
+	DirectX::XMFLOAT4 GetRotation(TransformHandle handle);
+	DirectX::XMFLOAT3 GetScale(TransformHandle handle);
+	void SetPosition(TransformHandle handle, DirectX::XMFLOAT3 position);
+	void SetRotation(TransformHandle handle, DirectX::XMFLOAT4 rotation);	// Normalized here
+	void SetScale(TransformHandle handle, DirectX::XMFLOAT3 scale);
+
+	// Turns the transform by a unit quaternion, after its current
+	// rotation (so about its parent's axes)
+	void Rotate(TransformHandle handle, DirectX::XMFLOAT4 rotation);
+
+	// Attaches a transform under another (NoTransform moves it to
+	// the top level) - its local position, rotation and scale are
+	// kept, and become relative to the new parent.  Fails if the
+	// parent is the transform itself or one of its descendants.
+	bool SetParent(TransformHandle handle, TransformHandle parent);
+	TransformHandle GetParent(TransformHandle handle);
+
+	// The world matrix - only valid until the next Create(),
+	// SetParent() or UpdateWorlds()
+	const DirectX::XMFLOAT4X4& GetWorld(TransformHandle handle);
+
+	// Rebuilds every dirty local matrix, then the world matrices
+	// of everything below them
+	void UpdateWorlds();
+
+	// Handles in use or free (one past the highest ever created)
+	size_t GetCapacity();
+
+	// Turns the AVX2 path off or back on (for comparing) - it's
+	// never used on CPUs without AVX2
+	void SetSimdEnabled(bool enabled);
+	bool IsSimdEnabled();
+
+	// Threads used for big levels of the hierarchy - 0 means one
+	// per hardware thread (the default)
+	void SetThreadCount(unsigned int count);
+
+	TransformSystem(const TransformSystem&) = delete;
+	TransformSystem& operator=(const TransformSystem&) = delete;
+};
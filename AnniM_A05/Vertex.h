@@ -1,15 +1,70 @@
-#pragma once
-
-#include <DirectXMath.h>
-
-// --------------------------------------------------------
-// A custom vertex definition
-//
-// You will eventually ADD TO this, and/or make more of these!
-// --------------------------------------------------------
-struct Vertex
-{
-	DirectX::XMFLOAT3 Position;	    // The position of the vertex
-	DirectX::XMFLOAT3 Normal;
-	DirectX::XMFLOAT2 UV;
-};
\ No newline at end of file
+#pragma once
+
+#include <DirectXMath.h>
+
+// --------------------------------------------------------
+// A custom vertex definition
+//
+// You will eventually ADD TO this, and/or make more of these!
+// --------------------------------------------------------
+struct Vertex
+{
+	DirectX::XMFLOAT3 Position;	    // The position of the vertex
+	DirectX::XMFLOAT3 Normal;
+	DirectX::XMFLOAT2 UV;
+};
+
+// --------------------------------------------------------
+// A packed, 16 byte version of Vertex (half the size)
+// - Position: unorm16 x/y/z relative to the mesh's bounds
+//    (the 4th value is just padding)
+// - Normal: octahedral encoding, two snorm16's
+// - UV: two half floats
+//
+// See VertexCompression for packing and Mesh::CreateInputLayout
+// for the matching input layout
+// --------------------------------------------------------
+struct CompactVertex
+{
+	unsigned short Position[4];
+	unsigned int Normal;
+	unsigned short UV[2];
+};
+
+// --------------------------------------------------------
+// A Vertex with a tangent frame, for normal mapping
+// - Tangent.xyz: unit tangent (the direction of +U), at right
+//    angles to the normal
+// - Tangent.w: bitangent sign - the bitangent (direction of +V)
+//    is cross(Normal, Tangent.xyz) * Tangent.w
+//
+// See TangentGenerator
+// --------------------------------------------------------
+struct TangentVertex
+{
+	DirectX::XMFLOAT3 Position;
+	DirectX::XMFLOAT3 Normal;
+	DirectX::XMFLOAT2 UV;
+	DirectX::XMFLOAT4 Tangent;
+};
+
+// --------------------------------------------------------
+// Which vertex layout a Mesh uploads to the GPU
+// --------------------------------------------------------
+enum class VertexFormat
+{
+	Full,		// Vertex
+	Compact,	// CompactVertex
+	Tangent		// TangentVertex
+};
+
+// Size of one vertex in the given format
+inline unsigned int GetVertexSize(VertexFormat format)
+{
+	switch (format)
+	{
+	case VertexFormat::Compact: return sizeof(CompactVertex);
+	case VertexFormat::Tangent: return sizeof(TangentVertex);
+	default: return sizeof(Vertex);
+	}
+}
@@ -0,0 +1,211 @@
+#include "VertexCompression.h"
+#include <cmath>
+#include <cstring>
+
+using namespace DirectX;
+
+void ComputeBounds(const Vertex* vertices, size_t count, XMFLOAT3& boundsMin, XMFLOAT3& boundsMax)
+{
+	if (count == 0)
+	{
+		boundsMin = boundsMax = XMFLOAT3(0, 0, 0);
+		return;
+	}
+
+	boundsMin = boundsMax = vertices[0].Position;
+	for (size_t i = 1; i < count; i++)
+	{
+		const XMFLOAT3& p = vertices[i].Position;
+		boundsMin = XMFLOAT3(fminf(boundsMin.x, p.x), fminf(boundsMin.y, p.y), fminf(boundsMin.z, p.z));
+		boundsMax = XMFLOAT3(fmaxf(boundsMax.x, p.x), fmaxf(boundsMax.y, p.y), fmaxf(boundsMax.z, p.z));
+	}
+}
+
+unsigned short FloatToHalf(float value)
+{
+	unsigned int bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	unsigned int sign = (bits >> 16) & 0x8000;
+	unsigned int exponent = (bits >> 23) & 0xFF;
+	unsigned int mantissa = bits & 0x7FFFFF;
+
+	// NaN and infinity
+	if (exponent == 0xFF)
+		return (unsigned short)(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+
+	int halfExponent = (int)exponent - 127 + 15;
+
+	// Too big - becomes infinity
+	if (halfExponent >= 31)
+		return (unsigned short)(sign | 0x7C00);
+
+	// Too small for a normal half - becomes a denormal (or zero)
+	if (halfExponent <= 0)
+	{
+		if (halfExponent < -10)
+			return (unsigned short)sign;
+
+		mantissa |= 0x800000;
+		unsigned int shift = (unsigned int)(14 - halfExponent);
+		unsigned int half = mantissa >> shift;
+		unsigned int rest = mantissa & ((1u << shift) - 1);
+		unsigned int halfway = 1u << (shift - 1);
+		if (rest > halfway || (rest == halfway && (half & 1)))
+			half++;
+		return (unsigned short)(sign | half);
+	}
+
+	// Normal number - round the mantissa to 10 bits (a carry
+	// correctly bumps the exponent, even up to infinity)
+	unsigned int half = ((unsigned int)halfExponent << 10) | (mantissa >> 13);
+	unsigned int rest = mantissa & 0x1FFF;
+	if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+		half++;
+	return (unsigned short)(sign | half);
+}
+
+float HalfToFloat(unsigned short value)
+{
+	unsigned int sign = (unsigned int)(value & 0x8000) << 16;
+	unsigned int exponent = (value >> 10) & 0x1F;
+	unsigned int mantissa = value & 0x3FF;
+	unsigned int bits;
+
+	if (exponent == 0x1F)
+	{
+		// NaN and infinity
+		bits = sign | 0x7F800000 | (mantissa << 13);
+	}
+	else if (exponent == 0)
+	{
+		if (mantissa == 0)
+		{
+			bits = sign;
+		}
+		else
+		{
+			// Denormal - normalize it
+			int e = -1;
+			do
+			{
+				e++;
+				mantissa <<= 1;
+			} while ((mantissa & 0x400) == 0);
+			bits = sign | ((unsigned int)(127 - 15 - e) << 23) | ((mantissa & 0x3FF) << 13);
+		}
+	}
+	else
+	{
+		bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+	}
+
+	float result;
+	memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+// --------------------------------------------------------
+// Helpers for the normalized integer formats, matching the
+// D3D conversion rules (snorm16 -32768 and -32767 both mean -1)
+// --------------------------------------------------------
+static unsigned short FloatToUnorm16(float value)
+{
+	if (!(value > 0.0f)) return 0;
+	if (value >= 1.0f) return 65535;
+	return (unsigned short)(value * 65535.0f + 0.5f);
+}
+
+static short FloatToSnorm16(float value)
+{
+	if (!(value > -1.0f)) return -32767;
+	if (value >= 1.0f) return 32767;
+	return (short)roundf(value * 32767.0f);
+}
+
+static float Snorm16ToFloat(short value)
+{
+	float result = value / 32767.0f;
+	return result < -1.0f ? -1.0f : result;
+}
+
+// HLSL-style sign that treats 0 as positive, which is what
+// the shader's decode expects
+static float SignNotZero(float value)
+{
+	return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+unsigned int EncodeOctahedral(XMFLOAT3 normal)
+{
+	// Project onto the octahedron |x| + |y| + |z| = 1
+	float length = fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z);
+	if (length <= 0.0f)
+		return 0;
+
+	float x = normal.x / length;
+	float y = normal.y / length;
+
+	// Fold the lower hemisphere over the diagonals
+	if (normal.z < 0.0f)
+	{
+		float foldedX = (1.0f - fabsf(y)) * SignNotZero(x);
+		float foldedY = (1.0f - fabsf(x)) * SignNotZero(y);
+		x = foldedX;
+		y = foldedY;
+	}
+
+	unsigned short packedX = (unsigned short)FloatToSnorm16(x);
+	unsigned short packedY = (unsigned short)FloatToSnorm16(y);
+	return (unsigned int)packedX | ((unsigned int)packedY << 16);
+}
+
+XMFLOAT3 DecodeOctahedral(unsigned int packed)
+{
+	float x = Snorm16ToFloat((short)(packed & 0xFFFF));
+	float y = Snorm16ToFloat((short)(packed >> 16));
+
+	// Same math as DecodeOctahedral() in VertexShader.hlsl
+	float z = 1.0f - fabsf(x) - fabsf(y);
+	float t = z < 0.0f ? -z : 0.0f;
+	x += x >= 0.0f ? -t : t;
+	y += y >= 0.0f ? -t : t;
+
+	float length = sqrtf(x * x + y * y + z * z);
+	return XMFLOAT3(x / length, y / length, z / length);
+}
+
+void CompressVertices(const Vertex* vertices, size_t count, XMFLOAT3 boundsMin, XMFLOAT3 boundsMax, CompactVertex* compact)
+{
+	// Flat axes (a plane, for instance) just store zero
+	XMFLOAT3 extent(boundsMax.x - boundsMin.x, boundsMax.y - boundsMin.y, boundsMax.z - boundsMin.z);
+	XMFLOAT3 inverse(
+		extent.x > 0.0f ? 1.0f / extent.x : 0.0f,
+		extent.y > 0.0f ? 1.0f / extent.y : 0.0f,
+		extent.z > 0.0f ? 1.0f / extent.z : 0.0f);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const Vertex& v = vertices[i];
+		CompactVertex& c = compact[i];
+		c.Position[0] = FloatToUnorm16((v.Position.x - boundsMin.x) * inverse.x);
+		c.Position[1] = FloatToUnorm16((v.Position.y - boundsMin.y) * inverse.y);
+		c.Position[2] = FloatToUnorm16((v.Position.z - boundsMin.z) * inverse.z);
+		c.Position[3] = 0;
+		c.Normal = EncodeOctahedral(v.Normal);
+		c.UV[0] = FloatToHalf(v.UV.x);
+		c.UV[1] = FloatToHalf(v.UV.y);
+	}
+}
+
+Vertex DecompressVertex(const CompactVertex& compact, XMFLOAT3 boundsMin, XMFLOAT3 boundsMax)
+{
+	Vertex v;
+	v.Position.x = boundsMin.x + (compact.Position[0] / 65535.0f) * (boundsMax.x - boundsMin.x);
+	v.Position.y = boundsMin.y + (compact.Position[1] / 65535.0f) * (boundsMax.y - boundsMin.y);
+	v.Position.z = boundsMin.z + (compact.Position[2] / 65535.0f) * (boundsMax.z - boundsMin.z);
+	v.Normal = DecodeOctahedral(compact.Normal);
+	v.UV.x = HalfToFloat(compact.UV[0]);
+	v.UV.y = HalfToFloat(compact.UV[1]);
+	return v;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstddef>
+#include "Vertex.h"
+
+// --------------------------------------------------------
+// Packing and unpacking for CompactVertex
+//
+// Everything here is plain CPU code (no DirectX device), and
+// each Decode function mirrors what the GPU does when it reads
+// the packed formats, so round trips can be checked on the CPU.
+//
+// Worst-case errors:
+//  - Position: about half of (bounds extent / 65535) per axis
+//  - Normal:   under 0.001 radians
+//  - UV:       half-float precision (relative error 2^-11)
+// --------------------------------------------------------
+
+// Axis-aligned bounds of the vertices' positions
+void ComputeBounds(const Vertex* vertices, size_t count, DirectX::XMFLOAT3& boundsMin, DirectX::XMFLOAT3& boundsMax);
+
+// IEEE half float conversion (round to nearest even)
+unsigned short FloatToHalf(float value);
+float HalfToFloat(unsigned short value);
+
+// Unit vector <-> octahedral mapping, stored as two snorm16's
+// (x in the low 16 bits, y in the high 16 bits)
+unsigned int EncodeOctahedral(DirectX::XMFLOAT3 normal);
+DirectX::XMFLOAT3 DecodeOctahedral(unsigned int packed);
+
+// --------------------------------------------------------
+// Packs full vertices into compact ones
+// - Positions are stored relative to the given bounds, so the
+//    shader needs positionOffset = boundsMin and
+//    positionScale = boundsMax - boundsMin to unpack them
+// --------------------------------------------------------
+void CompressVertices(const Vertex* vertices, size_t count, DirectX::XMFLOAT3 boundsMin, DirectX::XMFLOAT3 boundsMax, CompactVertex* compact);
+
+// Unpacks a single compact vertex (as the vertex shader would)
+Vertex DecompressVertex(const CompactVertex& compact, DirectX::XMFLOAT3 boundsMin, DirectX::XMFLOAT3 boundsMax);
@@ -1,88 +1,111 @@
-
-// Constant Buffer
-// - Allows us to define a buffer of individual variables 
-//    which will (eventually) hold data from our C++ code
-// - All non-pipeline variables that get their values from 
-//    our C++ code must be defined inside a Constant Buffer
-// - The name of the cbuffer itself is unimportant
-cbuffer externalData : register(b0)
-{
-	matrix world;
-	matrix view;
-	matrix projection;
-};
-
-// Struct representing a single vertex worth of data
-// - This should match the vertex definition in our C++ code
-// - By "match", I mean the size, order and number of members
-// - The name of the struct itself is unimportant, but should be descriptive
-// - Each variable must have a semantic, which defines its usage
-struct VertexShaderInput
-{ 
-	// Data type
-	//  |
-	//  |   Name          Semantic
-	//  |    |                |
-	//  v    v                v
-	float3 position		: POSITION;     // XYZ position
-	float3 normal       : NORMAL;
-	float2 uv           : TEXCOORD;
-};
-
-// Struct representing the data we're sending down the pipeline
-// - Should match our pixel shader's input (hence the name: Vertex to Pixel)
-// - At a minimum, we need a piece of data defined tagged as SV_POSITION
-// - The name of the struct itself is unimportant, but should be descriptive
-// - Each variable must have a semantic, which defines its usage
-struct VertexToPixel
-{
-	// Data type
-	//  |
-	//  |   Name          Semantic
-	//  |    |                |
-	//  v    v                v
-	float4 position		: SV_POSITION;	// XYZW position (System Value Position)
-	float3 normal       : NORMAL;
-	float2 uv           : TEXCOORD;
-};
-
-// --------------------------------------------------------
-// The entry point (main method) for our vertex shader
-// 
-// - Input is exactly one vertex worth of data (defined by a struct)
-// - Output is a single struct of data to pass down the pipeline
-// - Named "main" because that's the default the shader compiler looks for
-// --------------------------------------------------------
-VertexToPixel main( VertexShaderInput input )
-{
-	// Set up output struct
-	VertexToPixel output;
-
-	// The vertex's position (input.position) must be converted to world space,
-	// then camera space (relative to our 3D camera), then to proper homogenous 
-	// screen-space coordinates.  This is taken care of by our world, view and
-	// projection matrices.  
-	//
-	// First we multiply them together to get a single matrix which represents
-	// all of those transformations (world to view to projection space)
-	matrix worldViewProj = mul(mul(world, view), projection);
-
-	// Then we convert our 3-component position vector to a 4-component vector
-	// and multiply it by our final 4x4 matrix.
-	//
-	// The result is essentially the position (XY) of the vertex on our 2D 
-	// screen and the distance (Z) from the camera (the "depth" of the pixel)
-	output.position = mul(float4(input.position, 1.0f), worldViewProj);
-	float3x3 noTrans = (float3x3)world;
-	output.normal = mul(input.normal, noTrans);
-	output.uv = input.uv;
-
-	// Pass the color through 
-	// - The values will be interpolated per-pixel by the rasterizer
-	// - We don't need to alter it here, but we do need to send it to the pixel shader
-	//output.color = input.color;
-
-	// Whatever we return will make its way through the pipeline to the
-	// next programmable stage we're using (the pixel shader for now)
-	return output;
+
+// Constant Buffer
+// - Allows us to define a buffer of individual variables 
+//    which will (eventually) hold data from our C++ code
+// - All non-pipeline variables that get their values from 
+//    our C++ code must be defined inside a Constant Buffer
+// - The name of the cbuffer itself is unimportant
+cbuffer externalData : register(b0)
+{
+	matrix world;
+	matrix view;
+	matrix projection;
+
+	// Unpacking for compact vertices (see CompactVertex in Vertex.h)
+	// - Full vertices use a scale of 1, an offset of 0 and no octahedral normals
+	float3 positionScale;
+	int octahedralNormals;
+	float3 positionOffset;
+};
+
+// Struct representing a single vertex worth of data
+// - This should match the vertex definition in our C++ code
+// - By "match", I mean the size, order and number of members
+// - The name of the struct itself is unimportant, but should be descriptive
+// - Each variable must have a semantic, which defines its usage
+// - Compact vertices arrive here already converted to floats by the
+//    input assembler: position in [0,1] and the two octahedral normal
+//    values in normal.xy (z is 0)
+struct VertexShaderInput
+{ 
+	// Data type
+	//  |
+	//  |   Name          Semantic
+	//  |    |                |
+	//  v    v                v
+	float3 position		: POSITION;     // XYZ position
+	float3 normal       : NORMAL;
+	float2 uv           : TEXCOORD;
+};
+
+// Struct representing the data we're sending down the pipeline
+// - Should match our pixel shader's input (hence the name: Vertex to Pixel)
+// - At a minimum, we need a piece of data defined tagged as SV_POSITION
+// - The name of the struct itself is unimportant, but should be descriptive
+// - Each variable must have a semantic, which defines its usage
+struct VertexToPixel
+{
+	// Data type
+	//  |
+	//  |   Name          Semantic
+	//  |    |                |
+	//  v    v                v
+	float4 position		: SV_POSITION;	// XYZW position (System Value Position)
+	float3 normal       : NORMAL;
+	float2 uv           : TEXCOORD;
+};
+
+// --------------------------------------------------------
+// Unpacks an octahedral-encoded unit vector
+// - Same math as DecodeOctahedral() in VertexCompression.cpp
+// --------------------------------------------------------
+float3 DecodeOctahedral(float2 e)
+{
+	float3 n = float3(e.x, e.y, 1.0f - abs(e.x) - abs(e.y));
+	float t = saturate(-n.z);
+	n.xy += n.xy >= 0.0f ? -t : t;
+	return normalize(n);
+}
+
+// --------------------------------------------------------
+// The entry point (main method) for our vertex shader
+// 
+// - Input is exactly one vertex worth of data (defined by a struct)
+// - Output is a single struct of data to pass down the pipeline
+// - Named "main" because that's the default the shader compiler looks for
+// --------------------------------------------------------
+VertexToPixel main( VertexShaderInput input )
+{
+	// Set up output struct
+	VertexToPixel output;
+
+	// The vertex's position (input.position) must be converted to world space,
+	// then camera space (relative to our 3D camera), then to proper homogenous 
+	// screen-space coordinates.  This is taken care of by our world, view and
+	// projection matrices.  
+	//
+	// First we multiply them together to get a single matrix which represents
+	// all of those transformations (world to view to projection space)
+	matrix worldViewProj = mul(mul(world, view), projection);
+
+	// Then we convert our 3-component position vector to a 4-component vector
+	// and multiply it by our final 4x4 matrix.
+	//
+	// The result is essentially the position (XY) of the vertex on our 2D 
+	// screen and the distance (Z) from the camera (the "depth" of the pixel)
+	float3 position = input.position * positionScale + positionOffset;
+	output.position = mul(float4(position, 1.0f), worldViewProj);
+	float3 normal = octahedralNormals ? DecodeOctahedral(input.normal.xy) : input.normal;
+	float3x3 noTrans = (float3x3)world;
+	output.normal = mul(normal, noTrans);
+	output.uv = input.uv;
+
+	// Pass the color through 
+	// - The values will be interpolated per-pixel by the rasterizer
+	// - We don't need to alter it here, but we do need to send it to the pixel shader
+	//output.color = input.color;
+
+	// Whatever we return will make its way through the pipeline to the
+	// next programmable stage we're using (the pixel shader for now)
+	return output;
 }
\ No newline at end of file